@@ -0,0 +1,132 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <bit>
+
+#include "ArrivalMonitor.h"
+
+using namespace nl::rakis::interop;
+
+
+void ArrivalMonitor::enable(size_t capacity)
+{
+	std::scoped_lock<std::mutex> lock(allocateMutex_);
+
+	if (table_.load(std::memory_order_relaxed) == nullptr) {
+		const size_t size{ std::bit_ceil(std::max<size_t>(capacity, 1) * 2) };	// Keep probe chains short
+		entries_ = std::make_unique<Entry[]>(size);
+		mask_ = size - 1;
+		table_.store(entries_.get(), std::memory_order_release);
+	}
+	enabled_.store(true, std::memory_order_release);
+}
+
+/*
+ * Find the entry of a request by linear probing, optionally claiming an empty one for it.
+ */
+ArrivalMonitor::Entry* ArrivalMonitor::entry(uint64_t key, bool claim) const
+{
+	Entry* table{ table_.load(std::memory_order_acquire) };
+	if (table == nullptr) {
+		return nullptr;
+	}
+	size_t index{ size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_ };
+	for (size_t probes = 0; probes <= mask_; probes++, index = (index + 1) & mask_) {
+		Entry& e{ table[index] };
+		uint64_t current{ e.key.load(std::memory_order_acquire) };
+		if (current == key) {
+			return &e;
+		}
+		if (current == EMPTY) {
+			if (!claim) {
+				return nullptr;
+			}
+			if (e.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || (current == key)) {
+				return &e;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void ArrivalMonitor::expect(Kind kind, uint32_t requestId, int64_t period)
+{
+	if (Entry* e = entry(keyOf(kind, requestId), true); e != nullptr) {
+		e->expected.store(period, std::memory_order_relaxed);
+		e->learned.store(0, std::memory_order_relaxed);
+	}
+}
+
+void ArrivalMonitor::arrived(Kind kind, uint32_t requestId, int64_t time)
+{
+	if (!isEnabled()) {
+		return;
+	}
+	Entry* e{ entry(keyOf(kind, requestId), true) };
+	if (e == nullptr) {
+		overflow_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	e->count.fetch_add(1, std::memory_order_relaxed);
+	const int64_t previous{ e->last.exchange(time, std::memory_order_relaxed) };
+	if (previous == 0) {
+		return;
+	}
+	const int64_t gap{ std::max<int64_t>(time - previous, 0) };
+	e->histogram[std::min<size_t>(std::bit_width(uint64_t(gap)), BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+
+	const int64_t expected{ e->expected.load(std::memory_order_relaxed) };
+	const int64_t period{ (expected == LEARN_PERIOD) ? e->learned.load(std::memory_order_relaxed) : expected };
+	const int64_t periods{ (period > 0) ? (gap + period / 2) / period : 1 };
+	if (periods > 1) {
+		e->missed.fetch_add(uint64_t(periods - 1), std::memory_order_relaxed);
+	}
+	if (expected == LEARN_PERIOD) {
+		// A moving average over roughly the last eight gaps, which is what a frame takes at the moment. Gaps count
+		// for at most two periods, so a stall hardly moves it, while a lasting change of frame rate still does.
+		e->learned.store((period == 0) ? gap : (period + (std::min(gap, 2 * period) - period) / 8), std::memory_order_relaxed);
+	}
+}
+
+size_t ArrivalMonitor::snapshot(Snapshot* out, size_t capacity) const
+{
+	Entry* table{ table_.load(std::memory_order_acquire) };
+	if ((table == nullptr) || (out == nullptr)) {
+		return 0;
+	}
+	size_t count{ 0 };
+	for (size_t i = 0; (i <= mask_) && (count < capacity); i++) {
+		const Entry& e{ table[i] };
+		const uint64_t key{ e.key.load(std::memory_order_acquire) };
+		if (key == EMPTY) {
+			continue;
+		}
+		Snapshot& s{ out[count++] };
+		s.requestId = uint32_t(key);
+		s.kind = Kind(key >> 32);
+		s.count = e.count.load(std::memory_order_relaxed);
+		s.lastArrival = e.last.load(std::memory_order_relaxed);
+		const int64_t expected{ e.expected.load(std::memory_order_relaxed) };
+		s.period = (expected == LEARN_PERIOD) ? e.learned.load(std::memory_order_relaxed) : std::max<int64_t>(expected, 0);
+		s.missed = e.missed.load(std::memory_order_relaxed);
+		for (size_t b = 0; b < BUCKETS; b++) {
+			s.histogram[b] = e.histogram[b].load(std::memory_order_relaxed);
+		}
+	}
+	return count;
+}
@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Arrival statistics of the data requests of one connection: how many messages came in, when the last one did,
+	 * a histogram of the time between them, and how many periods passed without one. Entries live in a fixed table
+	 * allocated when monitoring is enabled, and are updated with relaxed atomics, so the dispatch path neither
+	 * allocates nor locks. Requests are never removed; when the table is full, new ones are only counted as overflow.
+	 */
+	class ArrivalMonitor {
+	public:
+		static constexpr size_t DEFAULT_CAPACITY{ 256 };
+		static constexpr size_t BUCKETS{ 24 };			// Bucket i counts gaps below 2^i microseconds, down to half that
+
+		static constexpr int64_t LEARN_PERIOD{ 0 };		// Frame based: the period is learned from the arrivals
+		static constexpr int64_t NO_PERIOD{ -1 };		// Only on change, or once: nothing is missed
+
+		enum class Kind : uint32_t {
+			SimObjectData,
+			ClientData,
+		};
+
+		struct Snapshot {
+			uint32_t requestId;
+			Kind kind;
+			uint64_t count;
+			int64_t lastArrival;
+			int64_t period;							// Expected or learned, 0 if not known (yet)
+			uint64_t missed;
+			std::array<uint64_t, BUCKETS> histogram;
+		};
+
+	private:
+		static constexpr uint64_t EMPTY{ ~0ull };
+
+		struct Entry {
+			std::atomic<uint64_t> key{ EMPTY };
+			std::atomic<int64_t> expected{ LEARN_PERIOD };
+			std::atomic<int64_t> learned{ 0 };
+			std::atomic<int64_t> last{ 0 };
+			std::atomic<uint64_t> count{ 0 };
+			std::atomic<uint64_t> missed{ 0 };
+			std::array<std::atomic<uint64_t>, BUCKETS> histogram{};
+		};
+
+		std::mutex allocateMutex_;
+		std::unique_ptr<Entry[]> entries_;		// Allocated once, by the first enable()
+		std::atomic<Entry*> table_{ nullptr };	// Published after mask_ is set
+		size_t mask_{ 0 };
+		std::atomic<bool> enabled_{ false };
+		std::atomic<uint64_t> overflow_{ 0 };
+
+		static inline uint64_t keyOf(Kind kind, uint32_t requestId) { return (uint64_t(kind) << 32) | requestId; }
+		Entry* entry(uint64_t key, bool claim) const;
+
+	public:
+		ArrivalMonitor() = default;
+		ArrivalMonitor(const ArrivalMonitor&) = delete;
+		ArrivalMonitor(ArrivalMonitor&&) = delete;
+		~ArrivalMonitor() = default;
+		ArrivalMonitor& operator=(const ArrivalMonitor&) = delete;
+		ArrivalMonitor& operator=(ArrivalMonitor&&) = delete;
+
+		/*
+		 * Start monitoring, allocating a table for at least "capacity" requests the first time. Statistics collected
+		 * before are kept, and so is the table size.
+		 */
+		void enable(size_t capacity);
+		inline void disable() { enabled_.store(false, std::memory_order_release); }
+		inline bool isEnabled() const { return enabled_.load(std::memory_order_acquire); }
+
+		/*
+		 * Set the period in which a request's messages are expected, in microseconds, LEARN_PERIOD or NO_PERIOD.
+		 */
+		void expect(Kind kind, uint32_t requestId, int64_t period);
+		void arrived(Kind kind, uint32_t requestId, int64_t time);
+
+		/*
+		 * Copy the statistics of up to "capacity" requests. Returns the number written.
+		 */
+		size_t snapshot(Snapshot* out, size_t capacity) const;
+		inline uint64_t overflow() const { return overflow_.load(std::memory_order_relaxed); }
+	};
+
+}
+}
+}
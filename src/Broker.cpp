@@ -0,0 +1,308 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include "Broker.h"
+
+using namespace nl::rakis::interop;
+
+
+static constexpr uint32_t BROKER_MAGIC{ 0x4B524243 };	// "CBRK"
+static constexpr uint32_t BROKER_VERSION{ 1 };
+static constexpr size_t CACHE_LINE{ 64 };
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Atomics in shared memory must be lock-free");
+
+static constexpr size_t alignUp(size_t size)
+{
+	return (size + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+}
+
+/*
+ * All offsets are relative to the header, as every process maps the region at its own address.
+ */
+struct BrokerRegion::Header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slotCount;
+	uint32_t slotSize;
+	uint64_t messagesOffset;
+	uint64_t requestsOffset;
+
+	alignas(CACHE_LINE) std::atomic<uint64_t> published;		// Messages published so far
+	alignas(CACHE_LINE) std::atomic<uint64_t> enqueued;			// Requests claimed by clients
+	alignas(CACHE_LINE) std::atomic<uint64_t> dequeued;			// Requests taken by the owner
+};
+
+/*
+ * A message slot holds message n while its sequence is 2n+2, and is being written while it is odd. A request slot is
+ * free for request n while its sequence is n, and holds it while the sequence is n+1.
+ */
+struct BrokerRegion::Slot {
+	std::atomic<uint64_t> sequence;
+	uint32_t size;
+	uint32_t reserved;
+
+	inline uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+static size_t slotStride(uint32_t slotSize)
+{
+	return alignUp(16 + size_t(slotSize));
+}
+
+BrokerRegion::BrokerRegion(std::unique_ptr<SharedMemory> memory)
+	: memory_(std::move(memory)), header_(static_cast<Header*>(memory_->data()))
+{
+}
+
+BrokerRegion::Slot* BrokerRegion::messageSlot(uint64_t index) const
+{
+	auto base{ reinterpret_cast<uint8_t*>(header_) + header_->messagesOffset };
+	return reinterpret_cast<Slot*>(base + (index % header_->slotCount) * slotStride(header_->slotSize));
+}
+
+BrokerRegion::Slot* BrokerRegion::requestSlot(uint64_t index) const
+{
+	auto base{ reinterpret_cast<uint8_t*>(header_) + header_->requestsOffset };
+	return reinterpret_cast<Slot*>(base + (index % REQUEST_SLOTS) * slotStride(REQUEST_SLOT_SIZE));
+}
+
+/*static*/ std::unique_ptr<BrokerRegion> BrokerRegion::create(const char* name, uint32_t slotCount, uint32_t slotSize)
+{
+	if ((slotCount == 0) || (slotSize == 0)) {
+		return nullptr;
+	}
+	const size_t messagesOffset{ alignUp(sizeof(Header)) };
+	const size_t requestsOffset{ messagesOffset + slotCount * slotStride(slotSize) };
+	auto memory{ SharedMemory::create(name, requestsOffset + REQUEST_SLOTS * slotStride(REQUEST_SLOT_SIZE)) };
+	if (memory == nullptr) {
+		return nullptr;
+	}
+	auto header{ new (memory->data()) Header{ 0, BROKER_VERSION, slotCount, slotSize, messagesOffset, requestsOffset } };
+	header->published.store(0);
+	header->enqueued.store(0);
+	header->dequeued.store(0);
+
+	std::unique_ptr<BrokerRegion> region{ new BrokerRegion(std::move(memory)) };
+	for (uint64_t i = 0; i < slotCount; i++) {
+		new (region->messageSlot(i)) Slot{ 0, 0, 0 };
+	}
+	for (uint64_t i = 0; i < REQUEST_SLOTS; i++) {
+		new (region->requestSlot(i)) Slot{ i, 0, 0 };
+	}
+	std::atomic_ref<uint32_t>(header->magic).store(BROKER_MAGIC, std::memory_order_release);
+	return region;
+}
+
+/*static*/ std::unique_ptr<BrokerRegion> BrokerRegion::open(const char* name)
+{
+	auto memory{ SharedMemory::open(name) };
+	if ((memory == nullptr) || (memory->size() < sizeof(Header))) {
+		return nullptr;
+	}
+	auto header{ static_cast<Header*>(memory->data()) };
+	if ((std::atomic_ref<uint32_t>(header->magic).load(std::memory_order_acquire) != BROKER_MAGIC) || (header->version != BROKER_VERSION)
+		|| (memory->size() < header->requestsOffset + REQUEST_SLOTS * slotStride(REQUEST_SLOT_SIZE))) {
+		return nullptr;
+	}
+	return std::unique_ptr<BrokerRegion>(new BrokerRegion(std::move(memory)));
+}
+
+uint32_t BrokerRegion::slotCount() const
+{
+	return header_->slotCount;
+}
+
+uint32_t BrokerRegion::slotSize() const
+{
+	return header_->slotSize;
+}
+
+bool BrokerRegion::publish(const void* message, size_t size)
+{
+	if (size > header_->slotSize) {
+		return false;
+	}
+	const uint64_t n{ header_->published.load(std::memory_order_relaxed) };
+	Slot* slot{ messageSlot(n) };
+
+	slot->sequence.store(2 * n + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot->size = uint32_t(size);
+	std::memcpy(slot->data(), message, size);
+	slot->sequence.store(2 * n + 2, std::memory_order_release);
+	header_->published.store(n + 1, std::memory_order_release);
+	return true;
+}
+
+uint64_t BrokerRegion::published() const
+{
+	return header_->published.load(std::memory_order_acquire);
+}
+
+BrokerRegion::Read BrokerRegion::read(uint64_t& cursor, std::vector<uint8_t>& message) const
+{
+	const uint64_t published{ header_->published.load(std::memory_order_acquire) };
+	if (cursor >= published) {
+		return Read::Empty;
+	}
+	Slot* slot{ messageSlot(cursor) };
+	const uint64_t before{ slot->sequence.load(std::memory_order_acquire) };
+	if (before == 2 * cursor + 2) {
+		const uint32_t size{ std::min(slot->size, header_->slotSize) };
+		message.resize(size);
+		std::memcpy(message.data(), slot->data(), size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot->sequence.load(std::memory_order_relaxed) == before) {
+			cursor++;
+			return Read::Message;
+		}
+	}
+	// Overwritten before or while we copied it: skip to the oldest slot the owner is not about to reuse.
+	const uint64_t latest{ header_->published.load(std::memory_order_acquire) };
+	cursor = std::max(cursor + 1, latest - std::min<uint64_t>(latest, header_->slotCount - 1));
+	return Read::Lapped;
+}
+
+bool BrokerRegion::enqueue(const void* request, size_t size)
+{
+	if (size > REQUEST_SLOT_SIZE) {
+		return false;
+	}
+	uint64_t pos{ header_->enqueued.load(std::memory_order_relaxed) };
+	Slot* slot;
+	while (true) {
+		slot = requestSlot(pos);
+		const int64_t diff{ int64_t(slot->sequence.load(std::memory_order_acquire) - pos) };
+		if (diff == 0) {
+			if (header_->enqueued.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (diff < 0) {
+			return false;		// Full
+		}
+		else {
+			pos = header_->enqueued.load(std::memory_order_relaxed);
+		}
+	}
+	slot->size = uint32_t(size);
+	std::memcpy(slot->data(), request, size);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool BrokerRegion::dequeue(std::vector<uint8_t>& request)
+{
+	const uint64_t pos{ header_->dequeued.load(std::memory_order_relaxed) };
+	Slot* slot{ requestSlot(pos) };
+	if (slot->sequence.load(std::memory_order_acquire) != pos + 1) {
+		return false;
+	}
+	request.assign(slot->data(), slot->data() + slot->size);
+	slot->sequence.store(pos + REQUEST_SLOTS, std::memory_order_release);
+	header_->dequeued.store(pos + 1, std::memory_order_relaxed);
+	return true;
+}
+
+
+Broker::Broker(std::unique_ptr<BrokerRegion> region, Sink sink)
+	: region_(std::move(region)), sink_(std::move(sink))
+{
+	thread_ = std::thread([this]() { run(); });
+}
+
+Broker::~Broker()
+{
+	running_ = false;
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+void Broker::publish(const void* message, size_t size)
+{
+	if (!region_->publish(message, size)) {
+		oversized_.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void Broker::run()
+{
+	std::vector<uint8_t> encoded;
+	Request request;
+	uint32_t idle{ 0 };
+
+	while (running_) {
+		if (!region_->dequeue(encoded)) {
+			// Yield while requests are likely to follow each other, then poll at a relaxed pace.
+			if (++idle < 1000) {
+				std::this_thread::yield();
+			}
+			else {
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+			continue;
+		}
+		idle = 0;
+		const uint8_t* pos{ encoded.data() };
+		if (Request::decode(pos, encoded.data() + encoded.size(), request)) {
+			requests_.fetch_add(1, std::memory_order_relaxed);
+			sink_(request);
+		}
+	}
+}
+
+
+BrokerClient::BrokerClient(std::unique_ptr<BrokerRegion> region)
+	: region_(std::move(region)), cursor_(region_->published())
+{
+}
+
+bool BrokerClient::next(const void*& message, uint32_t& size)
+{
+	while (true) {
+		const uint64_t before{ cursor_ };
+		switch (region_->read(cursor_, message_)) {
+		case BrokerRegion::Read::Message:
+			message = message_.data();
+			size = uint32_t(message_.size());
+			return true;
+		case BrokerRegion::Read::Lapped:
+			lost_ += cursor_ - before;
+			break;
+		default:
+			return false;
+		}
+	}
+}
+
+HRESULT BrokerClient::send(const Request& request)
+{
+	thread_local std::vector<uint8_t> encoded;
+
+	encoded.clear();
+	if (!request.encode(encoded) || (encoded.size() > BrokerRegion::REQUEST_SLOT_SIZE)) {
+		return E_INVALIDARG;
+	}
+	return region_->enqueue(encoded.data(), encoded.size()) ? S_OK : E_OUTOFMEMORY;
+}
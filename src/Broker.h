@@ -0,0 +1,168 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Requests.h"
+#include "SharedMemory.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * The shared memory of a broker: a ring of received messages that every client reads at its own pace, and a
+	 * queue of encoded requests from all clients to the owner. The ring never waits for slow readers; a reader
+	 * that falls a full ring behind skips ahead and counts the messages it lost.
+	 */
+	class BrokerRegion {
+	public:
+		static constexpr uint32_t DEFAULT_SLOT_COUNT{ 4096 };
+		static constexpr uint32_t DEFAULT_SLOT_SIZE{ 4096 };
+		static constexpr uint32_t REQUEST_SLOTS{ 256 };
+		static constexpr uint32_t REQUEST_SLOT_SIZE{ 8192 + 256 };	// Client data areas are at most 8KB
+
+		enum class Read {
+			Empty,
+			Message,
+			Lapped,		// The reader was overtaken; its cursor moved to the oldest message still available
+		};
+
+	private:
+		struct Header;
+		struct Slot;
+
+		std::unique_ptr<SharedMemory> memory_;
+		Header* header_{ nullptr };
+
+		Slot* messageSlot(uint64_t index) const;
+		Slot* requestSlot(uint64_t index) const;
+
+		explicit BrokerRegion(std::unique_ptr<SharedMemory> memory);
+
+	public:
+		BrokerRegion(const BrokerRegion&) = delete;
+		BrokerRegion(BrokerRegion&&) = delete;
+		~BrokerRegion() = default;
+		BrokerRegion& operator=(const BrokerRegion&) = delete;
+		BrokerRegion& operator=(BrokerRegion&&) = delete;
+
+		static std::unique_ptr<BrokerRegion> create(const char* name, uint32_t slotCount, uint32_t slotSize);
+		static std::unique_ptr<BrokerRegion> open(const char* name);
+
+		uint32_t slotCount() const;
+		uint32_t slotSize() const;
+
+		/*
+		 * Append a message to the ring. Only the owner publishes. Returns false if it is larger than a slot.
+		 */
+		bool publish(const void* message, size_t size);
+		uint64_t published() const;
+
+		/*
+		 * Copy the message at "cursor" and advance it.
+		 */
+		Read read(uint64_t& cursor, std::vector<uint8_t>& message) const;
+
+		/*
+		 * Add an encoded request to the queue, from any process. Returns false if it is full or the request too large.
+		 */
+		bool enqueue(const void* request, size_t size);
+
+		/*
+		 * Take the oldest encoded request. Only the owner dequeues.
+		 */
+		bool dequeue(std::vector<uint8_t>& request);
+	};
+
+	/*
+	 * The owner side: publishes every message dispatched on its connection, and performs the requests of the
+	 * clients on a thread of its own.
+	 */
+	class Broker {
+	public:
+		using Sink = std::function<void(const Request& request)>;
+
+	private:
+		std::unique_ptr<BrokerRegion> region_;
+		Sink sink_;
+		std::atomic<bool> running_{ true };
+		std::atomic<uint64_t> oversized_{ 0 };
+		std::atomic<uint64_t> requests_{ 0 };
+		std::thread thread_;
+
+		void run();
+
+	public:
+		Broker(std::unique_ptr<BrokerRegion> region, Sink sink);
+		Broker(const Broker&) = delete;
+		Broker(Broker&&) = delete;
+		~Broker();
+		Broker& operator=(const Broker&) = delete;
+		Broker& operator=(Broker&&) = delete;
+
+		void publish(const void* message, size_t size);
+
+		inline uint64_t published() const { return region_->published(); }
+		inline uint64_t oversized() const { return oversized_.load(std::memory_order_relaxed); }
+		inline uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+	};
+
+	/*
+	 * The client side: reads the messages published after it attached, and queues its requests for the owner.
+	 */
+	class BrokerClient {
+		std::unique_ptr<BrokerRegion> region_;
+		uint64_t cursor_;
+		uint64_t lost_{ 0 };
+		std::vector<uint8_t> message_;
+
+	public:
+		explicit BrokerClient(std::unique_ptr<BrokerRegion> region);
+		BrokerClient(const BrokerClient&) = delete;
+		BrokerClient(BrokerClient&&) = delete;
+		~BrokerClient() = default;
+		BrokerClient& operator=(const BrokerClient&) = delete;
+		BrokerClient& operator=(BrokerClient&&) = delete;
+
+		/*
+		 * The client's handle, used with the Cs* calls like a SimConnect handle.
+		 */
+		inline HANDLE handle() { return this; }
+
+		/*
+		 * The next message, valid until the next call. Returns false if there is none.
+		 */
+		bool next(const void*& message, uint32_t& size);
+
+		/*
+		 * Queue a request for the owner. Fails with E_OUTOFMEMORY while the queue is full, and with E_INVALIDARG if
+		 * the request does not fit in a queue slot.
+		 */
+		HRESULT send(const Request& request);
+
+		inline uint64_t lost() const { return lost_; }
+	};
+
+}
+}
+}
@@ -0,0 +1,151 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ClientDataChannel.h"
+
+using namespace nl::rakis::interop;
+
+
+ClientDataChannel::ClientDataChannel(uint32_t clientDataId, uint32_t size, uint32_t rangeSize, uint32_t firstDefId)
+	: clientDataId_(clientDataId), size_(size), rangeSize_(std::max(rangeSize, 1u)), firstDefId_(firstDefId),
+	  committed_(size, 0), working_(size, 0), received_(size, 0), fresh_(rangeCount(), false),
+	  unsent_(rangeCount(), false)
+{
+}
+
+/*
+ * Received data becomes the committed state, so a range the client changed is still sent if it differs from it.
+ */
+size_t ClientDataChannel::takeReceived()
+{
+	size_t updated{ 0 };
+	for (uint32_t range = 0; range < rangeCount(); range++) {
+		if (!fresh_[range]) {
+			continue;
+		}
+		const uint32_t offset{ rangeOffset(range) };
+		const uint32_t length{ rangeSize(range) };
+		if (!unsent_[range] && (std::memcmp(working_.data() + offset, committed_.data() + offset, length) == 0)) {
+			std::memcpy(working_.data() + offset, received_.data() + offset, length);
+			updated++;
+		}
+		std::memcpy(committed_.data() + offset, received_.data() + offset, length);
+		fresh_[range] = false;
+	}
+	return updated;
+}
+
+size_t ClientDataChannel::refresh()
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	return takeReceived();
+}
+
+size_t ClientDataChannel::commit(const Sender& send)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	takeReceived();
+
+	size_t sent{ 0 };
+	for (uint32_t range = 0; range < rangeCount(); range++) {
+		const uint32_t offset{ rangeOffset(range) };
+		const uint32_t length{ rangeSize(range) };
+		if (!unsent_[range] && (std::memcmp(working_.data() + offset, committed_.data() + offset, length) == 0)) {
+			continue;
+		}
+		if (send(defId(range), working_.data() + offset, length)) {
+			std::memcpy(committed_.data() + offset, working_.data() + offset, length);
+			unsent_[range] = false;
+			sent++;
+		}
+	}
+	return sent;
+}
+
+bool ClientDataChannel::failed(uint32_t id)
+{
+	if (!ownsDefId(id)) {
+		return false;
+	}
+	std::scoped_lock<std::mutex> lock(mutex_);
+	unsent_[id - firstDefId_] = true;
+	return true;
+}
+
+bool ClientDataChannel::accept(uint32_t id, const void* data, size_t size)
+{
+	if (!ownsDefId(id)) {
+		return false;
+	}
+	const uint32_t range{ id - firstDefId_ };
+	const uint32_t offset{ rangeOffset(range) };
+	const uint32_t length{ uint32_t(std::min<size_t>(rangeSize(range), size)) };
+
+	std::scoped_lock<std::mutex> lock(mutex_);
+	if (!fresh_[range]) {
+		// A short update only replaces the start of the range.
+		std::memcpy(received_.data() + offset, committed_.data() + offset, rangeSize(range));
+		fresh_[range] = true;
+	}
+	std::memcpy(received_.data() + offset, data, length);
+	return true;
+}
+
+
+bool ClientDataChannels::add(std::shared_ptr<ClientDataChannel> channel)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	return channels_.try_emplace(channel->clientDataId(), channel).second;
+}
+
+std::shared_ptr<ClientDataChannel> ClientDataChannels::remove(uint32_t clientDataId)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	auto it{ channels_.find(clientDataId) };
+	if (it == channels_.end()) {
+		return nullptr;
+	}
+	auto channel{ it->second };
+	channels_.erase(it);
+	return channel;
+}
+
+std::shared_ptr<ClientDataChannel> ClientDataChannels::find(uint32_t clientDataId) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	auto it{ channels_.find(clientDataId) };
+	return (it == channels_.end()) ? nullptr : it->second;
+}
+
+std::shared_ptr<ClientDataChannel> ClientDataChannels::findByDefId(uint32_t defId) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	for (const auto& [clientDataId, channel] : channels_) {
+		if (channel->ownsDefId(defId)) {
+			return channel;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,111 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * A native mirror of a client data area, split into fixed-size ranges that each have their own client data
+	 * definition. The client writes into the working buffer in place, and a commit sends only the ranges that
+	 * differ from what was last committed. Data received from the simulator is kept aside, and only copied into
+	 * the working buffer on the client's own thread, when it refreshes or commits.
+	 */
+	class ClientDataChannel {
+	public:
+		using Sender = std::function<bool(uint32_t defId, const uint8_t* data, uint32_t size)>;
+
+	private:
+		uint32_t clientDataId_;
+		uint32_t size_;
+		uint32_t rangeSize_;
+		uint32_t firstDefId_;
+
+		mutable std::mutex mutex_;
+		std::vector<uint8_t> committed_;	// As last sent or received
+		std::vector<uint8_t> working_;		// Written by the client
+		std::vector<uint8_t> received_;		// Received, but not yet taken into the working buffer
+		std::vector<bool> fresh_;			// Per range, whether received_ has data for it
+		std::vector<bool> unsent_;			// Per range, whether a queued send of it failed
+
+		size_t takeReceived();
+
+	public:
+		ClientDataChannel(uint32_t clientDataId, uint32_t size, uint32_t rangeSize, uint32_t firstDefId);
+		ClientDataChannel(const ClientDataChannel&) = delete;
+		ClientDataChannel(ClientDataChannel&&) = delete;
+		~ClientDataChannel() = default;
+		ClientDataChannel& operator=(const ClientDataChannel&) = delete;
+		ClientDataChannel& operator=(ClientDataChannel&&) = delete;
+
+		inline uint32_t clientDataId() const { return clientDataId_; }
+		inline uint32_t size() const { return size_; }
+		inline uint32_t rangeCount() const { return (size_ + rangeSize_ - 1) / rangeSize_; }
+		inline uint32_t rangeOffset(uint32_t range) const { return range * rangeSize_; }
+		inline uint32_t rangeSize(uint32_t range) const { return std::min(rangeSize_, size_ - rangeOffset(range)); }
+		inline uint32_t defId(uint32_t range) const { return firstDefId_ + range; }
+		inline bool ownsDefId(uint32_t defId) const { return (defId >= firstDefId_) && (defId - firstDefId_ < rangeCount()); }
+
+		inline uint8_t* buffer() { return working_.data(); }
+
+		/*
+		 * Pass every changed range to the sender. Ranges that were sent successfully, or queued, become the committed
+		 * state. Returns the number of ranges sent.
+		 */
+		size_t commit(const Sender& send);
+
+		/*
+		 * A queued send of a range failed, so the next commit must send it again.
+		 */
+		bool failed(uint32_t defId);
+
+		/*
+		 * Copy received data into the working buffer. Ranges with uncommitted changes keep the client's version.
+		 * Returns the number of ranges updated. Must be called on the thread writing the buffer, as is commit().
+		 */
+		size_t refresh();
+
+		/*
+		 * Keep data received for one of our ranges until the next refresh or commit. This never touches the
+		 * working buffer, so it is safe while the client writes to it.
+		 */
+		bool accept(uint32_t defId, const void* data, size_t size);
+	};
+
+	class ClientDataChannels {
+		mutable std::mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<ClientDataChannel>> channels_;
+
+	public:
+		bool add(std::shared_ptr<ClientDataChannel> channel);
+		std::shared_ptr<ClientDataChannel> remove(uint32_t clientDataId);
+
+		std::shared_ptr<ClientDataChannel> find(uint32_t clientDataId) const;
+		std::shared_ptr<ClientDataChannel> findByDefId(uint32_t defId) const;
+	};
+
+}
+}
+}
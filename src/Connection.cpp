@@ -0,0 +1,253 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+
+#include "Connection.h"
+
+using namespace nl::rakis::interop;
+
+
+static std::array<std::shared_ptr<Connection>, Connection::MAX_CONNECTIONS> connections;
+static std::shared_mutex connectionsMutex;
+
+/*static*/ std::shared_ptr<Connection> Connection::find(HANDLE handle)
+{
+	if (handle == nullptr) {
+		return nullptr;
+	}
+	std::shared_lock<std::shared_mutex> lock(connectionsMutex);
+
+	for (const auto& conn : connections) {
+		if ((conn != nullptr) && (conn->handle() == handle)) {
+			return conn;
+		}
+	}
+	return nullptr;
+}
+
+/*static*/ std::shared_ptr<Connection> Connection::attach(HANDLE handle, const char* appName, std::unique_ptr<DispatchEvent> event)
+{
+	std::unique_lock<std::shared_mutex> lock(connectionsMutex);
+
+	for (const auto& conn : connections) {
+		if ((conn != nullptr) && (conn->handle() == handle)) {
+			return conn;
+		}
+	}
+	for (auto& slot : connections) {
+		if (slot == nullptr) {
+			slot = std::make_shared<Connection>(handle, appName, std::move(event));
+			return slot;
+		}
+	}
+	return nullptr;
+}
+
+/*static*/ void Connection::detach(const Connection* conn)
+{
+	std::shared_ptr<Connection> released;	// Destroyed after the lock is released
+	std::unique_lock<std::shared_mutex> lock(connectionsMutex);
+
+	for (auto& slot : connections) {
+		if ((slot != nullptr) && (slot.get() == conn)) {
+			released = std::move(slot);
+			return;
+		}
+	}
+}
+
+/*
+ * The receive thread goes first, as it may flush the coalescer, and the broker thread sends through the scheduler.
+ */
+void Connection::quiesce()
+{
+	dispatcher_.stop();
+	coalescer_.stop();
+	setBroker(nullptr);
+	scheduler_.stop();
+}
+
+
+void Connection::applied(const Request& request)
+{
+	const auto& args{ request.args };
+
+	switch (request.op) {
+	case RequestOp::AddToDataDefinition:
+		schemas_.add(args[0], request.strings[0].c_str(), request.strings[1].c_str(), args[1], Request::toFloat(args[2]), args[3]);
+		break;
+	case RequestOp::ClearDataDefinition:
+		schemas_.clear(args[0]);
+		break;
+	case RequestOp::MapClientEventToSimEvent:
+		eventNames_.addEvent(request.strings[0].c_str(), args[0]);
+		break;
+	case RequestOp::MapInputEventToClientEvent:
+		eventNames_.addInput(args[0], request.strings[0].c_str(), InputMapping{ args[1], args[3] });
+		break;
+	case RequestOp::RequestDataOnSimObject:
+	case RequestOp::RequestClientData:
+		expectArrivals(request);
+		break;
+	default:
+		break;
+	}
+	journal(request);
+}
+
+/*
+ * Periods are counted in seconds or frames. Requests sent only on change, or only once, have no period to miss.
+ */
+static int64_t arrivalPeriod(bool seconds, bool frames, bool onChange, uint32_t interval)
+{
+	if (onChange || (!seconds && !frames)) {
+		return ArrivalMonitor::NO_PERIOD;
+	}
+	return seconds ? (int64_t(interval) + 1) * 1000000 : ArrivalMonitor::LEARN_PERIOD;
+}
+
+void Connection::expectArrivals(const Request& request)
+{
+	const auto& args{ request.args };
+
+	if (request.op == RequestOp::RequestDataOnSimObject) {
+		const bool frames{ (args[3] == SIMCONNECT_PERIOD_VISUAL_FRAME) || (args[3] == SIMCONNECT_PERIOD_SIM_FRAME) };
+		const bool onChange{ (args[4] & SIMCONNECT_DATA_REQUEST_FLAG_CHANGED) != 0 };
+		arrivals_.expect(ArrivalMonitor::Kind::SimObjectData, args[0], arrivalPeriod(args[3] == SIMCONNECT_PERIOD_SECOND, frames, onChange, args[6]));
+	}
+	else if (request.op == RequestOp::RequestClientData) {
+		const bool onChange{ (args[4] & SIMCONNECT_CLIENT_DATA_REQUEST_FLAG_CHANGED) != 0 };
+		arrivals_.expect(ArrivalMonitor::Kind::ClientData, args[1],
+			arrivalPeriod(args[3] == SIMCONNECT_CLIENT_DATA_PERIOD_SECOND, args[3] == SIMCONNECT_CLIENT_DATA_PERIOD_VISUAL_FRAME, onChange, args[6]));
+	}
+}
+
+void Connection::monitorArrivals(size_t capacity)
+{
+	arrivals_.enable(capacity);
+	for (const auto& request : journal()) {
+		expectArrivals(request);
+	}
+}
+
+/*
+ * Keep only those requests that are needed to recreate the current registrations.
+ */
+void Connection::journal(const Request& request)
+{
+	if (request.op > RequestOp::RequestClientData) {
+		return;		// Only the registrations and data requests change what needs to be replayed
+	}
+	std::scoped_lock<std::mutex> lock(journalMutex_);
+
+	const auto& args{ request.args };
+	auto forget = [this](RequestOp op, auto&& matches) {
+		std::erase_if(journal_, [op, &matches](const Request& r) { return (r.op == op) && matches(r.args); });
+	};
+	// A new mapping for an id takes the place of the old one, so it is still replayed before the calls using it.
+	auto replace = [this, &request](auto&& matches) {
+		auto it{ std::ranges::find_if(journal_, [&request, &matches](const Request& r) { return (r.op == request.op) && matches(r.args); }) };
+		if (it == journal_.end()) {
+			journal_.push_back(request);
+		}
+		else {
+			*it = request;
+		}
+	};
+
+	switch (request.op) {
+	case RequestOp::AddToDataDefinition:
+	case RequestOp::AddToClientDataDefinition:
+	case RequestOp::CreateClientData:
+	case RequestOp::MapInputEventToClientEvent:
+	case RequestOp::AddClientEventToNotificationGroup:
+		journal_.push_back(request);
+		break;
+
+	case RequestOp::MapClientDataNameToID:
+	case RequestOp::MapClientEventToSimEvent:
+	case RequestOp::SubscribeToSystemEvent:
+	case RequestOp::SetNotificationGroupPriority:
+		replace([&args](const auto& a) { return a[0] == args[0]; });
+		break;
+
+	case RequestOp::ClearDataDefinition:
+		forget(RequestOp::AddToDataDefinition, [&args](const auto& a) { return a[0] == args[0]; });
+		break;
+
+	case RequestOp::ClearClientDataDefinition:
+		forget(RequestOp::AddToClientDataDefinition, [&args](const auto& a) { return a[0] == args[0]; });
+		break;
+
+	case RequestOp::RemoveClientEvent:
+		forget(RequestOp::AddClientEventToNotificationGroup, [&args](const auto& a) { return (a[0] == args[0]) && (a[1] == args[1]); });
+		break;
+
+	case RequestOp::ClearNotificationGroup:
+		forget(RequestOp::AddClientEventToNotificationGroup, [&args](const auto& a) { return a[0] == args[0]; });
+		forget(RequestOp::SetNotificationGroupPriority, [&args](const auto& a) { return a[0] == args[0]; });
+		break;
+
+	case RequestOp::RequestDataOnSimObject:
+		// A new request with the same requestId replaces the old one. Only periodic ones need to be replayed.
+		forget(request.op, [&args](const auto& a) { return a[0] == args[0]; });
+		if (args[3] > SIMCONNECT_PERIOD_ONCE) {
+			journal_.push_back(request);
+		}
+		break;
+
+	case RequestOp::RequestClientData:
+		forget(request.op, [&args](const auto& a) { return a[1] == args[1]; });
+		if (args[3] > SIMCONNECT_CLIENT_DATA_PERIOD_ONCE) {
+			journal_.push_back(request);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+std::vector<Request> Connection::journal() const
+{
+	std::scoped_lock<std::mutex> lock(journalMutex_);
+
+	return journal_;
+}
+
+bool Connection::requesting(uint32_t requestId) const
+{
+	std::scoped_lock<std::mutex> lock(journalMutex_);
+
+	return std::ranges::any_of(journal_, [requestId](const Request& r) { return (r.op == RequestOp::RequestDataOnSimObject) && (r.args[0] == requestId); });
+}
+
+bool Connection::findRequest(uint32_t requestId, Request& request) const
+{
+	std::scoped_lock<std::mutex> lock(journalMutex_);
+
+	auto it{ std::ranges::find_if(journal_, [requestId](const Request& r) { return (r.op == RequestOp::RequestDataOnSimObject) && (r.args[0] == requestId); }) };
+	if (it == journal_.end()) {
+		return false;
+	}
+	request = *it;
+	return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "framework.h"
+
+#include "ArrivalMonitor.h"
+#include "Broker.h"
+#include "ClientDataChannel.h"
+#include "DataSchema.h"
+#include "DispatchEvent.h"
+#include "DispatchLoop.h"
+#include "EventCoalescer.h"
+#include "EventNames.h"
+#include "FrameAggregator.h"
+#include "History.h"
+#include "MessageArena.h"
+#include "ObjectTracker.h"
+#include "RateController.h"
+#include "Requests.h"
+#include "RequestScheduler.h"
+#include "SharedRequests.h"
+#include "TelemetryRecorder.h"
+#include "Tickets.h"
+#include "WriteFilter.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Native state kept for a handle returned by CsConnect. Handles that were not registered through CsConnect
+	 * simply have no state, and all features depending on it stay disabled for them.
+	 */
+	class Connection {
+	public:
+		static constexpr size_t MAX_CONNECTIONS{ 64 };
+
+		/*
+		 * Lookup only takes a shared lock, so it can be used on every call. The returned reference keeps the
+		 * Connection alive while it is used, even if another thread detaches it in the meantime.
+		 */
+		static std::shared_ptr<Connection> find(HANDLE handle);
+		static std::shared_ptr<Connection> attach(HANDLE handle, const char* appName, std::unique_ptr<DispatchEvent> event = nullptr);
+
+		/*
+		 * Remove the Connection from the registry. It is destroyed when the last reference to it is released.
+		 */
+		static void detach(const Connection* conn);
+
+	private:
+		std::atomic<HANDLE> handle_;
+		std::string appName_;
+		std::unique_ptr<DispatchEvent> event_;	// Only if SimConnect was opened with an event
+		std::unique_ptr<BrokerClient> client_;	// Only if this is a client of another process's broker
+		DataSchemas schemas_;
+		ClientDataChannels channels_;
+		EventNames eventNames_;
+		TicketTable tickets_;
+		Histories histories_;
+		ObjectTrackers trackers_;
+		RateControllers rates_;
+		ArrivalMonitor arrivals_;
+		FrameAggregator frames_;
+		WriteFilter writes_;
+		MessageBatch batch_;
+		SharedRequests sharing_;
+
+		mutable std::mutex journalMutex_;
+		std::vector<Request> journal_;
+
+		void journal(const Request& request);
+		void expectArrivals(const Request& request);
+
+		RequestScheduler scheduler_;
+
+		// The broker thread sends through the scheduler, so it has to stop first.
+		std::atomic<std::shared_ptr<Broker>> broker_;
+		std::atomic<std::shared_ptr<TelemetryRecorder>> recorder_;
+
+		// Declared last, so their threads are stopped before anything else goes away. The receive thread goes first,
+		// as it may flush the coalescer.
+		EventCoalescer coalescer_;
+		DispatchLoop dispatcher_;
+
+	public:
+		Connection(HANDLE handle, const char* appName, std::unique_ptr<DispatchEvent> event) : handle_(handle), appName_((appName != nullptr) ? appName : ""), event_(std::move(event)) {}
+		Connection(const Connection&) = delete;
+		Connection(Connection&&) = delete;
+		~Connection() = default;
+		Connection& operator=(const Connection&) = delete;
+		Connection& operator=(Connection&&) = delete;
+
+		inline HANDLE handle() const { return handle_.load(std::memory_order_acquire); }
+		inline const std::string& appName() const { return appName_; }
+		inline DispatchEvent* event() const { return event_.get(); }
+		inline BrokerClient* brokerClient() const { return client_.get(); }
+		inline void setBrokerClient(std::unique_ptr<BrokerClient> client) { client_ = std::move(client); }
+
+		/*
+		 * Switch to a new SimConnect handle after a reconnect.
+		 */
+		inline void rebind(HANDLE handle) { handle_.store(handle, std::memory_order_release); }
+
+		inline DataSchemas& schemas() { return schemas_; }
+		inline ClientDataChannels& channels() { return channels_; }
+		inline EventNames& eventNames() { return eventNames_; }
+		inline TicketTable& tickets() { return tickets_; }
+		inline Histories& histories() { return histories_; }
+		inline ObjectTrackers& trackers() { return trackers_; }
+		inline RateControllers& rates() { return rates_; }
+		inline ArrivalMonitor& arrivals() { return arrivals_; }
+		inline FrameAggregator& frames() { return frames_; }
+		inline WriteFilter& writes() { return writes_; }
+		inline MessageBatch& batch() { return batch_; }
+		inline SharedRequests& sharing() { return sharing_; }
+		inline RequestScheduler& scheduler() { return scheduler_; }
+		inline EventCoalescer& coalescer() { return coalescer_; }
+		inline DispatchLoop& dispatcher() { return dispatcher_; }
+		inline std::shared_ptr<Broker> broker() const { return broker_.load(std::memory_order_acquire); }
+		inline void setBroker(std::shared_ptr<Broker> broker) { broker_.store(std::move(broker), std::memory_order_release); }
+		inline std::shared_ptr<TelemetryRecorder> recorder() const { return recorder_.load(std::memory_order_acquire); }
+		inline void setRecorder(std::shared_ptr<TelemetryRecorder> recorder) { recorder_.store(std::move(recorder), std::memory_order_release); }
+
+		/*
+		 * Stop the threads working for this connection, so it can be closed. This is done before detaching, as the
+		 * last reference may be released on one of those threads.
+		 */
+		void quiesce();
+
+		/*
+		 * Update the native state after a request was successfully sent.
+		 */
+		void applied(const Request& request);
+
+		/*
+		 * Enable the arrival monitor, with the expected periods of the data requests currently in effect.
+		 */
+		void monitorArrivals(size_t capacity);
+
+		/*
+		 * The registrations currently in effect, in the order they were made, for replay after a reconnect.
+		 */
+		std::vector<Request> journal() const;
+
+		/*
+		 * Whether a periodic data request with this requestId is in effect.
+		 */
+		bool requesting(uint32_t requestId) const;
+
+		/*
+		 * Copy the periodic data request with this requestId that is in effect, if any.
+		 */
+		bool findRequest(uint32_t requestId, Request& request) const;
+	};
+
+}
+}
+}
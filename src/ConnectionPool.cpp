@@ -0,0 +1,117 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "ConnectionPool.h"
+
+using namespace nl::rakis::interop;
+
+
+static std::mutex poolsMutex;
+static std::vector<std::shared_ptr<ConnectionPool>> pools;
+
+/*static*/ std::shared_ptr<ConnectionPool> ConnectionPool::add(std::shared_ptr<ConnectionPool> pool)
+{
+	std::scoped_lock<std::mutex> lock(poolsMutex);
+
+	return pools.emplace_back(std::move(pool));
+}
+
+/*static*/ std::shared_ptr<ConnectionPool> ConnectionPool::find(HANDLE handle)
+{
+	std::scoped_lock<std::mutex> lock(poolsMutex);
+
+	auto it{ std::find_if(pools.begin(), pools.end(), [handle](const auto& pool) { return pool.get() == handle; }) };
+	return (it == pools.end()) ? nullptr : *it;
+}
+
+/*static*/ std::shared_ptr<ConnectionPool> ConnectionPool::remove(HANDLE handle)
+{
+	std::scoped_lock<std::mutex> lock(poolsMutex);
+
+	auto it{ std::find_if(pools.begin(), pools.end(), [handle](const auto& pool) { return pool.get() == handle; }) };
+	if (it == pools.end()) {
+		return nullptr;
+	}
+	auto pool{ std::move(*it) };
+	pools.erase(it);
+	return pool;
+}
+
+ConnectionPool::ConnectionPool(std::vector<std::shared_ptr<Connection>> shards)
+	: shards_(std::move(shards))
+{
+	classes_.fill(UNASSIGNED);
+	for (uint32_t i = 0; i < shards_.size(); i++) {
+		hashed_.push_back(i);
+	}
+}
+
+void ConnectionPool::reserve(uint32_t shard)
+{
+	if (hashed_.size() > 1) {
+		std::erase(hashed_, shard);		// Keep at least one shard for everything else
+	}
+}
+
+bool ConnectionPool::assign(uint32_t first, uint32_t last, uint32_t shard)
+{
+	if ((first > last) || (shard >= shards_.size())) {
+		return false;
+	}
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	auto next{ ranges_.lower_bound(first) };
+	if ((next != ranges_.end()) && (next->first <= last)) {
+		return false;
+	}
+	if ((next != ranges_.begin()) && (std::prev(next)->second.last >= first)) {
+		return false;
+	}
+	ranges_.emplace(first, Range{ last, shard });
+	reserve(shard);
+	return true;
+}
+
+bool ConnectionPool::assign(PoolClass requestClass, uint32_t shard)
+{
+	if ((requestClass >= PoolClass::Count) || (shard >= shards_.size())) {
+		return false;
+	}
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	classes_[size_t(requestClass)] = shard;
+	reserve(shard);
+	return true;
+}
+
+uint32_t ConnectionPool::shardOf(uint32_t requestId, PoolClass requestClass) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	if (auto it = ranges_.upper_bound(requestId); it != ranges_.begin()) {
+		if (const auto& [first, range] = *std::prev(it); requestId <= range.last) {
+			return range.shard;
+		}
+	}
+	if ((requestClass < PoolClass::Count) && (classes_[size_t(requestClass)] != UNASSIGNED)) {
+		return classes_[size_t(requestClass)];
+	}
+	const uint32_t hash{ (requestId * 2654435761u) >> 16 };		// Consecutive ids still spread evenly
+	return hashed_[hash % hashed_.size()];
+}
@@ -0,0 +1,109 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "Connection.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * The kinds of request a shard can be reserved for.
+	 */
+	enum class PoolClass : uint32_t {
+		Object = 0,			// RequestDataOnSimObject
+		ObjectType = 1,		// RequestDataOnSimObjectType, such as AI sweeps
+
+		Count
+	};
+
+	/*
+	 * A set of connections (shards) used as one, so different requests use different pipes and receive threads.
+	 * Ranges of requestIds and classes of request can be assigned to a shard, ranges taking precedence; all other
+	 * requests are spread by hash over the shards that have nothing assigned, so assigned shards only carry their
+	 * own traffic.
+	 */
+	class ConnectionPool {
+	public:
+		/*
+		 * The pool handle is the pool's address, registered here so it can be checked. A pool found here stays
+		 * alive while the reference is held, even if it is removed in the meantime.
+		 */
+		static std::shared_ptr<ConnectionPool> add(std::shared_ptr<ConnectionPool> pool);
+		static std::shared_ptr<ConnectionPool> find(HANDLE pool);
+		static std::shared_ptr<ConnectionPool> remove(HANDLE pool);
+
+		static constexpr uint32_t UNASSIGNED{ UINT32_MAX };
+
+	private:
+		struct Range {
+			uint32_t last;
+			uint32_t shard;
+		};
+
+		std::vector<std::shared_ptr<Connection>> shards_;
+		std::mutex registrationMutex_;
+
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, Range> ranges_;		// By first requestId
+		std::array<uint32_t, size_t(PoolClass::Count)> classes_;
+		std::vector<uint32_t> hashed_;			// Shards without assigned ranges or classes
+
+		void reserve(uint32_t shard);
+
+	public:
+		explicit ConnectionPool(std::vector<std::shared_ptr<Connection>> shards);
+		ConnectionPool(const ConnectionPool&) = delete;
+		ConnectionPool(ConnectionPool&&) = delete;
+		~ConnectionPool() = default;
+		ConnectionPool& operator=(const ConnectionPool&) = delete;
+		ConnectionPool& operator=(ConnectionPool&&) = delete;
+
+		inline HANDLE handle() { return this; }
+		inline size_t size() const { return shards_.size(); }
+		inline Connection* shard(size_t index) const { return shards_[index].get(); }
+		inline const std::vector<std::shared_ptr<Connection>>& shards() const { return shards_; }
+
+		/*
+		 * Held while copying registrations from the first shard to another one.
+		 */
+		inline std::mutex& registrationMutex() { return registrationMutex_; }
+
+		/*
+		 * Send requestIds first through last (inclusive) to a shard. Fails for ranges overlapping an earlier one.
+		 */
+		bool assign(uint32_t first, uint32_t last, uint32_t shard);
+
+		/*
+		 * Send all requests of a class to a shard, unless their requestId is in an assigned range.
+		 */
+		bool assign(PoolClass requestClass, uint32_t shard);
+
+		uint32_t shardOf(uint32_t requestId, PoolClass requestClass) const;
+	};
+
+}
+}
+}
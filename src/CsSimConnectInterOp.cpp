@@ -17,6 +17,39 @@
 #include <mutex>
 #include <format>
 
+#include "Broker.h"
+#include "Connection.h"
+#include "ConnectionPool.h"
+#include "NarrowString.h"
+
+using nl::rakis::interop::Broker;
+using nl::rakis::interop::BrokerClient;
+using nl::rakis::interop::BrokerRegion;
+using nl::rakis::interop::ArrivalMonitor;
+using nl::rakis::interop::ClientDataChannel;
+using nl::rakis::interop::Connection;
+using nl::rakis::interop::ConnectionPool;
+using nl::rakis::interop::PoolClass;
+using nl::rakis::interop::DataSchema;
+using nl::rakis::interop::DispatchEvent;
+using nl::rakis::interop::FrameAggregator;
+using nl::rakis::interop::HistoryRing;
+using nl::rakis::interop::NarrowString;
+using nl::rakis::interop::ObjectTracker;
+using nl::rakis::interop::RateController;
+using nl::rakis::interop::RateLimits;
+using nl::rakis::interop::Request;
+using nl::rakis::interop::RequestOp;
+using nl::rakis::interop::RequestParams;
+using nl::rakis::interop::RequestPriority;
+using nl::rakis::interop::SharedRequests;
+using nl::rakis::interop::Subscriber;
+using nl::rakis::interop::TelemetryReader;
+using nl::rakis::interop::TelemetryRecorder;
+using nl::rakis::interop::TicketState;
+using nl::rakis::interop::TicketTable;
+using nl::rakis::interop::WriteTarget;
+
 static nl::rakis::logging::Logger logger{ nl::rakis::logging::Logger::getLogger("CsSimConnectInterOp") };
 
 static bool logInitialized{ false };
@@ -31,23 +64,59 @@ void initLog() {
 	}
 }
 
+/*
+ * Logging: the in-memory ring of recent log records, dumped to the log when an error is logged, and the limit on
+ * messages written per call site.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetLogRingEnabled(uint32_t enabled)
+{
+	nl::rakis::logging::LogRing::setEnabled(enabled != 0);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsDumpLogRing()
+{
+	initLog();
+
+	return int64_t(logger.dumpRing());
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetLogRateLimit(double messagesPerSecond, uint32_t burst)
+{
+	nl::rakis::logging::LogLimiter::setLimit(messagesPerSecond, burst);
+	return true;
+}
+
 static std::mutex scMutex;
 
+static long submitRequest(HANDLE handle, const Request& request);
+static void sendRateChanges(Connection* conn);
+
 /*
  * Lifecycle functions
  */
 
-CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnect(const char* appName, HANDLE& handle) {
+static bool connect(const char* appName, HANDLE& handle, bool withEvent) {
 	initLog();
 	logger.info(std::format("Trying to connect through SimConnect using client name '{}'", appName));
 	HANDLE h;
 
+	auto event{ withEvent ? std::make_unique<DispatchEvent>() : nullptr };
 //	std::unique_lock<std::mutex> scLock(scMutex);
-	HRESULT hr = SimConnect_Open(&h, appName, nullptr, 0, nullptr, 0);
+	HRESULT hr = SimConnect_Open(&h, appName, nullptr, 0, (event != nullptr) ? event->handle() : nullptr, 0);
 
 	if (SUCCEEDED(hr)) {
 		logger.info("Connected to SimConnect.");
 		handle = h;
+		if (Connection::attach(h, appName, std::move(event)) == nullptr) {
+			logger.warn(std::format("Too many open connections, native state disabled for this one."));
+			if (withEvent) {
+				// Without a Connection there is nothing to keep the event alive for SimConnect.
+				SimConnect_Close(h);
+				return false;
+			}
+		}
 	}
 	else if (hr != E_FAIL) {
 		logger.error("Failed to connect to SimConnect");
@@ -58,388 +127,2526 @@ CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnect(const char* appName, HANDLE& handle) {
 	return SUCCEEDED(hr);
 }
 
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnect(const char* appName, HANDLE& handle) {
+	return connect(appName, handle, false);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectWithEvent(const char* appName, HANDLE& handle) {
+	return connect(appName, handle, true);
+}
+
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisconnect(HANDLE handle) {
 	initLog();
 
+	auto conn{ Connection::find(handle) };
+	if (conn != nullptr) {
+		conn->quiesce();	// Not under scMutex, as this stops threads that may need it.
+		if (conn->brokerClient() != nullptr) {
+			Connection::detach(conn.get());
+			return true;	// There is no SimConnect connection of our own to close
+		}
+	}
+
 	std::unique_lock<std::mutex> scLock(scMutex);
 	HRESULT hr = SimConnect_Close(handle);
+	scLock.unlock();
 
-	if (hr != E_FAIL) {
+	if (FAILED(hr)) {
 		logger.error("Call to SimConnect_Close() failed.");
+		return false;
 	}
-	return SUCCEEDED(hr);
+	if (conn != nullptr) {
+		Connection::detach(conn.get());
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReconnect(HANDLE& handle) {
+	initLog();
+
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsReconnect is not a connection opened through CsConnect!");
+		return false;
+	}
+	if (conn->brokerClient() != nullptr) {
+		logger.error("CsReconnect: a broker client cannot reconnect, as the owner of the broker holds the connection.");
+		return false;
+	}
+	logger.info(std::format("Reconnecting through SimConnect using client name '{}'", conn->appName()));
+
+	std::unique_lock<std::mutex> scLock(scMutex);
+	SimConnect_Close(handle);	// The old connection is most likely gone already, so we don't care about the result.
+
+	HANDLE h;
+	HRESULT hr = SimConnect_Open(&h, conn->appName().c_str(), nullptr, 0, (conn->event() != nullptr) ? conn->event()->handle() : nullptr, 0);
+	if (FAILED(hr)) {
+		scLock.unlock();
+		logger.error(std::format("Failed to reconnect to SimConnect (hr={}), the connection is closed.", hr));
+
+		// The old handle is closed, so nothing may use it anymore.
+		conn->quiesce();
+		Connection::detach(conn.get());
+		handle = nullptr;
+		return false;
+	}
+	conn->rebind(h);
+	conn->writes().clear();		// The new session has not seen any of our writes
+	handle = h;
+
+	auto journal{ conn->journal() };
+	size_t failed{ 0 };
+	for (const auto& request : journal) {
+		if (HRESULT replayHr = request.execute(h); FAILED(replayHr)) {
+			logger.error(std::format("Replay of {} call failed (hr={}).", request.info().api, replayHr));
+			failed++;
+		}
+	}
+	logger.info(std::format("Reconnected to SimConnect, replayed {} registrations ({} failed).", journal.size(), failed));
+	return true;
+}
+
+/*
+ * Perform a request on the SimConnect connection, or queue it for the owner of the broker if this is a client.
+ */
+static HRESULT execute(Connection* conn, const Request& request)
+{
+	if (BrokerClient* client = conn->brokerClient(); client != nullptr) {
+		return client->send(request);
+	}
+	return request.execute(conn->handle());
+}
+
+/*
+ * Send the latest values of all coalesced client events.
+ */
+static size_t flushCoalescedEvents(Connection* conn)
+{
+	if (!conn->coalescer().hasPending()) {
+		return 0;
+	}
+	std::unique_lock<std::mutex> scLock(scMutex);
+	return conn->coalescer().flush([conn](const nl::rakis::interop::CoalescedEvent& event) {
+		HRESULT hr = execute(conn, Request{ RequestOp::TransmitClientEvent, { event.objectId, event.eventId, event.data, event.groupId, event.flags } });
+		if (FAILED(hr)) {
+			logger.error(std::format("Failed to transmit coalesced client event {} (HRESULT = {}).", event.eventId, hr));
+		}
+	});
+}
+
+/*
+ * History and tracking timestamps, in microseconds on the monotonic clock.
+ */
+static int64_t clockMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Feed an untagged data row to the history, object tracker and recorder of its request, if any.
+ */
+static void recordObjectData(Connection* conn, const SIMCONNECT_RECV_SIMOBJECT_DATA* msg, size_t size)
+{
+	auto recorder{ conn->recorder() };
+	if (conn->histories().empty() && conn->trackers().empty() && ((recorder == nullptr) || recorder->empty())) {
+		return;
+	}
+	const int64_t now{ clockMicros() };
+	if (recorder != nullptr) {
+		recorder->record(msg->dwRequestID, msg->dwObjectID, now, &msg->dwData, size);
+	}
+	if (auto ring = conn->histories().find(msg->dwRequestID); (ring != nullptr) && (msg->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA)) {
+		ring->record(now, &msg->dwData, size);
+	}
+	if (auto tracker = conn->trackers().find(msg->dwRequestID); tracker != nullptr) {
+		tracker->update(msg->dwObjectID, now, &msg->dwData, size);
+	}
+}
+
+/*
+ * Native processing of every received message, before it is passed on to the client.
+ */
+static void onMessage(Connection* conn, SIMCONNECT_RECV* pData, DWORD cbData)
+{
+	if (conn == nullptr) {
+		return;
+	}
+	if (auto broker = conn->broker(); broker != nullptr) {
+		broker->publish(pData, cbData);
+	}
+	if (conn->arrivals().isEnabled()) {
+		if (pData->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA) {
+			conn->arrivals().arrived(ArrivalMonitor::Kind::SimObjectData, static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData)->dwRequestID, clockMicros());
+		}
+		else if (pData->dwID == SIMCONNECT_RECV_ID_CLIENT_DATA) {
+			conn->arrivals().arrived(ArrivalMonitor::Kind::ClientData, static_cast<SIMCONNECT_RECV_CLIENT_DATA*>(pData)->dwRequestID, clockMicros());
+		}
+	}
+	switch (pData->dwID) {
+	case SIMCONNECT_RECV_ID_EVENT_FRAME:
+		if (conn->coalescer().flushOnFrame()) {
+			flushCoalescedEvents(conn);
+		}
+		break;
+
+	case SIMCONNECT_RECV_ID_CLIENT_DATA:
+		if (auto msg = static_cast<SIMCONNECT_RECV_CLIENT_DATA*>(pData); (msg->dwFlags & SIMCONNECT_CLIENT_DATA_REQUEST_FLAG_TAGGED) == 0) {
+			const size_t header{ sizeof(SIMCONNECT_RECV_CLIENT_DATA) - sizeof(DWORD) };	// The data starts at dwData
+			if (auto channel = conn->channels().findByDefId(msg->dwDefineID); (channel != nullptr) && (cbData > header)) {
+				channel->accept(msg->dwDefineID, &msg->dwData, cbData - header);
+			}
+		}
+		break;
+
+	case SIMCONNECT_RECV_ID_SYSTEM_STATE:
+		conn->tickets().complete(static_cast<SIMCONNECT_RECV_SYSTEM_STATE*>(pData)->dwRequestID, pData, cbData);
+		break;
+
+	case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
+	case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE:
+		if (auto msg = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData); (msg->dwFlags & SIMCONNECT_DATA_REQUEST_FLAG_TAGGED) == 0) {
+			const size_t header{ sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD) };	// The data starts at dwData
+			if (cbData > header) {
+				recordObjectData(conn, msg, cbData - header);
+			}
+		}
+		if (pData->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA) {
+			conn->tickets().complete(static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData)->dwRequestID, pData, cbData);
+		}
+		break;
+
+	case SIMCONNECT_RECV_ID_EXCEPTION: {
+		auto msg{ static_cast<SIMCONNECT_RECV_EXCEPTION*>(pData) };
+		logger.error(std::format("SimConnect exception {} for SendID {} (parameter {}).", msg->dwException, msg->dwSendID, msg->dwIndex));
+		conn->tickets().fail(msg->dwSendID, pData, cbData);
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+/*
+ * Feed the time the client took for a data row to the rate controller of its request. A new interval is only posted
+ * here, since this runs on the dispatch path; sendRateChanges() sends it once SimConnect is free.
+ */
+static void adjustRate(Connection* conn, uint32_t requestId, int64_t time, int64_t busy)
+{
+	auto controller{ conn->rates().find(requestId) };
+	if (controller == nullptr) {
+		return;
+	}
+	if (auto interval = controller->record(time, busy); interval.has_value()) {
+		conn->rates().post(requestId, *interval);
+	}
+}
+
+/*
+ * With frame aggregation, hold a data message for the current frame, closing it early if it is full. Other messages
+ * go straight to the client.
+ */
+template <typename Callback>
+static void pass(Connection* conn, SIMCONNECT_RECV* msg, DWORD size, const Callback& callback)
+{
+	if ((conn == nullptr) || !conn->frames().isEnabled() || !FrameAggregator::isFrameData(msg)) {
+		callback(msg, size);
+		return;
+	}
+	if (!conn->frames().add(msg, size)) {
+		DWORD recordSize;
+		SIMCONNECT_RECV* record{ conn->frames().close(0.0f, 0.0f, FrameAggregator::FLAG_PARTIAL, recordSize) };
+		callback(record, recordSize);
+		conn->frames().add(msg, size);
+	}
+}
+
+/*
+ * Pass a message to the client, followed by a copy for every other subscriber of a shared data request. With frame
+ * aggregation, the frame event is replaced by the record of the data received since the previous one.
+ */
+template <typename Callback>
+static void deliver(Connection* conn, SIMCONNECT_RECV* pData, DWORD cbData, const Callback& callback)
+{
+	if ((conn != nullptr) && conn->frames().isEnabled() && (pData->dwID == SIMCONNECT_RECV_ID_EVENT_FRAME)
+		&& (static_cast<SIMCONNECT_RECV_EVENT*>(pData)->uEventID == conn->frames().frameEventId())) {
+		auto frame{ static_cast<SIMCONNECT_RECV_EVENT_FRAME*>(pData) };
+		DWORD recordSize;
+		SIMCONNECT_RECV* record{ conn->frames().close(frame->fFrameRate, frame->fSimSpeed, 0, recordSize) };
+		callback(record, recordSize);
+		return;
+	}
+	if ((conn != nullptr) && conn->frames().isEnabled() && FrameAggregator::isFrameData(pData)) {
+		pass(conn, pData, cbData, callback);
+		if (!conn->rates().empty() && (pData->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA)) {
+			// The row reaches the client with its frame, so only the lag it reports counts
+			adjustRate(conn, static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData)->dwRequestID, clockMicros(), 0);
+		}
+	}
+	else if ((conn != nullptr) && !conn->rates().empty() && (pData->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA)) {
+		const int64_t start{ clockMicros() };
+		callback(pData, cbData);
+		const int64_t end{ clockMicros() };
+		adjustRate(conn, static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData)->dwRequestID, end, end - start);
+	}
+	else {
+		callback(pData, cbData);
+	}
+	if ((conn == nullptr) || conn->sharing().empty() || (pData->dwID != SIMCONNECT_RECV_ID_SIMOBJECT_DATA)) {
+		return;
+	}
+	static thread_local std::vector<Subscriber> subscribers;
+	static thread_local std::vector<uint8_t> copy;
+
+	auto msg{ static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData) };
+	if (!conn->sharing().subscribers(msg->dwRequestID, subscribers) || subscribers.empty()) {
+		return;
+	}
+	const size_t header{ sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD) };	// The data starts at dwData
+	for (const auto& subscriber : subscribers) {
+		copy.assign(reinterpret_cast<const uint8_t*>(pData), reinterpret_cast<const uint8_t*>(pData) + cbData);
+		auto fanned{ reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(copy.data()) };
+		fanned->dwRequestID = subscriber.requestId;
+		fanned->dwDefineID = subscriber.defId;
+		if (cbData > header) {
+			recordObjectData(conn, fanned, cbData - header);
+		}
+		if (conn->arrivals().isEnabled()) {
+			conn->arrivals().arrived(ArrivalMonitor::Kind::SimObjectData, subscriber.requestId, clockMicros());
+		}
+		pass(conn, fanned, cbData, callback);
+	}
+}
+
+/*
+ * Fetch the next message, from SimConnect or, for a broker client, from the messages published by the owner.
+ */
+static HRESULT nextMessage(HANDLE handle, Connection* conn, SIMCONNECT_RECV*& msg, DWORD& size)
+{
+	if (BrokerClient* client = (conn != nullptr) ? conn->brokerClient() : nullptr; client != nullptr) {
+		const void* data;
+		uint32_t length;
+		if (!client->next(data, length)) {
+			return E_FAIL;
+		}
+		msg = static_cast<SIMCONNECT_RECV*>(const_cast<void*>(data));
+		size = length;
+		return S_OK;
+	}
+	return SimConnect_GetNextDispatch(handle, &msg, &size);
 }
 
-void* messageHandler;
+struct DispatchContext {
+	std::shared_ptr<Connection> conn;
+	DispatchProc callback;
+};
 
 void CsDispatch(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
 {
+	auto context{ static_cast<DispatchContext*>(pContext) };
+
 	logger.trace(std::format("Received message {}", long(pData->dwID)));
-	((DispatchProc)messageHandler)(pData, cbData, pContext);
+	onMessage(context->conn.get(), pData, cbData);
+	deliver(context->conn.get(), pData, cbData, [context](SIMCONNECT_RECV* msg, DWORD size) { context->callback(msg, size, nullptr); });
 }
 
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsCallDispatch(HANDLE handle, DispatchProc callback) {
 	initLog();
-	messageHandler = callback;
 	logger.debug("Calling CallDispatch()");
 
-	HRESULT hr = SimConnect_CallDispatch(handle, CsDispatch, nullptr);
+	DispatchContext context{ Connection::find(handle), callback };
+	if ((context.conn != nullptr) && (context.conn->brokerClient() != nullptr)) {
+		SIMCONNECT_RECV* msgPtr;
+		DWORD msgLen;
+		while (SUCCEEDED(nextMessage(handle, context.conn.get(), msgPtr, msgLen))) {
+			CsDispatch(msgPtr, msgLen, &context);
+		}
+		sendRateChanges(context.conn.get());
+		return true;
+	}
+	HRESULT hr = SimConnect_CallDispatch(handle, CsDispatch, &context);
+	sendRateChanges(context.conn.get());
 
-	if (hr != E_FAIL) {
+	if (FAILED(hr)) {
 		logger.error(std::format("Dispatch failed (HRESULT = {}).", hr));
 	}
 	return SUCCEEDED(hr);
 }
 
-CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetNextDispatch(HANDLE handle, DispatchProc callback) {
-	initLog();
-	logger.trace("Calling GetNextDispatch()");
-
+static HRESULT dispatchNext(HANDLE handle, Connection* conn, DispatchProc callback)
+{
 	SIMCONNECT_RECV* msgPtr;
 	DWORD msgLen;
-	HRESULT hr = SimConnect_GetNextDispatch(handle, &msgPtr, &msgLen);
+	HRESULT hr = nextMessage(handle, conn, msgPtr, msgLen);
 
 	if (SUCCEEDED(hr)) {
 		logger.trace(std::format("Dispatching message {}", long(msgPtr->dwID)));
-		callback(msgPtr, msgLen, nullptr);
+		onMessage(conn, msgPtr, msgLen);
+		deliver(conn, msgPtr, msgLen, [callback](SIMCONNECT_RECV* msg, DWORD size) { callback(msg, size, nullptr); });
+		sendRateChanges(conn);
 	}
 	else if (hr != E_FAIL) {
 		logger.error(std::format("Could not get a new message (HRESULT = {}).", hr));
 	}
-	return SUCCEEDED(hr);
+	return hr;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetNextDispatch(HANDLE handle, DispatchProc callback) {
+	initLog();
+	logger.trace("Calling GetNextDispatch()");
+
+	return SUCCEEDED(dispatchNext(handle, Connection::find(handle).get(), callback));
 }
 
 /*
- * Utilities
+ * Block until SimConnect signals the connection's event, then pass all queued messages to the callback.
  */
+CS_SIMCONNECT_DLL_EXPORT_LONG CsWaitForDispatch(HANDLE handle, uint32_t timeoutMs, DispatchProc callback) {
+	initLog();
 
-long fetchSendId(HANDLE handle, HRESULT hr, const char* api)
-{
-	DWORD sendId{ 0 };
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (conn->event() == nullptr)) {
+		logger.error("Handle passed to CsWaitForDispatch is not a connection opened through CsConnectWithEvent!");
+		return FALSE;
+	}
 
-	if (SUCCEEDED(hr)) {
-		if (FAILED(SimConnect_GetLastSentPacketID(handle, &sendId))) {
-			logger.error(std::format("Failed to retrieve SendID for '{}' call.", api));
-		}
+	auto poll = [handle, conn, callback]() { return SUCCEEDED(dispatchNext(handle, conn.get(), callback)); };
+	return conn->dispatcher().wait(poll, *conn->event(), std::chrono::milliseconds(timeoutMs));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsWakeDispatch(HANDLE handle) {
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (conn->event() == nullptr)) {
+		return false;
+	}
+	conn->event()->signal();
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetDispatchThreadAffinity(HANDLE handle, uint64_t affinityMask, int32_t priority) {
+	initLog();
+
+	logger.info(std::format("CsSetDispatchThreadAffinity(..., 0x{:x}, {})", affinityMask, priority));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetDispatchThreadAffinity is not a connection opened through CsConnect!");
+		return false;
+	}
+	auto settings{ conn->dispatcher().settings() };
+	settings.affinityMask = affinityMask;
+	settings.priority = priority;
+	conn->dispatcher().configure(settings);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetDispatchWaitStrategy(HANDLE handle, uint32_t spinMicros, uint32_t yieldMicros) {
+	initLog();
+
+	logger.info(std::format("CsSetDispatchWaitStrategy(..., {}, {})", spinMicros, yieldMicros));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetDispatchWaitStrategy is not a connection opened through CsConnect!");
+		return false;
 	}
-	return SUCCEEDED(hr) ? sendId : hr;
+	auto settings{ conn->dispatcher().settings() };
+	settings.spinMicros = spinMicros;
+	settings.yieldMicros = yieldMicros;
+	conn->dispatcher().configure(settings);
+	return true;
 }
 
 /*
- * Client Event handling.
+ * Receive on a dedicated thread, which applies the affinity and priority of the connection when it starts. The
+ * callback is called on that thread.
  */
-
-CS_SIMCONNECT_DLL_EXPORT_LONG CsAddClientEventToNotificationGroup(HANDLE handle, uint32_t groupId, uint32_t eventId, uint32_t maskable) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartDispatchThread(HANDLE handle, DispatchProc callback) {
 	initLog();
 
-	logger.trace(std::format("CsAddClientEventToNotificationGroup(..., {}, {}, {})", groupId, eventId, maskable));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsAddClientEventToNotificationGroup is null!");
-		return FALSE;
+	logger.info("CsStartDispatchThread(...)");
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (conn->event() == nullptr) || (callback == nullptr)) {
+		logger.error("Handle passed to CsStartDispatchThread is not a connection opened through CsConnectWithEvent!");
+		return false;
 	}
+	auto poll = [conn = conn.get(), callback]() { return SUCCEEDED(dispatchNext(conn->handle(), conn, callback)); };
+	if (!conn->dispatcher().start(poll, *conn->event())) {
+		logger.error("CsStartDispatchThread: the dispatch thread is already running.");
+		return false;
+	}
+	return true;
+}
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AddClientEventToNotificationGroup(handle, groupId, eventId, maskable), "AddClientEventToNotificationGroup");
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopDispatchThread(HANDLE handle) {
+	initLog();
+
+	logger.info("CsStopDispatchThread(...)");
+	auto conn{ Connection::find(handle) };
+	return (conn != nullptr) && conn->dispatcher().stop();
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientEventToSimEvent(HANDLE handle, uint32_t eventId, const char* eventName) {
+/*
+ * Fetch queued messages as copies held by the connection, so they can be processed in bulk after the call returns.
+ */
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDispatchBatch(HANDLE handle, uint32_t maxMessages, SIMCONNECT_RECV** messages, DWORD* sizes) {
 	initLog();
 
-	logger.trace(std::format("CsMapClientEventToSimEvent(..., {}, '{}')", eventId, eventName));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsMapClientEventToSimEvent is null!");
+	logger.trace(std::format("CsGetDispatchBatch(..., {}, ..., ...)", maxMessages));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsGetDispatchBatch is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	if ((messages == nullptr) || (sizes == nullptr)) {
+		logger.error("CsGetDispatchBatch: no arrays passed for the messages and their sizes.");
 		return FALSE;
 	}
+	auto& batch{ conn->batch() };
+	auto hold = [&batch](SIMCONNECT_RECV* msg, DWORD size) { batch.queue(msg, size); };
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_MapClientEventToSimEvent(handle, eventId, eventName), "MapClientEventToSimEvent");
+	SIMCONNECT_RECV* msgPtr;
+	DWORD msgLen;
+	while ((batch.queued() < maxMessages) && SUCCEEDED(nextMessage(handle, conn.get(), msgPtr, msgLen))) {
+		onMessage(conn.get(), msgPtr, msgLen);
+		deliver(conn.get(), msgPtr, msgLen, hold);
+	}
+	sendRateChanges(conn.get());
+	return int64_t(batch.take(maxMessages, [messages, sizes](size_t i, void* msg, uint32_t size) {
+		messages[i] = static_cast<SIMCONNECT_RECV*>(msg);
+		sizes[i] = size;
+	}));
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsMapInputEventToClientEvent(HANDLE handle, uint32_t groupId, const char* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable) {
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReleaseDispatchBatch(HANDLE handle) {
 	initLog();
 
-	logger.trace(std::format("CsMapInputEventToClientEvent(..., {}, '{}', {}, {}, {}, {}, {})", groupId, inputDefinition, downEventId, downValue, upEventId, upValue, maskable));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsMapInputEventToClientEvent is null!");
+	logger.trace("CsReleaseDispatchBatch(...)");
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsReleaseDispatchBatch is not a connection opened through CsConnect!");
 		return FALSE;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_MapInputEventToClientEvent(handle, groupId, inputDefinition, downEventId, downValue, upEventId, upValue, maskable), "MapInputEventToClientEvent");
+	return int64_t(conn->batch().release());
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRemoveClientEvent(HANDLE handle, uint32_t groupId, uint32_t eventId) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetDispatchBatchStatistics(HANDLE handle, uint64_t* heapAllocations, uint64_t* copies, uint64_t* reservedBytes) {
 	initLog();
 
-	logger.trace(std::format("CsRemoveClientEvent(..., {}, {})", groupId, eventId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRemoveClientEvent is null!");
-		return FALSE;
+	logger.trace("CsGetDispatchBatchStatistics(...)");
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsGetDispatchBatchStatistics is not a connection opened through CsConnect!");
+		return false;
+	}
+	const auto stats{ conn->batch().statistics() };
+	if (heapAllocations != nullptr) {
+		*heapAllocations = stats.slabs + stats.oversized;
+	}
+	if (copies != nullptr) {
+		*copies = stats.allocations;
 	}
+	if (reservedBytes != nullptr) {
+		*reservedBytes = stats.reserved;
+	}
+	return true;
+}
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RemoveClientEvent(handle, groupId, eventId), "RemoveClientEvent");
+/*
+ * Utilities
+ */
+
+long fetchSendId(HANDLE handle, HRESULT hr, const char* api)
+{
+	DWORD sendId{ 0 };
+
+	if (SUCCEEDED(hr)) {
+		if (FAILED(SimConnect_GetLastSentPacketID(handle, &sendId))) {
+			logger.error(std::format("Failed to retrieve SendID for '{}' call.", api));
+		}
+	}
+	else {
+		logger.error(std::format("'{}' call failed (hr={:#x}).", api, uint32_t(hr)));
+	}
+	return SUCCEEDED(hr) ? long(sendId) : long(hr);
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent(HANDLE handle, uint32_t objectId, uint32_t eventId, uint32_t data, uint32_t groupId, uint32_t flags) {
-	initLog();
+static inline std::string str(const char* s)
+{
+	return (s != nullptr) ? s : "";
+}
 
-	logger.trace(std::format("CsTransmitClientEvent(..., {}, {}, {}, {}, {})", objectId, eventId, data, groupId, flags));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsTransmitClientEvent is null!");
-		return FALSE;
+/*
+ * Send a request while the caller holds scMutex, keeping the native state of the connection in sync. Requests of a
+ * broker client are queued for the owner, so they have no SendID.
+ */
+static long sendRequest(Connection* conn, HANDLE handle, const Request& request)
+{
+	HRESULT hr = (conn != nullptr) ? execute(conn, request) : request.execute(handle);
+
+	if (SUCCEEDED(hr) && (conn != nullptr)) {
+		conn->applied(request);
+	}
+	if ((conn != nullptr) && (conn->brokerClient() != nullptr)) {
+		return SUCCEEDED(hr) ? TRUE : hr;
+	}
+	return fetchSendId(handle, hr, request.info().api);
+}
+
+static long sendRequest(HANDLE handle, const Request& request)
+{
+	return sendRequest(Connection::find(handle).get(), handle, request);
+}
+
+/*
+ * Requests default to the class of their op, unless the calling thread asked for a specific class.
+ */
+static thread_local uint32_t threadPriority{ CS_PRIORITY_DEFAULT };
+
+static constexpr size_t BULK_PAYLOAD_SIZE{ 4096 };
+
+static RequestPriority priorityOf(const Request& request)
+{
+	if (threadPriority < uint32_t(RequestPriority::Count)) {
+		return RequestPriority(threadPriority);
 	}
+	if (request.payload.size() >= BULK_PAYLOAD_SIZE) {
+		return RequestPriority::Bulk;
+	}
+	return request.info().priority;
+}
 
+/*
+ * Send a request, or queue it if the connection has its scheduler running. Queued requests have no SendID yet.
+ */
+static void sendPostedRates(Connection* conn);
+
+static long submitRequest(Connection* conn, HANDLE handle, const Request& request)
+{
+	if ((conn != nullptr) && conn->scheduler().isRunning()) {
+		conn->scheduler().submit(priorityOf(request), request);
+		return TRUE;
+	}
 	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_TransmitClientEvent(handle, objectId, eventId, data, groupId, flags), "TransmitClientEvent");
+	const long result{ sendRequest(conn, handle, request) };
+	if ((conn != nullptr) && conn->rates().hasChanges()) {
+		sendPostedRates(conn);
+	}
+	return result;
 }
 
-#if IS_PREPAR3D
+static long submitRequest(HANDLE handle, const Request& request)
+{
+	return submitRequest(Connection::find(handle).get(), handle, request);
+}
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent64(HANDLE handle, uint32_t objectId, uint32_t eventId, uint64_t data, uint32_t groupId, uint32_t flags) {
+/*
+ * Send the data requests whose rate controller picked a new interval, through the scheduler if it is running. Without
+ * it the caller holds scMutex.
+ */
+static void sendPostedRates(Connection* conn)
+{
+	static thread_local std::vector<std::pair<uint32_t, uint32_t>> changes;
+
+	if (!conn->rates().take(changes)) {
+		return;
+	}
+	for (const auto& [requestId, interval] : changes) {
+		Request request;
+		if (!conn->findRequest(requestId, request) || (request.args[6] == interval)) {
+			continue;
+		}
+		logger.info(std::format("Changing the interval of data request {} from {} to {}.", requestId, request.args[6], interval));
+		request.args[6] = interval;
+		if (conn->scheduler().isRunning()) {
+			conn->scheduler().submit(priorityOf(request), request);
+		}
+		else if (long result = sendRequest(conn->handle(), request); result < 0) {
+			logger.error(std::format("Failed to send data request {} with its new interval (HRESULT = {}).", requestId, result));
+		}
+	}
+}
+
+/*
+ * Send posted interval changes from the dispatch path, without waiting for scMutex. If another thread holds it, the
+ * changes stay posted for the next message or request.
+ */
+static void sendRateChanges(Connection* conn)
+{
+	if ((conn == nullptr) || !conn->rates().hasChanges()) {
+		return;
+	}
+	std::unique_lock<std::mutex> scLock(scMutex, std::defer_lock);
+	if (!conn->scheduler().isRunning() && !scLock.try_lock()) {
+		return;
+	}
+	sendPostedRates(conn);
+}
+
+/*
+ * With write suppression enabled for the connection, check a payload against the last one sent to the same target.
+ * Unchanged payloads are not sent, and the caller returns CS_RESULT_SUPPRESSED.
+ */
+static bool isUnchangedWrite(Connection* conn, WriteTarget target, uint32_t first, uint32_t second, const DataSchema* schema, const void* data, size_t size)
+{
+	return (conn != nullptr) && conn->writes().isEnabled() && !conn->writes().offer(target, first, second, schema, data, size);
+}
+
+static void forgetWrite(Connection* conn, WriteTarget target, uint32_t first, uint32_t second)
+{
+	if ((conn != nullptr) && conn->writes().isEnabled()) {
+		conn->writes().forget(target, first, second);
+	}
+}
+
+/*
+ * Check an untagged payload against the compiled schema of its data definition, if we have one.
+ */
+static bool validateDataSize(Connection* conn, uint32_t defId, uint32_t flags, uint32_t unitSize, const char* api)
+{
+	if ((conn == nullptr) || ((flags & SIMCONNECT_DATA_SET_FLAG_TAGGED) != 0)) {
+		return true;
+	}
+	auto schema{ conn->schemas().find(defId) };
+	if ((schema == nullptr) || !schema->isFixedSize() || (schema->size() == unitSize)) {
+		return true;
+	}
+	logger.error(std::format("{}: unit size {} does not match the {} bytes of data definition {}.", api, unitSize, schema->size(), defId));
+	return false;
+}
+
+/*
+ * Client Event handling.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddClientEventToNotificationGroup(HANDLE handle, uint32_t groupId, uint32_t eventId, uint32_t maskable) {
+	initLog();
+
+	logger.trace(std::format("CsAddClientEventToNotificationGroup(..., {}, {}, {})", groupId, eventId, maskable));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsAddClientEventToNotificationGroup is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::AddClientEventToNotificationGroup, { groupId, eventId, maskable } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientEventToSimEvent(HANDLE handle, uint32_t eventId, const char* eventName) {
+	initLog();
+
+	logger.trace(std::format("CsMapClientEventToSimEvent(..., {}, '{}')", eventId, eventName));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsMapClientEventToSimEvent is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::MapClientEventToSimEvent, { eventId }, { eventName } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapInputEventToClientEvent(HANDLE handle, uint32_t groupId, const char* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable) {
+	initLog();
+
+	logger.trace(std::format("CsMapInputEventToClientEvent(..., {}, '{}', {}, {}, {}, {}, {})", groupId, inputDefinition, downEventId, downValue, upEventId, upValue, maskable));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsMapInputEventToClientEvent is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::MapInputEventToClientEvent, { groupId, downEventId, downValue, upEventId, upValue, maskable }, { inputDefinition } });
+}
+
+/*
+ * Interned mappings: a name that is already mapped on the connection keeps its client event ids, and is not sent again.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternClientEvent(HANDLE handle, const char* eventName, uint32_t proposedId, uint32_t* eventId) {
+	initLog();
+
+	logger.trace(std::format("CsInternClientEvent(..., '{}', {}, ...)", str(eventName), proposedId));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsInternClientEvent is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	if (eventId == nullptr) {
+		logger.error("CsInternClientEvent: no pointer passed for the client event id.");
+		return E_INVALIDARG;
+	}
+	auto claim{ conn->eventNames().claimEvent(eventName, proposedId) };
+	if (!claim) {
+		logger.error(std::format("CsInternClientEvent: client event {} is already mapped to another sim event.", proposedId));
+		return E_INVALIDARG;
+	}
+	auto [id, claimed] = *claim;
+	*eventId = id;
+	if (!claimed) {
+		return TRUE;
+	}
+	long result{ submitRequest(handle, Request{ RequestOp::MapClientEventToSimEvent, { id }, { eventName } }) };
+	if (result <= 0) {
+		conn->eventNames().releaseEvent(eventName);
+	}
+	return result;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternInputEvent(HANDLE handle, uint32_t groupId, const char* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable,
+	uint32_t* mappedDownEventId, uint32_t* mappedUpEventId) {
+	initLog();
+
+	logger.trace(std::format("CsInternInputEvent(..., {}, '{}', {}, {}, {}, {}, {}, ...)", groupId, str(inputDefinition), downEventId, downValue, upEventId, upValue, maskable));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsInternInputEvent is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	auto [mapping, claimed] = conn->eventNames().claimInput(groupId, inputDefinition, { downEventId, upEventId });
+	if (mappedDownEventId != nullptr) {
+		*mappedDownEventId = mapping.downEventId;
+	}
+	if (mappedUpEventId != nullptr) {
+		*mappedUpEventId = mapping.upEventId;
+	}
+	if (!claimed) {
+		return TRUE;
+	}
+	long result{ submitRequest(handle, Request{ RequestOp::MapInputEventToClientEvent, { groupId, downEventId, downValue, upEventId, upValue, maskable }, { inputDefinition } }) };
+	if (result <= 0) {
+		conn->eventNames().releaseInput(groupId, inputDefinition);
+	}
+	return result;
+}
+
+/*
+ * Look up the client event ids of several sim events at once, storing -1 for names not mapped. Returns the number found.
+ */
+CS_SIMCONNECT_DLL_EXPORT_LONG CsLookupClientEvents(HANDLE handle, const char* const* eventNames, uint32_t count, int64_t* eventIds) {
+	initLog();
+
+	logger.trace(std::format("CsLookupClientEvents(..., ..., {}, ...)", count));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsLookupClientEvents is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	if ((eventNames == nullptr) || (eventIds == nullptr)) {
+		logger.error("CsLookupClientEvents: no arrays passed for the event names and their ids.");
+		return E_INVALIDARG;
+	}
+	int64_t found{ 0 };
+	for (uint32_t i = 0; i < count; i++) {
+		auto id{ conn->eventNames().findEvent(eventNames[i]) };
+		eventIds[i] = id ? int64_t(*id) : -1;
+		found += id ? 1 : 0;
+	}
+	return found;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRemoveClientEvent(HANDLE handle, uint32_t groupId, uint32_t eventId) {
+	initLog();
+
+	logger.trace(std::format("CsRemoveClientEvent(..., {}, {})", groupId, eventId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRemoveClientEvent is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RemoveClientEvent, { groupId, eventId } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent(HANDLE handle, uint32_t objectId, uint32_t eventId, uint32_t data, uint32_t groupId, uint32_t flags) {
+	initLog();
+
+	logger.trace(std::format("CsTransmitClientEvent(..., {}, {}, {}, {}, {})", objectId, eventId, data, groupId, flags));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsTransmitClientEvent is null!");
+		return FALSE;
+	}
+
+	if (auto conn = Connection::find(handle); (conn != nullptr) && conn->coalescer().isActive() && conn->coalescer().offer(objectId, eventId, data, groupId, flags)) {
+		return TRUE;	// Sent on the next flush, so there is no SendID
+	}
+
+	return submitRequest(handle, Request{ RequestOp::TransmitClientEvent, { objectId, eventId, data, groupId, flags } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetEventCoalescing(HANDLE handle, uint32_t eventId, uint32_t enabled) {
+	initLog();
+
+	logger.info(std::format("CsSetEventCoalescing(..., {}, {})", eventId, enabled));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetEventCoalescing is not a connection opened through CsConnect!");
+		return false;
+	}
+	if (!conn->coalescer().enable(eventId, enabled != 0)) {
+		logger.error(std::format("Cannot coalesce more than {} client events per connection.", nl::rakis::interop::EventCoalescer::CAPACITY));
+		return false;
+	}
+	if (!enabled) {
+		flushCoalescedEvents(conn.get());
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetCoalescingFlush(HANDLE handle, uint32_t rateHz, uint32_t onFrame) {
+	initLog();
+
+	logger.info(std::format("CsSetCoalescingFlush(..., {}, {})", rateHz, onFrame));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetCoalescingFlush is not a connection opened through CsConnect!");
+		return false;
+	}
+	if (rateHz > nl::rakis::interop::EventCoalescer::MAX_RATE) {
+		logger.error(std::format("Cannot flush coalesced events more than {} times per second.", nl::rakis::interop::EventCoalescer::MAX_RATE));
+		return false;
+	}
+	conn->coalescer().setFlushOnFrame(onFrame != 0);
+	if (rateHz == 0) {
+		conn->coalescer().stop();
+	}
+	else {
+		conn->coalescer().start(std::chrono::microseconds(1000000 / rateHz), [conn = conn.get()]() { flushCoalescedEvents(conn); });
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsFlushCoalescedEvents(HANDLE handle) {
+	initLog();
+
+	logger.trace("CsFlushCoalescedEvents(...)");
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsFlushCoalescedEvents is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	return flushCoalescedEvents(conn.get());
+}
+
+#if IS_PREPAR3D
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent64(HANDLE handle, uint32_t objectId, uint32_t eventId, uint64_t data, uint32_t groupId, uint32_t flags) {
+	initLog();
+
+	logger.trace(std::format("CsTransmitClientEvent64(..., {}, {}, {}, {}, {})", objectId, eventId, data, groupId, flags));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsTransmitClientEvent64 is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::TransmitClientEvent64, { objectId, eventId, uint32_t(data), uint32_t(data >> 32), groupId, flags } });
+}
+
+#endif
+
+/*
+ * Client Data handling.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToClientDataDefinition(HANDLE handle, uint32_t defId, DWORD offset, int32_t sizeOrType, float epsilon, DWORD datumId)
+{
+	initLog();
+
+	logger.trace(std::format("CsAddToClientDataDefinition(..., {}, {}, {}, {}, {})", defId, offset, sizeOrType, epsilon, datumId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsAddToClientDataDefinition is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::AddToClientDataDefinition, { defId, offset, uint32_t(sizeOrType), Request::fromFloat(epsilon), datumId } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsCreateClientData(HANDLE handle, uint32_t clientDataId, DWORD size, uint32_t flags)
+{
+	initLog();
+
+	logger.trace(std::format("CsCreateClientData(..., {}, {}, {})", clientDataId, size, flags));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsCreateClientData is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::CreateClientData, { clientDataId, size, flags } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientDataNameToID(HANDLE handle, const char* clientDataName, uint32_t clientDataId) {
+	initLog();
+
+	logger.trace(std::format("CsMapClientDataNameToID(..., '{}', {})", clientDataName, clientDataId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsMapClientDataNameToID is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::MapClientDataNameToID, { clientDataId }, { clientDataName } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestClientData(HANDLE handle, uint32_t clientDataId, uint32_t requestId, uint32_t defineId, uint32_t period, uint32_t flags, DWORD origin, DWORD interval, DWORD limit)
+{
+	initLog();
+
+	logger.trace(std::format("CsRequestClientData(..., {}, {}, {}, {}, {}, {}, {}, {})", clientDataId, requestId, defineId, period, flags, origin, interval, limit));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestClientData is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RequestClientData, { clientDataId, requestId, defineId, period, flags, origin, interval, limit } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetClientData(HANDLE handle, uint32_t clientDataId, uint32_t defineId, DWORD flags, DWORD unitSize, void* dataSet) {
+	initLog();
+
+	logger.trace(std::format("CsSetClientData(..., {}, {}, {}, ..., {}, ...)", clientDataId, defineId, flags, unitSize));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsSetClientData is null!");
+		return FALSE;
+	}
+
+	auto conn{ Connection::find(handle) };
+	if (isUnchangedWrite(conn.get(), WriteTarget::ClientData, clientDataId, defineId, nullptr, dataSet, unitSize)) {
+		return CS_RESULT_SUPPRESSED;
+	}
+	long result{ submitRequest(conn.get(), handle, Request{ RequestOp::SetClientData, { clientDataId, defineId, flags, unitSize }, {}, { dataSet, unitSize } }) };
+	if (result <= 0) {
+		forgetWrite(conn.get(), WriteTarget::ClientData, clientDataId, defineId);
+	}
+	return result;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsClearClientDataDefinition(HANDLE handle, uint32_t clientDataId) {
+	initLog();
+
+	logger.trace(std::format("CsClearClientDataDefinition(..., {})", clientDataId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsClearClientDataDefinition is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::ClearClientDataDefinition, { clientDataId } });
+}
+
+/*
+ * Client data channels: a native mirror of a client data area of which only the changed ranges are sent.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsOpenClientDataChannel(HANDLE handle, uint32_t clientDataId, uint32_t size, uint32_t rangeSize, uint32_t firstDefId, uint32_t create)
+{
+	initLog();
+
+	logger.info(std::format("CsOpenClientDataChannel(..., {}, {}, {}, {}, {})", clientDataId, size, rangeSize, firstDefId, create));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsOpenClientDataChannel is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	if ((size == 0) || (rangeSize == 0)) {
+		logger.error("CsOpenClientDataChannel: size and range size must be positive.");
+		return E_INVALIDARG;
+	}
+	auto channel{ std::make_shared<ClientDataChannel>(clientDataId, size, rangeSize, firstDefId) };
+	if (!conn->channels().add(channel)) {
+		logger.error(std::format("CsOpenClientDataChannel: client data {} already has a channel.", clientDataId));
+		return E_INVALIDARG;
+	}
+
+	long result{ TRUE };
+	if (create != 0) {
+		result = submitRequest(handle, Request{ RequestOp::CreateClientData, { clientDataId, size, SIMCONNECT_CREATE_CLIENT_DATA_FLAG_DEFAULT } });
+	}
+	for (uint32_t range = 0; (result > 0) && (range < channel->rangeCount()); range++) {
+		result = submitRequest(handle, Request{ RequestOp::AddToClientDataDefinition,
+			{ channel->defId(range), channel->rangeOffset(range), channel->rangeSize(range), Request::fromFloat(0.0f), SIMCONNECT_UNUSED } });
+	}
+	if (result <= 0) {
+		logger.error(std::format("CsOpenClientDataChannel: registration for client data {} failed (result = {}).", clientDataId, result));
+		conn->channels().remove(clientDataId);
+		return result;
+	}
+	return channel->rangeCount();
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetClientDataChannelBuffer(HANDLE handle, uint32_t clientDataId, void** buffer)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetClientDataChannelBuffer(..., {}, ...)", clientDataId));
+	auto conn{ Connection::find(handle) };
+	auto channel{ (conn != nullptr) ? conn->channels().find(clientDataId) : nullptr };
+	if ((channel == nullptr) || (buffer == nullptr)) {
+		logger.error(std::format("CsGetClientDataChannelBuffer: no channel open for client data {}.", clientDataId));
+		return false;
+	}
+	*buffer = channel->buffer();
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRefreshClientDataChannel(HANDLE handle, uint32_t clientDataId)
+{
+	initLog();
+
+	logger.trace(std::format("CsRefreshClientDataChannel(..., {})", clientDataId));
+	auto conn{ Connection::find(handle) };
+	auto channel{ (conn != nullptr) ? conn->channels().find(clientDataId) : nullptr };
+	if (channel == nullptr) {
+		logger.error(std::format("CsRefreshClientDataChannel: no channel open for client data {}.", clientDataId));
+		return FALSE;
+	}
+	return channel->refresh();
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsCommitClientDataChannel(HANDLE handle, uint32_t clientDataId)
+{
+	initLog();
+
+	logger.trace(std::format("CsCommitClientDataChannel(..., {})", clientDataId));
+	auto conn{ Connection::find(handle) };
+	auto channel{ (conn != nullptr) ? conn->channels().find(clientDataId) : nullptr };
+	if (channel == nullptr) {
+		logger.error(std::format("CsCommitClientDataChannel: no channel open for client data {}.", clientDataId));
+		return FALSE;
+	}
+
+	// A queued range counts as committed; if the scheduler fails to send it, it is marked to be sent again.
+	if (conn->scheduler().isRunning()) {
+		return channel->commit([conn = conn.get(), channel, clientDataId](uint32_t defId, const uint8_t* data, uint32_t size) {
+			Request request{ RequestOp::SetClientData, { clientDataId, defId, SIMCONNECT_CLIENT_DATA_SET_FLAG_DEFAULT, size }, {}, { data, size } };
+			conn->scheduler().submit(priorityOf(request), request, [channel, clientDataId, defId](long result) {
+				if (result <= 0) {
+					logger.error(std::format("Failed to send range {} of client data {} (result = {}).", defId, clientDataId, result));
+					channel->failed(defId);
+				}
+			});
+			return true;
+		});
+	}
+	std::unique_lock<std::mutex> scLock(scMutex);
+	return channel->commit([conn = conn.get(), clientDataId](uint32_t defId, const uint8_t* data, uint32_t size) {
+		HRESULT hr = execute(conn, Request{ RequestOp::SetClientData, { clientDataId, defId, SIMCONNECT_CLIENT_DATA_SET_FLAG_DEFAULT, size }, {}, { data, size } });
+		if (FAILED(hr)) {
+			logger.error(std::format("Failed to send range {} of client data {} (HRESULT = {}).", defId, clientDataId, hr));
+		}
+		return SUCCEEDED(hr);
+	});
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsCloseClientDataChannel(HANDLE handle, uint32_t clientDataId)
+{
+	initLog();
+
+	logger.info(std::format("CsCloseClientDataChannel(..., {})", clientDataId));
+	auto conn{ Connection::find(handle) };
+	auto channel{ (conn != nullptr) ? conn->channels().remove(clientDataId) : nullptr };
+	if (channel == nullptr) {
+		logger.error(std::format("CsCloseClientDataChannel: no channel open for client data {}.", clientDataId));
+		return false;
+	}
+	for (uint32_t range = 0; range < channel->rangeCount(); range++) {
+		submitRequest(handle, Request{ RequestOp::ClearClientDataDefinition, { channel->defId(range) } });
+	}
+	return true;
+}
+
+/*
+ * Notification Group Specific
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsClearNotificationGroup(HANDLE handle, uint32_t groupId) {
+	initLog();
+
+	logger.trace(std::format("CsClearNotificationGroup(..., {})", groupId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsClearNotificationGroup is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::ClearNotificationGroup, { groupId } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestNotificationGroup(HANDLE handle, uint32_t groupId) {
+	initLog();
+
+	logger.trace(std::format("CsRequestNotificationGroup(..., {})", groupId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestNotificationGroup is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RequestNotificationGroup, { groupId } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetNotificationGroupPriority(HANDLE handle, uint32_t groupId, uint32_t priority) {
+	initLog();
+
+	logger.trace(std::format("CsSetNotificationGroupPriority(..., {}, {})", groupId, priority));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsSetNotificationGroupPriority is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::SetNotificationGroupPriority, { groupId, priority } });
+}
+
+/*
+ * System state handling.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSubscribeToSystemEvent(HANDLE handle, int eventId, const char* eventName) {
+	initLog();
+
+	logger.trace(std::format("CsSubscribeToSystemEvent(..., {}, '{}')", eventId, eventName));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsSubscribeToSystemEvent is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::SubscribeToSystemEvent, { uint32_t(eventId) }, { eventName } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemState(HANDLE handle, int requestId, const char* eventName) {
+	initLog();
+
+	logger.trace(std::format("CsRequestSystemState(..., {}, '{}'", requestId, eventName));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestSystemState is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RequestSystemState, { uint32_t(requestId) }, { eventName } });
+}
+
+/*
+ * Shared data requests: a request with the same layout and parameters as one already sent subscribes to it instead.
+ */
+
+static long requestData(HANDLE handle, Subscriber subscriber, const RequestParams& p)
+{
+	return submitRequest(handle, Request{ RequestOp::RequestDataOnSimObject, { subscriber.requestId, subscriber.defId, p[0], p[1], p[2], p[3], p[4], p[5] } });
+}
+
+static void leaveShared(HANDLE handle, const SharedRequests::Leave& leave)
+{
+	if ((leave.left == SharedRequests::Left::Handover) && (requestData(handle, leave.carrier, leave.params) <= 0)) {
+		logger.error(std::format("Could not hand a shared data request over to request {}.", leave.carrier.requestId));
+	}
+}
+
+static long requestShared(HANDLE handle, Connection* conn, Subscriber subscriber, const RequestParams& params)
+{
+	const auto leave{ conn->sharing().leave(subscriber.requestId) };
+	leaveShared(handle, leave);
+
+	const uint32_t period{ params[1] };
+	if ((period == SIMCONNECT_PERIOD_NEVER) && (leave.left == SharedRequests::Left::Subscriber)) {
+		return TRUE;		// Nothing was sent for this requestId
+	}
+	std::shared_ptr<const DataSchema> schema;
+	if (conn->sharing().isEnabled() && (period > SIMCONNECT_PERIOD_ONCE) && ((params[2] & SIMCONNECT_DATA_REQUEST_FLAG_TAGGED) == 0)) {
+		schema = conn->schemas().find(subscriber.defId);
+	}
+	if ((schema == nullptr) || !schema->isFixedSize() || (conn->rates().find(subscriber.requestId) != nullptr)) {
+		return requestData(handle, subscriber, params);		// A rate-controlled request has an interval of its own
+	}
+
+	if (!conn->sharing().join(SharedRequests::keyOf(*schema, params), subscriber, params)) {
+		if (conn->requesting(subscriber.requestId)) {
+			// Stop what this requestId had before, since the shared request now takes its place
+			RequestParams never{ params };
+			never[1] = SIMCONNECT_PERIOD_NEVER;
+			requestData(handle, subscriber, never);
+		}
+		return TRUE;
+	}
+	const long result{ requestData(handle, subscriber, params) };
+	if (result <= 0) {
+		leaveShared(handle, conn->sharing().leave(subscriber.requestId));
+	}
+	return result;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObject(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t period, uint32_t dataRequestFlags,
+	DWORD origin, DWORD interval, DWORD limit)
+{
+	initLog();
+
+	logger.info(std::format("CsRequestDataOnSimObject(..., {}, {}, {}, {}, {}, {}, {}, {})", requestId, defId, objectId, period, dataRequestFlags, origin, interval, limit));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestDataOnSimObject is null!");
+		return FALSE;
+	}
+	if (auto conn = Connection::find(handle); (conn != nullptr) && (conn->sharing().isEnabled() || !conn->sharing().empty())) {
+		return requestShared(handle, conn.get(), { requestId, defId }, { objectId, period, dataRequestFlags, origin, interval, limit });
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RequestDataOnSimObject, { requestId, defId, objectId, period, dataRequestFlags, origin, interval, limit } });
+}
+
+/*
+ * One-shot requests with a ticket, which the dispatch path completes when the reply arrives.
+ */
+
+static int64_t submitTicket(HANDLE handle, const Request& request, uint32_t requestId, TicketProc callback, const char* api)
+{
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error(std::format("Handle passed to {} is not a connection opened through CsConnect!", api));
+		return FALSE;
+	}
+	TicketTable::Callback onReply;
+	if (callback != nullptr) {
+		onReply = [callback](uint64_t ticket, TicketState, const void* reply, uint32_t size) {
+			callback(int64_t(ticket), static_cast<SIMCONNECT_RECV*>(const_cast<void*>(reply)), size);
+		};
+	}
+	const uint64_t ticket{ conn->tickets().issue(requestId, std::move(onReply)) };
+	if (ticket == 0) {
+		logger.error(std::format("{}: all {} tickets are in use.", api, TicketTable::CAPACITY));
+		return E_OUTOFMEMORY;
+	}
+
+	// The SendID lets an exception fail the ticket. The requests of a broker client are sent by the owner, so they
+	// have none, and their tickets can only complete.
+	auto onSent = [conn = conn.get(), ticket, hasSendId = (conn->brokerClient() == nullptr)](long result) {
+		if (result <= 0) {
+			conn->tickets().abort(ticket);
+		}
+		else if (hasSendId) {
+			conn->tickets().sent(ticket, uint32_t(result));
+		}
+	};
+	if (conn->scheduler().isRunning()) {
+		conn->scheduler().submit(priorityOf(request), request, std::move(onSent));
+		return int64_t(ticket);
+	}
+	long result;
+	{
+		std::unique_lock<std::mutex> scLock(scMutex);
+		result = sendRequest(conn.get(), handle, request);
+	}
+	if (result <= 0) {
+		conn->tickets().release(ticket);
+		return result;
+	}
+	onSent(result);
+	return int64_t(ticket);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateAsync(HANDLE handle, uint32_t requestId, const char* stateName, TicketProc callback)
+{
+	initLog();
+
+	logger.trace(std::format("CsRequestSystemStateAsync(..., {}, '{}', ...)", requestId, str(stateName)));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestSystemStateAsync is null!");
+		return FALSE;
+	}
+
+	return submitTicket(handle, Request{ RequestOp::RequestSystemState, { requestId }, { stateName } }, requestId, callback, "CsRequestSystemStateAsync");
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObjectOnce(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t dataRequestFlags, TicketProc callback)
+{
+	initLog();
+
+	logger.trace(std::format("CsRequestDataOnSimObjectOnce(..., {}, {}, {}, {}, ...)", requestId, defId, objectId, dataRequestFlags));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestDataOnSimObjectOnce is null!");
+		return FALSE;
+	}
+
+	return submitTicket(handle, Request{ RequestOp::RequestDataOnSimObject, { requestId, defId, objectId, SIMCONNECT_PERIOD_ONCE, dataRequestFlags, 0, 0, 0 } },
+		requestId, callback, "CsRequestDataOnSimObjectOnce");
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTicketState(HANDLE handle, int64_t ticket)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetTicketState(..., {})", ticket));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsGetTicketState is not a connection opened through CsConnect!");
+		return CS_TICKET_UNKNOWN;
+	}
+	return int64_t(conn->tickets().state(uint64_t(ticket)));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsWaitForTicket(HANDLE handle, int64_t ticket, uint32_t timeoutMs)
+{
+	initLog();
+
+	logger.trace(std::format("CsWaitForTicket(..., {}, {})", ticket, timeoutMs));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsWaitForTicket is not a connection opened through CsConnect!");
+		return CS_TICKET_UNKNOWN;
+	}
+	return int64_t(conn->tickets().wait(uint64_t(ticket), std::chrono::milliseconds(timeoutMs)));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTicketReply(HANDLE handle, int64_t ticket, void* buffer, uint32_t size)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetTicketReply(..., {}, ..., {})", ticket, size));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsGetTicketReply is not a connection opened through CsConnect!");
+		return FALSE;
+	}
+	return int64_t(conn->tickets().reply(uint64_t(ticket), buffer, size));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReleaseTicket(HANDLE handle, int64_t ticket)
+{
+	initLog();
+
+	logger.trace(std::format("CsReleaseTicket(..., {})", ticket));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsReleaseTicket is not a connection opened through CsConnect!");
+		return false;
+	}
+	return conn->tickets().release(uint64_t(ticket));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObjectType(HANDLE handle, uint32_t requestId, uint32_t defineId, uint32_t radius, uint32_t objectType) {
+	initLog();
+
+	logger.trace(std::format("CsRequestDataOnSimObjectType(..., {}, {}, {}, {})", requestId, defineId, radius, objectType));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRequestDataOnSimObjectType is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::RequestDataOnSimObjectType, { requestId, defineId, radius, objectType } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetDataOnSimObject(HANDLE handle, uint32_t defId, uint32_t objectId, uint32_t flags, uint32_t count, uint32_t unitSize, void* data)
+{
+	initLog();
+
+	logger.info(std::format("CsSetDataOnSimObject(..., {}, {}, {}, {}, {}, ...)", defId, objectId, flags, count, unitSize));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsSetDataOnSimObject is null!");
+		return FALSE;
+	}
+
+	auto conn{ Connection::find(handle) };
+	if (!validateDataSize(conn.get(), defId, flags, unitSize, "CsSetDataOnSimObject")) {
+		return E_INVALIDARG;
+	}
+	const size_t size{ size_t(std::max(count, 1u)) * unitSize };
+	auto schema{ ((conn != nullptr) && ((flags & SIMCONNECT_DATA_SET_FLAG_TAGGED) == 0)) ? conn->schemas().find(defId) : nullptr };
+	if (isUnchangedWrite(conn.get(), WriteTarget::SimObject, defId, objectId, schema.get(), data, size)) {
+		return CS_RESULT_SUPPRESSED;
+	}
+	long result{ submitRequest(conn.get(), handle, Request{ RequestOp::SetDataOnSimObject, { defId, objectId, flags, count, unitSize }, {}, { data, size } }) };
+	if (result <= 0) {
+		forgetWrite(conn.get(), WriteTarget::SimObject, defId, objectId);
+	}
+	return result;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToDataDefinition(HANDLE handle, uint32_t defId, const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId)
+{
+	initLog();
+
+	logger.trace(std::format("CsAddToDataDefinition(..., {}, {}, {}, {}, {}, {})", defId, datumName, unitsName, datumType, epsilon, datumId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsAddToDataDefinition is null!");
+		return FALSE;
+	}
+
+	if ((unitsName != nullptr) && (strcmp(unitsName, "NULL") == 0)) {
+		unitsName = nullptr;
+	}
+	return submitRequest(handle, Request{ RequestOp::AddToDataDefinition, { defId, datumType, Request::fromFloat(epsilon), datumId }, { datumName, unitsName } });
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsClearDataDefinition(HANDLE handle, uint32_t defineId)
+{
+	initLog();
+
+	logger.trace(std::format("CsClearDataDefinition(..., {})", defineId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsClearDataDefinition is null!");
+		return FALSE;
+	}
+
+	return submitRequest(handle, Request{ RequestOp::ClearDataDefinition, { defineId } });
+}
+
+/*
+ * Bulk registration.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRegisterManifest(HANDLE handle, const void* manifest, uint32_t size, int64_t* results, uint32_t capacity)
+{
+	initLog();
+
+	logger.trace(std::format("CsRegisterManifest(..., ..., {}, ..., {})", size, capacity));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsRegisterManifest is null!");
+		return FALSE;
+	}
+
+	std::vector<Request> requests;
+	if ((manifest == nullptr) || !Request::decodeAll(manifest, size, requests)) {
+		logger.error(std::format("CsRegisterManifest: manifest is malformed at record {}.", requests.size()));
+		return E_INVALIDARG;
+	}
+	if ((results != nullptr) && (capacity < requests.size())) {
+		logger.error(std::format("CsRegisterManifest: {} results do not fit in {} slots.", requests.size(), capacity));
+		return E_INVALIDARG;
+	}
+	logger.debug(std::format("Registering {} requests from manifest.", requests.size()));
+
+	// Queued calls go first, so the manifest is not sent ahead of calls made before it. It is then sent directly,
+	// so every record gets its own result.
+	if (auto conn = Connection::find(handle); (conn != nullptr) && conn->scheduler().isRunning()) {
+		conn->scheduler().drain();
+	}
+	std::unique_lock<std::mutex> scLock(scMutex);
+	for (size_t i = 0; i < requests.size(); i++) {
+		long result = sendRequest(handle, requests[i]);
+		if (results != nullptr) {
+			results[i] = result;
+		}
+		if (result <= 0) {
+			logger.error(std::format("CsRegisterManifest: {} call at record {} failed (result = {}).", requests[i].info().api, i, result));
+		}
+	}
+	return requests.size();
+}
+
+/*
+ * Outbound scheduling.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetScheduling(HANDLE handle, uint32_t enabled)
+{
+	initLog();
+
+	logger.info(std::format("CsSetScheduling(..., {})", enabled));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetScheduling is not a connection opened through CsConnect!");
+		return false;
+	}
+	if (!enabled) {
+		if (size_t dropped = conn->scheduler().stop(); dropped > 0) {
+			logger.warn(std::format("Scheduler stopped with {} requests still queued, which were dropped.", dropped));
+		}
+	}
+	else if (!conn->scheduler().isRunning()) {
+		conn->scheduler().start([conn = conn.get()](const Request& request) {
+			std::unique_lock<std::mutex> scLock(scMutex);
+			const long result{ sendRequest(conn, conn->handle(), request) };
+			if (result <= 0) {
+				logger.error(std::format("Scheduled {} call failed (result = {}).", request.info().api, result));
+			}
+			return result;
+		});
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetSchedulerRateLimit(HANDLE handle, uint32_t priority, double requestsPerSecond, uint32_t burst)
+{
+	initLog();
+
+	logger.info(std::format("CsSetSchedulerRateLimit(..., {}, {}, {})", priority, requestsPerSecond, burst));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetSchedulerRateLimit is not a connection opened through CsConnect!");
+		return false;
+	}
+	if (priority >= uint32_t(RequestPriority::Count)) {
+		logger.error(std::format("CsSetSchedulerRateLimit: unknown priority class {}.", priority));
+		return false;
+	}
+	conn->scheduler().setRateLimit(RequestPriority(priority), requestsPerSecond, burst);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetThreadRequestPriority(uint32_t priority)
+{
+	initLog();
+
+	logger.trace(std::format("CsSetThreadRequestPriority({})", priority));
+	if ((priority != CS_PRIORITY_DEFAULT) && (priority >= uint32_t(RequestPriority::Count))) {
+		logger.error(std::format("CsSetThreadRequestPriority: unknown priority class {}.", priority));
+		return false;
+	}
+	threadPriority = priority;
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetSchedulerStatistics(HANDLE handle, uint32_t priority, CsSchedulerStatistics* stats)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetSchedulerStatistics(..., {}, ...)", priority));
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (stats == nullptr) || (priority >= uint32_t(RequestPriority::Count))) {
+		logger.error("Invalid arguments passed to CsGetSchedulerStatistics!");
+		return false;
+	}
+	auto lane{ conn->scheduler().statistics(RequestPriority(priority)) };
+	*stats = CsSchedulerStatistics{ lane.submitted, lane.sent, lane.failed, lane.queued, lane.maxWaitMicros, lane.totalWaitMicros };
+	return true;
+}
+
+/*
+ * Compiled data definitions.
+ */
+
+static std::shared_ptr<const DataSchema> findSchema(const Connection* conn, uint32_t defId, bool fixedSizeOnly, const char* api)
+{
+	auto schema{ (conn != nullptr) ? conn->schemas().find(defId) : nullptr };
+
+	if (schema == nullptr) {
+		logger.error(std::format("{}: data definition {} is not known for this handle.", api, defId));
+	}
+	else if (fixedSizeOnly && !schema->isFixedSize()) {
+		logger.error(std::format("{}: data definition {} contains variable sized data.", api, defId));
+		return nullptr;
+	}
+	return schema;
+}
+
+static std::shared_ptr<const DataSchema> findSchema(HANDLE handle, uint32_t defId, bool fixedSizeOnly, const char* api)
+{
+	return findSchema(Connection::find(handle).get(), defId, fixedSizeOnly, api);
+}
+
+static bool checkColumns(const DataSchema& schema, const void* const* columns, const char* api)
+{
+	if (columns == nullptr) {
+		logger.error(std::format("{}: no columns passed.", api));
+		return false;
+	}
+	for (size_t i = 0; i < schema.fields().size(); i++) {
+		if (columns[i] == nullptr) {
+			logger.error(std::format("{}: column {} ('{}') is null.", api, i, schema.fields()[i].datumName));
+			return false;
+		}
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDataDefinitionSize(HANDLE handle, uint32_t defId)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetDataDefinitionSize(..., {})", defId));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsGetDataDefinitionSize is null!");
+		return FALSE;
+	}
+
+	auto schema{ findSchema(handle, defId, true, "CsGetDataDefinitionSize") };
+	return (schema != nullptr) ? schema->size() : 0;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDataDefinitionLayout(HANDLE handle, uint32_t defId, uint32_t* datumTypes, uint32_t* sizes, uint32_t* offsets, uint32_t capacity)
+{
+	initLog();
+
+	logger.trace(std::format("CsGetDataDefinitionLayout(..., {}, ..., {})", defId, capacity));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsGetDataDefinitionLayout is null!");
+		return FALSE;
+	}
+
+	auto schema{ findSchema(handle, defId, false, "CsGetDataDefinitionLayout") };
+	if (schema == nullptr) {
+		return E_INVALIDARG;
+	}
+	const auto& fields{ schema->fields() };
+	for (uint32_t i = 0; (i < capacity) && (i < fields.size()); i++) {
+		if (datumTypes != nullptr) {
+			datumTypes[i] = fields[i].datumType;
+		}
+		if (sizes != nullptr) {
+			sizes[i] = fields[i].size;
+		}
+		if (offsets != nullptr) {
+			offsets[i] = fields[i].offset;
+		}
+	}
+	return fields.size();
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPackDataDefinition(HANDLE handle, uint32_t defId, uint32_t count, const void* const* columns, void* buffer, uint32_t bufferSize)
+{
+	initLog();
+
+	logger.trace(std::format("CsPackDataDefinition(..., {}, {}, ..., ..., {})", defId, count, bufferSize));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsPackDataDefinition is null!");
+		return FALSE;
+	}
+
+	auto schema{ findSchema(handle, defId, true, "CsPackDataDefinition") };
+	if ((schema == nullptr) || !checkColumns(*schema, columns, "CsPackDataDefinition")) {
+		return E_INVALIDARG;
+	}
+	if ((buffer == nullptr) || (uint64_t(count) * schema->size() > bufferSize)) {
+		logger.error(std::format("CsPackDataDefinition: buffer of {} bytes cannot hold {} rows of {} bytes.", bufferSize, count, schema->size()));
+		return E_INVALIDARG;
+	}
+	schema->pack(count, columns, buffer);
+	return count * schema->size();
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsUnpackDataDefinition(HANDLE handle, uint32_t defId, uint32_t count, const void* buffer, uint32_t bufferSize, void* const* columns, uint32_t firstRow)
+{
+	initLog();
+
+	logger.trace(std::format("CsUnpackDataDefinition(..., {}, {}, ..., {}, ..., {})", defId, count, bufferSize, firstRow));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsUnpackDataDefinition is null!");
+		return FALSE;
+	}
+
+	auto schema{ findSchema(handle, defId, true, "CsUnpackDataDefinition") };
+	if ((schema == nullptr) || !checkColumns(*schema, columns, "CsUnpackDataDefinition")) {
+		return E_INVALIDARG;
+	}
+	if ((buffer == nullptr) || (uint64_t(count) * schema->size() > bufferSize)) {
+		logger.error(std::format("CsUnpackDataDefinition: buffer of {} bytes does not contain {} rows of {} bytes.", bufferSize, count, schema->size()));
+		return E_INVALIDARG;
+	}
+	schema->unpack(count, buffer, columns, firstRow);
+	return count;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetDataOnSimObjects(HANDLE handle, uint32_t defId, uint32_t count, const uint32_t* objectIds, uint32_t flags, const void* const* columns, int64_t* results)
+{
+	initLog();
+
+	logger.trace(std::format("CsSetDataOnSimObjects(..., {}, {}, ..., {}, ...)", defId, count, flags));
+	if (handle == nullptr) {
+		logger.error("Handle passed to CsSetDataOnSimObjects is null!");
+		return FALSE;
+	}
+	if ((flags & SIMCONNECT_DATA_SET_FLAG_TAGGED) != 0) {
+		logger.error("CsSetDataOnSimObjects only supports the default (untagged) layout.");
+		return E_INVALIDARG;
+	}
+
+	auto conn{ Connection::find(handle) };
+	auto schema{ findSchema(conn.get(), defId, true, "CsSetDataOnSimObjects") };
+	if ((schema == nullptr) || (objectIds == nullptr) || !checkColumns(*schema, columns, "CsSetDataOnSimObjects")) {
+		return E_INVALIDARG;
+	}
+
+	thread_local std::vector<uint8_t> row;
+	row.resize(schema->size());
+
+	// With the scheduler running every row is queued on its own, behind any registration of the definition still
+	// waiting, and without holding up other lanes. Otherwise the rows are sent under a single lock.
+	const bool scheduled{ (conn != nullptr) && conn->scheduler().isRunning() };
+	std::unique_lock<std::mutex> scLock(scMutex, std::defer_lock);
+	if (!scheduled) {
+		scLock.lock();
+	}
+	int64_t sent{ 0 };
+	for (uint32_t i = 0; i < count; i++) {
+		schema->packRow(i, columns, row.data());
+		int64_t result{ CS_RESULT_SUPPRESSED };
+		if (!isUnchangedWrite(conn.get(), WriteTarget::SimObject, defId, objectIds[i], schema.get(), row.data(), row.size())) {
+			const Request request{ RequestOp::SetDataOnSimObject, { defId, objectIds[i], flags, 1, schema->size() }, {}, { row.data(), row.size() } };
+			result = scheduled ? submitRequest(conn.get(), handle, request) : sendRequest(conn.get(), handle, request);
+			if (result > 0) {
+				sent++;
+			}
+			else {
+				forgetWrite(conn.get(), WriteTarget::SimObject, defId, objectIds[i]);
+			}
+		}
+		if (results != nullptr) {
+			results[i] = result;
+		}
+	}
+	return sent;
+}
+
+/*
+ * Write suppression: skip CsSetDataOnSimObject(s) and CsSetClientData calls that would not change anything.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetWriteSuppression(HANDLE handle, uint32_t enabled)
+{
+	initLog();
+
+	logger.info(std::format("CsSetWriteSuppression(..., {})", enabled));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetWriteSuppression is not a connection opened through CsConnect!");
+		return false;
+	}
+	conn->writes().setEnabled(enabled != 0);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetSuppressedWriteCount(HANDLE handle)
+{
+	auto conn{ Connection::find(handle) };
+	return (conn != nullptr) ? int64_t(conn->writes().suppressed()) : 0;
+}
+
+/*
+ * Request sharing: merge data requests with identical layouts and parameters, and copy their data to each subscriber.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetRequestSharing(HANDLE handle, uint32_t enabled)
+{
+	initLog();
+
+	logger.info(std::format("CsSetRequestSharing(..., {})", enabled));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsSetRequestSharing is not a connection opened through CsConnect!");
+		return false;
+	}
+	conn->sharing().setEnabled(enabled != 0);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetRequestSharingStatistics(HANDLE handle, uint32_t* sharedRequests, uint32_t* subscribers)
+{
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (sharedRequests == nullptr) || (subscribers == nullptr)) {
+		return false;
+	}
+	conn->sharing().statistics(*sharedRequests, *subscribers);
+	return true;
+}
+
+/*
+ * History: the most recent untagged rows of selected data requests, recorded as they are dispatched.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableHistory(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t capacity)
+{
+	initLog();
+
+	logger.info(std::format("CsEnableHistory(..., {}, {}, {})", requestId, defId, capacity));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsEnableHistory is not a connection opened through CsConnect!");
+		return false;
+	}
+	auto schema{ conn->schemas().find(defId) };
+	if ((schema == nullptr) || !schema->isFixedSize() || (capacity == 0)) {
+		logger.error(std::format("CsEnableHistory: data definition {} is unknown or has variable-length fields.", defId));
+		return false;
+	}
+	conn->histories().add(requestId, std::make_shared<HistoryRing>(schema, capacity));
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableHistory(HANDLE handle, uint32_t requestId)
+{
+	initLog();
+
+	logger.info(std::format("CsDisableHistory(..., {})", requestId));
+	auto conn{ Connection::find(handle) };
+	return (conn != nullptr) && conn->histories().remove(requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetHistoryClock()
+{
+	return clockMicros();
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReadHistory(HANDLE handle, uint32_t requestId, int64_t fromMicros, int64_t toMicros, uint32_t maxCount, int64_t* times, double** columns)
+{
+	initLog();
+
+	logger.trace(std::format("CsReadHistory(..., {}, {}, {}, {}, ...)", requestId, fromMicros, toMicros, maxCount));
+	auto conn{ Connection::find(handle) };
+	auto ring{ (conn != nullptr) ? conn->histories().find(requestId) : nullptr };
+	if (ring == nullptr) {
+		logger.error(std::format("CsReadHistory: no history kept for request {}.", requestId));
+		return E_INVALIDARG;
+	}
+	return int64_t(ring->read(fromMicros, toMicros, maxCount, times, columns));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetHistoryValueAt(HANDLE handle, uint32_t requestId, uint32_t datum, int64_t timeMicros, double* value)
+{
+	auto conn{ Connection::find(handle) };
+	auto ring{ (conn != nullptr) ? conn->histories().find(requestId) : nullptr };
+	return (ring != nullptr) && (value != nullptr) && ring->valueAt(timeMicros, datum, *value);
+}
+
+/*
+ * Object tracking: estimated positions of the objects reported by a data request, at any time.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableTracking(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t latDatum, uint32_t lonDatum, uint32_t altDatum, uint32_t headingDatum,
+	uint32_t maxExtrapolationMs, uint32_t expiryMs)
+{
+	initLog();
+
+	logger.info(std::format("CsEnableTracking(..., {}, {}, {}, {}, {}, {}, {}, {})", requestId, defId, latDatum, lonDatum, altDatum, headingDatum, maxExtrapolationMs, expiryMs));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsEnableTracking is not a connection opened through CsConnect!");
+		return false;
+	}
+	auto schema{ conn->schemas().find(defId) };
+	const std::array<uint32_t, ObjectTracker::CHANNELS> datums{ latDatum, lonDatum, altDatum, headingDatum };
+	if ((schema == nullptr) || !ObjectTracker::isTrackable(*schema, datums)) {
+		logger.error(std::format("CsEnableTracking: data definition {} is unknown, has variable-length fields, or the datums are not numeric.", defId));
+		return false;
+	}
+	conn->trackers().add(requestId, std::make_shared<ObjectTracker>(*schema, datums, int64_t(maxExtrapolationMs) * 1000, int64_t(expiryMs) * 1000));
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableTracking(HANDLE handle, uint32_t requestId)
+{
+	initLog();
+
+	logger.info(std::format("CsDisableTracking(..., {})", requestId));
+	auto conn{ Connection::find(handle) };
+	return (conn != nullptr) && conn->trackers().remove(requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTrackedPositions(HANDLE handle, uint32_t requestId, int64_t timeMicros, uint32_t capacity, uint32_t* objectIds,
+	double* latitudes, double* longitudes, double* altitudes, double* headings)
+{
+	auto conn{ Connection::find(handle) };
+	auto tracker{ (conn != nullptr) ? conn->trackers().find(requestId) : nullptr };
+	if (tracker == nullptr) {
+		return E_INVALIDARG;
+	}
+	double* const channels[ObjectTracker::CHANNELS]{ latitudes, longitudes, altitudes, headings };
+	return int64_t(tracker->sample(timeMicros, capacity, objectIds, channels));
+}
+
+/*
+ * Rate control: the interval of periodic data requests follows how well the client keeps up with them.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableRateControl(HANDLE handle, uint32_t requestId, uint32_t minInterval, uint32_t maxInterval, uint32_t windowMs, uint32_t hold,
+	double highLoad, double lowLoad, uint32_t maxDepth)
+{
+	initLog();
+
+	logger.info(std::format("CsEnableRateControl(..., {}, {}, {}, {}, {}, {}, {}, {})", requestId, minInterval, maxInterval, windowMs, hold, highLoad, lowLoad, maxDepth));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsEnableRateControl is not a connection opened through CsConnect!");
+		return false;
+	}
+	Request request;
+	if (!conn->findRequest(requestId, request)) {
+		logger.error(std::format("CsEnableRateControl: there is no periodic data request {}.", requestId));
+		return false;
+	}
+	if ((minInterval > maxInterval) || (windowMs == 0) || (lowLoad > highLoad)) {
+		logger.error("CsEnableRateControl: the bounds or thresholds are inconsistent.");
+		return false;
+	}
+	if (conn->sharing().isMember(requestId)) {
+		if (!conn->sharing().isCarrier(requestId)) {
+			logger.error(std::format("CsEnableRateControl: request {} receives a copy of a shared request.", requestId));
+			return false;
+		}
+		leaveShared(handle, conn->sharing().leave(requestId));		// The other subscribers keep the current interval
+	}
+	const RateLimits limits{ minInterval, maxInterval, int64_t(windowMs) * 1000, hold, highLoad, lowLoad, maxDepth };
+	auto controller{ std::make_shared<RateController>(limits, request.args[6], clockMicros()) };
+	const uint32_t interval{ controller->interval() };
+	conn->rates().add(requestId, std::move(controller));
+	if (interval != request.args[6]) {
+		request.args[6] = interval;
+		return submitRequest(handle, request) > 0;
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableRateControl(HANDLE handle, uint32_t requestId)
+{
+	initLog();
+
+	logger.info(std::format("CsDisableRateControl(..., {})", requestId));
+	auto conn{ Connection::find(handle) };
+	return (conn != nullptr) && conn->rates().remove(requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReportConsumerLag(HANDLE handle, uint32_t requestId, uint32_t queueDepth)
+{
+	auto conn{ Connection::find(handle) };
+	auto controller{ (conn != nullptr) ? conn->rates().find(requestId) : nullptr };
+	if (controller == nullptr) {
+		return false;
+	}
+	controller->reportDepth(queueDepth);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRateHistory(HANDLE handle, uint32_t requestId, uint32_t capacity, int64_t* times, uint32_t* intervals)
+{
+	auto conn{ Connection::find(handle) };
+	auto controller{ (conn != nullptr) ? conn->rates().find(requestId) : nullptr };
+	if (controller == nullptr) {
+		return FALSE;
+	}
+	return int64_t(controller->history(capacity, times, intervals));
+}
+
+/*
+ * Arrival monitoring: whether the messages of each data request come in at the rate they were requested.
+ */
+
+static_assert(CS_ARRIVAL_BUCKETS == ArrivalMonitor::BUCKETS);
+static_assert(CS_ARRIVAL_CLIENT_DATA == uint32_t(ArrivalMonitor::Kind::ClientData));
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableArrivalMonitor(HANDLE handle, uint32_t capacity)
+{
+	initLog();
+
+	logger.info(std::format("CsEnableArrivalMonitor(..., {})", capacity));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsEnableArrivalMonitor is not a connection opened through CsConnect!");
+		return false;
+	}
+	conn->monitorArrivals((capacity != 0) ? capacity : ArrivalMonitor::DEFAULT_CAPACITY);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableArrivalMonitor(HANDLE handle)
+{
+	initLog();
+
+	logger.info("CsDisableArrivalMonitor(...)");
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		return false;
+	}
+	conn->arrivals().disable();
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetArrivalStatistics(HANDLE handle, CsArrivalStatistics* stats, uint32_t capacity)
+{
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (stats == nullptr)) {
+		return FALSE;
+	}
+	thread_local std::vector<ArrivalMonitor::Snapshot> snapshots;
+	snapshots.resize(capacity);
+	const size_t count{ conn->arrivals().snapshot(snapshots.data(), capacity) };
+	for (size_t i = 0; i < count; i++) {
+		const auto& snapshot{ snapshots[i] };
+		stats[i].requestId = snapshot.requestId;
+		stats[i].kind = uint32_t(snapshot.kind);
+		stats[i].count = snapshot.count;
+		stats[i].lastArrivalMicros = snapshot.lastArrival;
+		stats[i].periodMicros = snapshot.period;
+		stats[i].missedPeriods = snapshot.missed;
+		std::copy(snapshot.histogram.begin(), snapshot.histogram.end(), stats[i].histogram);
+	}
+	return int64_t(count);
+}
+
+/*
+ * Frame aggregation: all data received during a frame passed on as a single record.
+ */
+
+static_assert(CS_RECV_ID_FRAME == FrameAggregator::RECV_ID_FRAME);
+static_assert(sizeof(CsFrameHeader) == sizeof(nl::rakis::interop::FrameHeader));
+static_assert(sizeof(CsFrameEntry) == sizeof(nl::rakis::interop::FrameEntry));
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableFrameAggregation(HANDLE handle, uint32_t frameEventId, uint32_t maxFrameSize)
+{
+	initLog();
+
+	logger.info(std::format("CsEnableFrameAggregation(..., {}, {})", frameEventId, maxFrameSize));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsEnableFrameAggregation is not a connection opened through CsConnect!");
+		return false;
+	}
+	conn->frames().enable(frameEventId, (maxFrameSize != 0) ? maxFrameSize : FrameAggregator::DEFAULT_MAX_SIZE);
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableFrameAggregation(HANDLE handle)
+{
+	initLog();
+
+	logger.info("CsDisableFrameAggregation(...)");
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		return false;
+	}
+	if (size_t dropped = conn->frames().disable(); dropped > 0) {
+		logger.warn(std::format("Frame aggregation stopped with {} messages still waiting for their frame, which were dropped.", dropped));
+	}
+	return true;
+}
+
+/*
+ * Telemetry recording: untagged rows of selected data requests written to a file, and read back.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartRecorder(HANDLE handle, const char* path)
+{
+	initLog();
+
+	logger.info(std::format("CsStartRecorder(..., '{}')", str(path)));
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		logger.error("Handle passed to CsStartRecorder is not a connection opened through CsConnect!");
+		return false;
+	}
+	if ((path == nullptr) || (conn->recorder() != nullptr)) {
+		logger.error("CsStartRecorder needs a path, and no recorder running on the connection.");
+		return false;
+	}
+	std::shared_ptr<TelemetryRecorder> recorder{ TelemetryRecorder::create(path, clockMicros()) };
+	if (recorder == nullptr) {
+		logger.error(std::format("CsStartRecorder: cannot create '{}'.", path));
+		return false;
+	}
+	conn->setRecorder(std::move(recorder));
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsRecordRequest(HANDLE handle, uint32_t requestId, uint32_t defId)
+{
+	initLog();
+
+	logger.info(std::format("CsRecordRequest(..., {}, {})", requestId, defId));
+	auto conn{ Connection::find(handle) };
+	auto recorder{ (conn != nullptr) ? conn->recorder() : nullptr };
+	if (recorder == nullptr) {
+		logger.error("CsRecordRequest: no recorder running on the connection.");
+		return false;
+	}
+	if (!recorder->add(requestId, defId, conn->schemas().find(defId))) {
+		logger.error(std::format("CsRecordRequest: data definition {} is unknown or has variable-length fields, or request {} is already recorded.", defId, requestId));
+		return false;
+	}
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopRecorder(HANDLE handle)
+{
+	initLog();
+
+	logger.info("CsStopRecorder(...)");
+	auto conn{ Connection::find(handle) };
+	auto recorder{ (conn != nullptr) ? conn->recorder() : nullptr };
+	if (recorder == nullptr) {
+		return false;
+	}
+	conn->setRecorder(nullptr);
+	recorder->close();
+	const auto stats{ recorder->statistics() };
+	logger.info(std::format("Recorder stopped after {} rows in {} bytes, {} rows dropped.", stats.rows, stats.bytes, stats.dropped));
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetRecorderStatistics(HANDLE handle, uint64_t* rows, uint64_t* dropped, uint64_t* bytes)
+{
+	auto conn{ Connection::find(handle) };
+	auto recorder{ (conn != nullptr) ? conn->recorder() : nullptr };
+	if ((recorder == nullptr) || (rows == nullptr) || (dropped == nullptr) || (bytes == nullptr)) {
+		return false;
+	}
+	const auto stats{ recorder->statistics() };
+	*rows = stats.rows;
+	*dropped = stats.dropped;
+	*bytes = stats.bytes;
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsOpenRecording(const char* path, HANDLE& recording)
+{
+	initLog();
+
+	logger.info(std::format("CsOpenRecording('{}', ...)", str(path)));
+	auto reader{ (path != nullptr) ? TelemetryReader::open(path) : nullptr };
+	if (reader == nullptr) {
+		logger.error(std::format("CsOpenRecording: '{}' cannot be opened or is not a recording.", str(path)));
+		return false;
+	}
+	recording = TelemetryReader::add(std::move(reader))->handle();
+	return true;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsCloseRecording(HANDLE recording)
+{
+	initLog();
+
+	logger.info("CsCloseRecording(...)");
+	return TelemetryReader::remove(recording) != nullptr;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingEpoch(HANDLE recording)
+{
+	TelemetryReader* reader{ TelemetryReader::find(recording) };
+	return (reader != nullptr) ? reader->epoch() : 0;
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingStreams(HANDLE recording, uint32_t* requestIds, uint32_t capacity)
+{
+	TelemetryReader* reader{ TelemetryReader::find(recording) };
+	if (reader == nullptr) {
+		return E_INVALIDARG;
+	}
+	return int64_t(reader->streams(requestIds, capacity));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingLayout(HANDLE recording, uint32_t requestId, uint32_t* datumTypes, uint32_t* sizes, uint32_t capacity)
+{
+	TelemetryReader* reader{ TelemetryReader::find(recording) };
+	const DataSchema* schema{ (reader != nullptr) ? reader->schema(requestId) : nullptr };
+	if (schema == nullptr) {
+		return E_INVALIDARG;
+	}
+	const auto& fields{ schema->fields() };
+	for (size_t i = 0; i < std::min(fields.size(), size_t(capacity)); i++) {
+		if (datumTypes != nullptr) {
+			datumTypes[i] = fields[i].datumType;
+		}
+		if (sizes != nullptr) {
+			sizes[i] = fields[i].size;
+		}
+	}
+	return int64_t(fields.size());
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReadRecording(HANDLE recording, uint32_t requestId, int64_t fromMicros, int64_t toMicros, uint32_t maxCount,
+	int64_t* times, uint32_t* objectIds, void* const* columns)
+{
 	initLog();
 
-	logger.trace(std::format("CsTransmitClientEvent64(..., {}, {}, {}, {}, {})", objectId, eventId, data, groupId, flags));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsTransmitClientEvent64 is null!");
-		return FALSE;
+	logger.trace(std::format("CsReadRecording(..., {}, {}, {}, {}, ...)", requestId, fromMicros, toMicros, maxCount));
+	TelemetryReader* reader{ TelemetryReader::find(recording) };
+	if ((reader == nullptr) || (reader->schema(requestId) == nullptr)) {
+		logger.error(std::format("CsReadRecording: request {} is not in the recording.", requestId));
+		return E_INVALIDARG;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_TransmitClientEvent64(handle, objectId, eventId, data, groupId, flags), "TransmitClientEvent");
+	return int64_t(reader->read(requestId, fromMicros, toMicros, maxCount, times, objectIds, columns));
 }
 
-#endif
-
 /*
- * Client Data handling.
+ * Connection pools: several connections used as one, with requests spread over them by requestId or class.
  */
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToClientDataDefinition(HANDLE handle, uint32_t defId, DWORD offset, int32_t sizeOrType, float epsilon, DWORD datumId)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectPool(const char* appName, uint32_t shardCount, HANDLE& pool)
 {
 	initLog();
 
-	logger.trace(std::format("CsAddToClientDataDefinition(..., {}, {}, {}, {}, {})", defId, offset, sizeOrType, epsilon, datumId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsAddToClientDataDefinition is null!");
-		return FALSE;
+	logger.info(std::format("CsConnectPool('{}', {}, ...)", str(appName), shardCount));
+	if ((appName == nullptr) || (shardCount == 0)) {
+		logger.error("CsConnectPool needs a client name and at least one shard.");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AddToClientDataDefinition(handle, defId, offset, sizeOrType, epsilon, datumId), "AddToClientDataDefinition");
+	std::vector<std::shared_ptr<Connection>> shards;
+	for (uint32_t i = 0; i < shardCount; i++) {
+		const std::string name{ (i == 0) ? std::string(appName) : std::format("{} #{}", appName, i) };
+		HANDLE handle;
+		auto conn{ connect(name.c_str(), handle, true) ? Connection::find(handle) : nullptr };
+		if (conn == nullptr) {
+			logger.error(std::format("CsConnectPool: could not open shard {}.", i));
+			for (const auto& shard : shards) {
+				CsDisconnect(shard->handle());
+			}
+			return false;
+		}
+		shards.push_back(conn);
+	}
+	pool = ConnectionPool::add(std::make_shared<ConnectionPool>(std::move(shards)))->handle();
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsCreateClientData(HANDLE handle, uint32_t clientDataId, DWORD size, uint32_t flags)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisconnectPool(HANDLE pool)
 {
 	initLog();
 
-	logger.trace(std::format("CsCreateClientData(..., {}, {}, {})", clientDataId, size, flags));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsCreateClientData is null!");
-		return FALSE;
+	logger.info("CsDisconnectPool(...)");
+	auto removed{ ConnectionPool::remove(pool) };
+	if (removed == nullptr) {
+		logger.error("Handle passed to CsDisconnectPool is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_CreateClientData(handle, clientDataId, size, flags), "CreateClientData");
+	bool closed{ true };
+	for (const auto& shard : removed->shards()) {
+		closed = CsDisconnect(shard->handle()) && closed;
+	}
+	return closed;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientDataNameToID(HANDLE handle, const char* clientDataName, uint32_t clientDataId) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetPoolShard(HANDLE pool, uint32_t index, HANDLE& shard)
+{
 	initLog();
 
-	logger.trace(std::format("CsMapClientDataNameToID(..., '{}', {})", clientDataName, clientDataId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsMapClientDataNameToID is null!");
-		return FALSE;
+	logger.trace(std::format("CsGetPoolShard(..., {}, ...)", index));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsGetPoolShard is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_MapClientDataNameToID(handle, clientDataName, clientDataId), "MapClientDataNameToID");
+	if (index >= connections->size()) {
+		logger.error(std::format("CsGetPoolShard: the pool has no shard {}.", index));
+		return false;
+	}
+	shard = connections->shard(index)->handle();
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestClientData(HANDLE handle, uint32_t clientDataId, uint32_t requestId, uint32_t defineId, uint32_t period, uint32_t flags, DWORD origin, DWORD interval, DWORD limit)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsAssignPoolRequests(HANDLE pool, uint32_t firstRequestId, uint32_t lastRequestId, uint32_t shard)
 {
 	initLog();
 
-	logger.trace(std::format("CsRequestClientData(..., {}, {}, {}, {}, {}, {}, {}, {})", clientDataId, requestId, defineId, period, flags, origin, interval, limit));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRequestClientData is null!");
-		return FALSE;
+	logger.info(std::format("CsAssignPoolRequests(..., {}, {}, {})", firstRequestId, lastRequestId, shard));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsAssignPoolRequests is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RequestClientData(handle, clientDataId, requestId, defineId, SIMCONNECT_CLIENT_DATA_PERIOD(period), flags, origin, interval, limit), "RequestClientData");
+	if (!connections->assign(firstRequestId, lastRequestId, shard)) {
+		logger.error(std::format("CsAssignPoolRequests: requests {} to {} overlap an earlier range, or shard {} does not exist.", firstRequestId, lastRequestId, shard));
+		return false;
+	}
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsSetClientData(HANDLE handle, uint32_t clientDataId, uint32_t defineId, DWORD flags, DWORD unitSize, void* dataSet) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsAssignPoolClass(HANDLE pool, uint32_t requestClass, uint32_t shard)
+{
 	initLog();
 
-	logger.trace(std::format("CsSetClientData(..., {}, {}, {}, ..., {}, ...)", clientDataId, defineId, flags, unitSize));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsSetClientData is null!");
-		return FALSE;
+	logger.info(std::format("CsAssignPoolClass(..., {}, {})", requestClass, shard));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsAssignPoolClass is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_SetClientData(handle, clientDataId, defineId, flags, 0, unitSize, dataSet), "SetClientData");
+	if (!connections->assign(PoolClass(requestClass), shard)) {
+		logger.error(std::format("CsAssignPoolClass: there is no request class {} or shard {}.", requestClass, shard));
+		return false;
+	}
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsClearClientDataDefinition(HANDLE handle, uint32_t clientDataId) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetPoolShardForRequest(HANDLE pool, uint32_t requestId, uint32_t requestClass, HANDLE& shard)
+{
 	initLog();
 
-	logger.trace(std::format("CsClearClientDataDefinition(..., {})", clientDataId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsClearClientDataDefinition is null!");
-		return FALSE;
+	logger.trace(std::format("CsGetPoolShardForRequest(..., {}, {}, ...)", requestId, requestClass));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsGetPoolShardForRequest is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_ClearClientDataDefinition(handle, clientDataId), "ClearClientDataDefinition");
+	shard = connections->shard(connections->shardOf(requestId, PoolClass(requestClass)))->handle();
+	return true;
 }
 
 /*
- * Notification Group Specific
+ * Find the shard for a request, and copy the data definition it uses from the first shard if that shard does not
+ * have the same definition yet. A definition that changed on the first shard is cleared and copied again.
  */
-
-CS_SIMCONNECT_DLL_EXPORT_LONG CsClearNotificationGroup(HANDLE handle, uint32_t groupId) {
-	initLog();
-
-	logger.trace(std::format("CsClearNotificationGroup(..., {})", groupId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsClearNotificationGroup is null!");
-		return FALSE;
+static Connection* shardFor(ConnectionPool& pool, uint32_t requestId, PoolClass requestClass, uint32_t defId)
+{
+	Connection* primary{ pool.shard(0) };
+	Connection* shard{ pool.shard(pool.shardOf(requestId, requestClass)) };
+	if (shard == primary) {
+		return shard;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_ClearNotificationGroup(handle, groupId), "ClearNotificationGroup");
+	std::scoped_lock<std::mutex> lock(pool.registrationMutex());
+	auto schema{ primary->schemas().find(defId) };
+	if (schema == nullptr) {
+		return shard;
+	}
+	auto copy{ shard->schemas().find(defId) };
+	if ((copy != nullptr) && (copy->fields() == schema->fields())) {
+		return shard;
+	}
+	if ((copy != nullptr) && (submitRequest(shard->handle(), Request{ RequestOp::ClearDataDefinition, { defId } }) <= 0)) {
+		logger.error(std::format("Could not clear the old copy of data definition {} on a pool shard.", defId));
+		return nullptr;
+	}
+	for (const auto& field : schema->fields()) {
+		long result{ submitRequest(shard->handle(), Request{ RequestOp::AddToDataDefinition, { defId, field.datumType, Request::fromFloat(field.epsilon), field.datumId }, { field.datumName, field.unitsName } }) };
+		if (result <= 0) {
+			logger.error(std::format("Could not copy data definition {} to a pool shard.", defId));
+			return nullptr;
+		}
+	}
+	return shard;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestNotificationGroup(HANDLE handle, uint32_t groupId) {
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPoolRequestDataOnSimObject(HANDLE pool, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t period, uint32_t dataRequestFlags,
+	DWORD origin, DWORD interval, DWORD limit)
+{
 	initLog();
 
-	logger.trace(std::format("CsRequestNotificationGroup(..., {})", groupId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRequestNotificationGroup is null!");
+	logger.trace(std::format("CsPoolRequestDataOnSimObject(..., {}, {}, {}, {}, {}, {}, {}, {})", requestId, defId, objectId, period, dataRequestFlags, origin, interval, limit));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsPoolRequestDataOnSimObject is not a pool opened through CsConnectPool!");
 		return FALSE;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RequestNotificationGroup(handle, groupId), "RequestNotificationGroup");
+	Connection* shard{ shardFor(*connections, requestId, PoolClass::Object, defId) };
+	return (shard != nullptr) ? CsRequestDataOnSimObject(shard->handle(), requestId, defId, objectId, period, dataRequestFlags, origin, interval, limit) : FALSE;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsSetNotificationGroupPriority(HANDLE handle, uint32_t groupId, uint32_t priority) {
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPoolRequestDataOnSimObjectType(HANDLE pool, uint32_t requestId, uint32_t defId, uint32_t radius, uint32_t objectType)
+{
 	initLog();
 
-	logger.trace(std::format("CsSetNotificationGroupPriority(..., {}, {})", groupId, priority));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsSetNotificationGroupPriority is null!");
+	logger.trace(std::format("CsPoolRequestDataOnSimObjectType(..., {}, {}, {}, {})", requestId, defId, radius, objectType));
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsPoolRequestDataOnSimObjectType is not a pool opened through CsConnectPool!");
 		return FALSE;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_SetNotificationGroupPriority(handle, groupId, priority), "SetNotificationGroupPriority");
+	Connection* shard{ shardFor(*connections, requestId, PoolClass::ObjectType, defId) };
+	return (shard != nullptr) ? CsRequestDataOnSimObjectType(shard->handle(), requestId, defId, radius, objectType) : FALSE;
 }
 
 /*
- * System state handling.
+ * Receive on every shard with a thread of its own. The callback is called on all of them, so concurrently.
  */
-
-CS_SIMCONNECT_DLL_EXPORT_LONG CsSubscribeToSystemEvent(HANDLE handle, int eventId, const char* eventName) {
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartPoolDispatch(HANDLE pool, DispatchProc callback)
+{
 	initLog();
 
-	logger.trace(std::format("CsSubscribeToSystemEvent(..., {}, '{}')", eventId, eventName));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsSubscribeToSystemEvent is null!");
-		return FALSE;
+	logger.info("CsStartPoolDispatch(...)");
+	auto connections{ ConnectionPool::find(pool) };
+	if ((connections == nullptr) || (callback == nullptr)) {
+		logger.error("Handle passed to CsStartPoolDispatch is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_SubscribeToSystemEvent(handle, eventId, eventName), "SubScribeToSystemEvent");
-}
-
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemState(HANDLE handle, int requestId, const char* eventName) {
-	initLog();
-
-	logger.trace(std::format("CsRequestSystemState(..., {}, '{}'", requestId, eventName));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRequestSystemState is null!");
-		return FALSE;
+	bool started{ true };
+	for (const auto& shard : connections->shards()) {
+		started = CsStartDispatchThread(shard->handle(), callback) && started;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RequestSystemState(handle, requestId, eventName), "RequestSystemState");
+	return started;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObject(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t period, uint32_t dataRequestFlags,
-	DWORD origin, DWORD interval, DWORD limit)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopPoolDispatch(HANDLE pool)
 {
 	initLog();
 
-	logger.info(std::format("CsRequestDataOnSimObject(..., {}, {}, {}, {}, {}, {}, {}, {})", requestId, defId, objectId, period, dataRequestFlags, origin, interval, limit));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRequestDataOnSimObject is null!");
-		return FALSE;
+	logger.info("CsStopPoolDispatch(...)");
+	auto connections{ ConnectionPool::find(pool) };
+	if (connections == nullptr) {
+		logger.error("Handle passed to CsStopPoolDispatch is not a pool opened through CsConnectPool!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RequestDataOnSimObject(handle, requestId, defId, objectId, SIMCONNECT_PERIOD(period), dataRequestFlags, origin, interval, limit), "RequestDataOnSimObject");
+	for (const auto& shard : connections->shards()) {
+		shard->dispatcher().stop();
+	}
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObjectType(HANDLE handle, uint32_t requestId, uint32_t defineId, uint32_t radius, uint32_t objectType) {
+/*
+ * Brokers: the owner of a connection shares it with clients in other processes on the same machine.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartBroker(HANDLE handle, const char* name, uint32_t slotCount, uint32_t slotSize)
+{
 	initLog();
 
-	logger.trace(std::format("CsRequestDataOnSimObjectType(..., {}, {}, {}, {})", requestId, defineId, radius, objectType));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsRequestDataOnSimObjectType is null!");
-		return FALSE;
+	logger.info(std::format("CsStartBroker(..., '{}', {}, {})", str(name), slotCount, slotSize));
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (conn->brokerClient() != nullptr) || (name == nullptr)) {
+		logger.error("Handle passed to CsStartBroker is not a connection opened through CsConnect!");
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_RequestDataOnSimObjectType(handle, requestId, defineId, radius, SIMCONNECT_SIMOBJECT_TYPE(objectType)), "RequestDataOnSimObjectType");
+	if (conn->broker() != nullptr) {
+		logger.error("CsStartBroker: the connection already has a broker.");
+		return false;
+	}
+	auto region{ BrokerRegion::create(name, (slotCount != 0) ? slotCount : BrokerRegion::DEFAULT_SLOT_COUNT, (slotSize != 0) ? slotSize : BrokerRegion::DEFAULT_SLOT_SIZE) };
+	if (region == nullptr) {
+		logger.error(std::format("CsStartBroker: could not create shared memory for broker '{}'.", name));
+		return false;
+	}
+	conn->setBroker(std::make_shared<Broker>(std::move(region), [conn = conn.get()](const Request& request) {
+		if (long result = submitRequest(conn->handle(), request); result < 0) {
+			logger.error(std::format("Brokered {} call failed (HRESULT = {}).", request.info().api, result));
+		}
+	}));
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsSetDataOnSimObject(HANDLE handle, uint32_t defId, uint32_t objectId, uint32_t flags, uint32_t count, uint32_t unitSize, void* data)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopBroker(HANDLE handle)
 {
 	initLog();
 
-	logger.info(std::format("CsSetDataOnSimObject(..., {}, {}, {}, {}, {}, ...)", defId, objectId, flags, count, unitSize));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsSetDataOnSimObject is null!");
-		return FALSE;
+	logger.info("CsStopBroker(...)");
+	auto conn{ Connection::find(handle) };
+	if ((conn == nullptr) || (conn->broker() == nullptr)) {
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_SetDataOnSimObject(handle, defId, objectId, flags, count, unitSize, data), "SetDataOnSimObject");
+	conn->setBroker(nullptr);
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToDataDefinition(HANDLE handle, uint32_t defId, const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectBroker(const char* name, HANDLE& handle)
 {
 	initLog();
 
-	logger.trace(std::format("CsAddToDataDefinition(..., {}, {}, {}, {}, {}, {})", defId, datumName, unitsName, datumType, epsilon, datumId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsAddToDataDefinition is null!");
-		return FALSE;
+	logger.info(std::format("CsConnectBroker('{}', ...)", str(name)));
+	auto region{ (name != nullptr) ? BrokerRegion::open(name) : nullptr };
+	if (region == nullptr) {
+		logger.error(std::format("CsConnectBroker: there is no broker named '{}'.", str(name)));
+		return false;
 	}
-
-	if ((unitsName != nullptr) && (strcmp(unitsName, "NULL") == 0)) {
-		unitsName = nullptr;
+	auto client{ std::make_unique<BrokerClient>(std::move(region)) };
+	auto conn{ Connection::attach(client->handle(), name) };
+	if (conn == nullptr) {
+		logger.error("CsConnectBroker: too many open connections.");
+		return false;
 	}
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AddToDataDefinition(handle, defId, datumName, unitsName, SIMCONNECT_DATATYPE(datumType), epsilon, datumId), "AddToDataDefinition");
+	handle = client->handle();
+	conn->setBrokerClient(std::move(client));
+	return true;
 }
 
-CS_SIMCONNECT_DLL_EXPORT_LONG CsClearDataDefinition(HANDLE handle, uint32_t defineId)
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetBrokerStatistics(HANDLE handle, uint64_t* messages, uint64_t* dropped, uint64_t* requests)
 {
-	initLog();
-
-	logger.trace(std::format("CsClearDataDefinition(..., {})", defineId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsClearDataDefinition is null!");
-		return FALSE;
+	auto conn{ Connection::find(handle) };
+	if (conn == nullptr) {
+		return false;
 	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_ClearDataDefinition(handle, defineId), "ClearDataDefinition");
+	uint64_t published{ 0 };
+	uint64_t lost{ 0 };
+	uint64_t sent{ 0 };
+	if (auto broker = conn->broker(); broker != nullptr) {
+		published = broker->published();
+		lost = broker->oversized();
+		sent = broker->requests();
+	}
+	else if (BrokerClient* client = conn->brokerClient(); client != nullptr) {
+		lost = client->lost();
+	}
+	else {
+		return false;
+	}
+	if (messages != nullptr) {
+		*messages = published;
+	}
+	if (dropped != nullptr) {
+		*dropped = lost;
+	}
+	if (requests != nullptr) {
+		*requests = sent;
+	}
+	return true;
 }
 
 /*
@@ -456,28 +2663,9 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraft(HANDLE handle, const
 		return FALSE;
 	}
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AICreateEnrouteATCAircraft(handle, title, tailNumber, flightNumber, flightPlanPath, flightPlanPosition, touchAndGo, requestId), "AICreateEnrouteATCAircraft");
-}
-
-#if IS_PREPAR3D
-
-CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, int flightNumber, const wchar_t* flightPlanPath, double flightPlanPosition, uint32_t touchAndGo, uint32_t requestId)
-{
-	initLog();
-
-	logger.info(std::format("CsAICreateEnrouteATCAircraft(..., '{}', '{}', {}, '{}', {}, {})", title, tailNumber, flightNumber, flightPlanPath, flightPlanPosition, requestId));
-	if (handle == nullptr) {
-		logger.error("Handle passed to CsAICreateEnrouteATCAircraft is null!");
-		return FALSE;
-	}
-
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AICreateEnrouteATCAircraftW(handle, title, tailNumber, flightNumber, flightPlanPath, flightPlanPosition, touchAndGo, requestId), "AICreateEnrouteATCAircraft");
+	return submitRequest(handle, Request{ RequestOp::AICreateEnrouteATCAircraft, { uint32_t(flightNumber), touchAndGo, requestId }, { title, tailNumber, flightPlanPath }, { &flightPlanPosition, sizeof(flightPlanPosition) } });
 }
 
-#endif
-
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateNonATCAircraft(HANDLE handle, const char* title, const char* tailNumber, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId)
 {
 	initLog();
@@ -498,8 +2686,7 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateNonATCAircraft(HANDLE handle, const char
 	initPos.OnGround = onGround;
 	initPos.Airspeed = airspeed;
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AICreateNonATCAircraft(handle, title, tailNumber, initPos, requestId), "AICreateNonATCAircraft");
+	return submitRequest(handle, Request{ RequestOp::AICreateNonATCAircraft, { requestId }, { title, tailNumber }, { &initPos, sizeof(initPos) } });
 }
 
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateParkedATCAircraft(HANDLE handle, const char* title, const char* tailNumber, const char* airportId, uint32_t requestId)
@@ -512,8 +2699,7 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateParkedATCAircraft(HANDLE handle, const c
 		return FALSE;
 	}
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AICreateParkedATCAircraft(handle, title, tailNumber, airportId, requestId), "AICreateParkedATCAircraft");
+	return submitRequest(handle, Request{ RequestOp::AICreateParkedATCAircraft, { requestId }, { title, tailNumber, airportId } });
 }
 
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateSimulatedObject(HANDLE handle, const char* title, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId)
@@ -536,8 +2722,7 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateSimulatedObject(HANDLE handle, const cha
 	initPos.OnGround = onGround;
 	initPos.Airspeed = airspeed;
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AICreateSimulatedObject(handle, title, initPos, requestId), "AICreateSimulatedObject");
+	return submitRequest(handle, Request{ RequestOp::AICreateSimulatedObject, { requestId }, { title }, { &initPos, sizeof(initPos) } });
 }
 
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAIRemoveObject(HANDLE handle, uint32_t objectId, uint32_t requestId)
@@ -550,6 +2735,121 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsAIRemoveObject(HANDLE handle, uint32_t objectId,
 		return FALSE;
 	}
 
-	std::unique_lock<std::mutex> scLock(scMutex);
-	return fetchSendId(handle, SimConnect_AIRemoveObject(handle, objectId, requestId), "AIRemoveObject");
-}
\ No newline at end of file
+	return submitRequest(handle, Request{ RequestOp::AIRemoveObject, { objectId, requestId } });
+}
+
+/*
+ * UTF-16 variants: the strings are converted here, so a managed caller can pass them pinned instead of having an ANSI
+ * copy made for every call.
+ */
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectW(const wchar_t* appName, HANDLE& handle)
+{
+	return CsConnect(NarrowString(appName), handle);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectWithEventW(const wchar_t* appName, HANDLE& handle)
+{
+	return CsConnectWithEvent(NarrowString(appName), handle);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectPoolW(const wchar_t* appName, uint32_t shardCount, HANDLE& pool)
+{
+	return CsConnectPool(NarrowString(appName), shardCount, pool);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartBrokerW(HANDLE handle, const wchar_t* name, uint32_t slotCount, uint32_t slotSize)
+{
+	return CsStartBroker(handle, NarrowString(name), slotCount, slotSize);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectBrokerW(const wchar_t* name, HANDLE& handle)
+{
+	return CsConnectBroker(NarrowString(name), handle);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientEventToSimEventW(HANDLE handle, uint32_t eventId, const wchar_t* eventName)
+{
+	return CsMapClientEventToSimEvent(handle, eventId, NarrowString(eventName));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapInputEventToClientEventW(HANDLE handle, uint32_t groupId, const wchar_t* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable)
+{
+	return CsMapInputEventToClientEvent(handle, groupId, NarrowString(inputDefinition), downEventId, downValue, upEventId, upValue, maskable);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternClientEventW(HANDLE handle, const wchar_t* eventName, uint32_t proposedId, uint32_t* eventId)
+{
+	return CsInternClientEvent(handle, NarrowString(eventName), proposedId, eventId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternInputEventW(HANDLE handle, uint32_t groupId, const wchar_t* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable,
+	uint32_t* mappedDownEventId, uint32_t* mappedUpEventId)
+{
+	return CsInternInputEvent(handle, groupId, NarrowString(inputDefinition), downEventId, downValue, upEventId, upValue, maskable, mappedDownEventId, mappedUpEventId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsLookupClientEventsW(HANDLE handle, const wchar_t* const* eventNames, uint32_t count, int64_t* eventIds)
+{
+	if (eventNames == nullptr) {
+		return CsLookupClientEvents(handle, nullptr, count, eventIds);
+	}
+	// Kept per thread, so the strings keep their capacity between calls.
+	thread_local std::vector<std::string> names;
+	thread_local std::vector<const char*> pointers;
+	if (names.size() < count) {
+		names.resize(count);
+	}
+	pointers.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		NarrowString::convert(eventNames[i], names[i]);
+		pointers[i] = (eventNames[i] != nullptr) ? names[i].c_str() : nullptr;
+	}
+	return CsLookupClientEvents(handle, pointers.data(), count, eventIds);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientDataNameToIDW(HANDLE handle, const wchar_t* clientDataName, uint32_t clientDataId)
+{
+	return CsMapClientDataNameToID(handle, NarrowString(clientDataName), clientDataId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSubscribeToSystemEventW(HANDLE handle, int id, const wchar_t* eventName)
+{
+	return CsSubscribeToSystemEvent(handle, id, NarrowString(eventName));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateW(HANDLE handle, int id, const wchar_t* eventName)
+{
+	return CsRequestSystemState(handle, id, NarrowString(eventName));
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateAsyncW(HANDLE handle, uint32_t requestId, const wchar_t* stateName, TicketProc callback)
+{
+	return CsRequestSystemStateAsync(handle, requestId, NarrowString(stateName), callback);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToDataDefinitionW(HANDLE handle, uint32_t defId, const wchar_t* datumName, const wchar_t* unitsName, uint32_t datumType, float epsilon, uint32_t datumId)
+{
+	return CsAddToDataDefinition(handle, defId, NarrowString(datumName), NarrowString(unitsName), datumType, epsilon, datumId);
+}
+
+// Prepar3D has this call natively, but it is queued and forwarded like the other variants.
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, int flightNumber, const wchar_t* flightPlanPath, double flightPlanPosition, uint32_t touchAndGo, uint32_t requestId)
+{
+	return CsAICreateEnrouteATCAircraft(handle, NarrowString(title), NarrowString(tailNumber), flightNumber, NarrowString(flightPlanPath), flightPlanPosition, touchAndGo, requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateNonATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId)
+{
+	return CsAICreateNonATCAircraft(handle, NarrowString(title), NarrowString(tailNumber), pos, pbh, onGround, airspeed, requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateParkedATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, const wchar_t* airportId, uint32_t requestId)
+{
+	return CsAICreateParkedATCAircraft(handle, NarrowString(title), NarrowString(tailNumber), NarrowString(airportId), requestId);
+}
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateSimulatedObjectW(HANDLE handle, const wchar_t* title, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId)
+{
+	return CsAICreateSimulatedObject(handle, NarrowString(title), pos, pbh, onGround, airspeed, requestId);
+}
@@ -34,21 +34,80 @@
 #define CS_SIMCONNECT_DLL_EXPORT_LONG	extern "C" __declspec(dllexport) int64_t
 #define CS_SIMCONNECT_DLL_EXPORT_BOOL	extern "C" __declspec(dllexport) bool
 
+// Returned instead of a SendID when a write was skipped because it would not change anything. It cannot be a SendID,
+// which is a 32-bit value.
+#define CS_RESULT_SUPPRESSED	0x100000000LL
+
+// Every message logged, at any level, is also kept in memory: the last 256 per thread. When an error is logged, or on
+// CsDumpLogRing, the records not dumped before are written to the log first, oldest first. The ring is on by default.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetLogRingEnabled(uint32_t enabled);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsDumpLogRing();
+// Each place that logs a WARN or higher may write "burst" messages at once, and after that "messagesPerSecond". Messages
+// over the limit are counted and summarized before the next one written. Defaults to 50 and 10; a rate of 0 turns it off.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetLogRateLimit(double messagesPerSecond, uint32_t burst);
+
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnect(const char* appName, HANDLE& handle);
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisconnect(HANDLE handle);
+// Reopen a connection made with CsConnect and replay all registrations still in effect on it. If it cannot be
+// reopened, the connection is closed and the handle set to null.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReconnect(HANDLE& handle);
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsCallDispatch(HANDLE handle, DispatchProc callback);
 CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetNextDispatch(HANDLE handle, DispatchProc callback);
+// Connections opened with CsConnectWithEvent can block in CsWaitForDispatch until messages arrive, which are then all
+// dispatched. Returns the number of messages, 0 on timeout. CsWakeDispatch makes a waiting call return early.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectWithEvent(const char* appName, HANDLE& handle);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsWaitForDispatch(HANDLE handle, uint32_t timeoutMs, DispatchProc callback);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsWakeDispatch(HANDLE handle);
+// Waiting for messages spins for spinMicros, then yields for yieldMicros, and only then blocks. A dispatch thread
+// receives for the connection on its own, pinned to the given CPUs and at the given relative priority.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetDispatchThreadAffinity(HANDLE handle, uint64_t affinityMask, int32_t priority);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetDispatchWaitStrategy(HANDLE handle, uint32_t spinMicros, uint32_t yieldMicros);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartDispatchThread(HANDLE handle, DispatchProc callback);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopDispatchThread(HANDLE handle);
+// Fetch up to "maxMessages" messages at once. They are copied into memory held by the connection, and stay valid
+// until CsReleaseDispatchBatch, which recycles all of them. The statistics show whether copying still allocates.
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDispatchBatch(HANDLE handle, uint32_t maxMessages, SIMCONNECT_RECV** messages, DWORD* sizes);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReleaseDispatchBatch(HANDLE handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetDispatchBatchStatistics(HANDLE handle, uint64_t* heapAllocations, uint64_t* copies, uint64_t* reservedBytes);
 
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAddClientEventToNotificationGroup(HANDLE handle, uint32_t groupId, uint32_t eventId, uint32_t maskable);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientEventToSimEvent(HANDLE handle, uint32_t eventId, const char* eventName);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsMapInputEventToClientEvent(HANDLE handle, uint32_t groupId, const char* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable);
+// Interned versions of the two calls above: if the name is already mapped on the connection, its existing client
+// event ids are returned through the pointers and nothing is sent. Otherwise the proposed ids are mapped.
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternClientEvent(HANDLE handle, const char* eventName, uint32_t proposedId, uint32_t* eventId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternInputEvent(HANDLE handle, uint32_t groupId, const char* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable,
+												 uint32_t* mappedDownEventId, uint32_t* mappedUpEventId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsLookupClientEvents(HANDLE handle, const char* const* eventNames, uint32_t count, int64_t* eventIds);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsRemoveClientEvent(HANDLE handle, uint32_t groupId, uint32_t eventId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent(HANDLE handle, uint32_t objectId, uint32_t eventId, uint32_t data, uint32_t groupId, uint32_t flags);
 
+// Coalesced client events only keep their latest value per target object, which is sent at the configured rate (at most
+// 1000 Hz) and/or on every frame event.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetEventCoalescing(HANDLE handle, uint32_t eventId, uint32_t enabled);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetCoalescingFlush(HANDLE handle, uint32_t rateHz, uint32_t onFrame);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsFlushCoalescedEvents(HANDLE handle);
+
 #if IS_PREPAR3D
 CS_SIMCONNECT_DLL_EXPORT_LONG CsTransmitClientEvent64(HANDLE handle, uint32_t objectId, uint32_t eventId, uint64_t data, uint32_t groupId, uint32_t flags);
 #endif
 
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToClientDataDefinition(HANDLE handle, uint32_t defId, DWORD offset, int32_t sizeOrType, float epsilon, DWORD datumId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsCreateClientData(HANDLE handle, uint32_t clientDataId, DWORD size, uint32_t flags);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientDataNameToID(HANDLE handle, const char* clientDataName, uint32_t clientDataId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestClientData(HANDLE handle, uint32_t clientDataId, uint32_t requestId, uint32_t defineId, uint32_t period, uint32_t flags, DWORD origin, DWORD interval, DWORD limit);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetClientData(HANDLE handle, uint32_t clientDataId, uint32_t defineId, DWORD flags, DWORD unitSize, void* dataSet);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsClearClientDataDefinition(HANDLE handle, uint32_t clientDataId);
+
+// A client data channel mirrors a client data area natively, split into ranges that get consecutive client data
+// definitions starting at firstDefId. Write into the buffer in place; a commit sends only the ranges that changed.
+// Received data is copied into the buffer by a refresh or commit, so only on the thread that writes it.
+CS_SIMCONNECT_DLL_EXPORT_LONG CsOpenClientDataChannel(HANDLE handle, uint32_t clientDataId, uint32_t size, uint32_t rangeSize, uint32_t firstDefId, uint32_t create);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetClientDataChannelBuffer(HANDLE handle, uint32_t clientDataId, void** buffer);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRefreshClientDataChannel(HANDLE handle, uint32_t clientDataId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsCommitClientDataChannel(HANDLE handle, uint32_t clientDataId);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsCloseClientDataChannel(HANDLE handle, uint32_t clientDataId);
+
 CS_SIMCONNECT_DLL_EXPORT_LONG CsClearNotificationGroup(HANDLE handle, uint32_t groupId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestNotificationGroup(HANDLE handle, uint32_t groupId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsSetNotificationGroupPriority(HANDLE handle, uint32_t groupId, uint32_t priority);
@@ -58,16 +117,231 @@ CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemState(HANDLE handle, int id, const
 
 CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObject(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t period, uint32_t dataRequestFlags,
 													   DWORD origin, DWORD interval, DWORD limit);
+// One-shot requests return a ticket (> 1), completed by dispatch when the reply with their requestId arrives, or
+// failed by an exception for their SendID. The reply is the full message. With a callback, it is called from dispatch
+// and the ticket is released afterwards; otherwise poll or wait, then copy the reply and release the ticket. A queued
+// request gets its SendID when the scheduler sends it; if that fails, or it is dropped, the ticket fails without a
+// reply (the callback gets a null message). Tickets of a broker client have no SendID, so they can only complete.
+#define CS_TICKET_UNKNOWN	0
+#define CS_TICKET_PENDING	1
+#define CS_TICKET_COMPLETED	2
+#define CS_TICKET_FAILED	3
+
+typedef void (*TicketProc)(int64_t ticket, SIMCONNECT_RECV* pData, DWORD cbData);
+
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateAsync(HANDLE handle, uint32_t requestId, const char* stateName, TicketProc callback);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObjectOnce(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t dataRequestFlags, TicketProc callback);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTicketState(HANDLE handle, int64_t ticket);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsWaitForTicket(HANDLE handle, int64_t ticket, uint32_t timeoutMs);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTicketReply(HANDLE handle, int64_t ticket, void* buffer, uint32_t size);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReleaseTicket(HANDLE handle, int64_t ticket);
+
 CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestDataOnSimObjectType(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t radius, uint32_t objectType);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsSetDataOnSimObject(HANDLE handle, uint32_t defId, uint32_t objectId, uint32_t flags, uint32_t count, uint32_t unitSize, void* data);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToDataDefinition(HANDLE handle, uint32_t defId, const char* datumName, const char* UnitsName, uint32_t datumType, float epsilon, uint32_t datumId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsClearDataDefinition(HANDLE handle, uint32_t defineId);
 
+// Submit a binary manifest of registration calls under a single lock. See src/Requests.h for the record format. With
+// scheduling enabled, the calls already queued are sent first, and the manifest is then sent directly.
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRegisterManifest(HANDLE handle, const void* manifest, uint32_t size, int64_t* results, uint32_t capacity);
+
+// With scheduling enabled, calls on the connection are queued per priority class and sent by a background thread,
+// highest class first and within each class's rate limit. Queued calls return 1, as their SendID is not known yet.
+// A call never overtakes an earlier registration of the definition, client data or event id it uses.
+#define CS_PRIORITY_REALTIME	0
+#define CS_PRIORITY_NORMAL		1
+#define CS_PRIORITY_BULK		2
+#define CS_PRIORITY_DEFAULT		0xFFFFFFFF
+
+struct CsSchedulerStatistics {
+	uint64_t submitted;
+	uint64_t sent;
+	uint64_t failed;
+	uint64_t queued;
+	uint64_t maxWaitMicros;
+	uint64_t totalWaitMicros;
+};
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetScheduling(HANDLE handle, uint32_t enabled);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetSchedulerRateLimit(HANDLE handle, uint32_t priority, double requestsPerSecond, uint32_t burst);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetThreadRequestPriority(uint32_t priority);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetSchedulerStatistics(HANDLE handle, uint32_t priority, CsSchedulerStatistics* stats);
+
+// Data definitions registered through CsAddToDataDefinition are compiled into a native layout, which can be used
+// to move data between that layout and columnar arrays (one array per datum, one element per object).
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDataDefinitionSize(HANDLE handle, uint32_t defId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetDataDefinitionLayout(HANDLE handle, uint32_t defId, uint32_t* datumTypes, uint32_t* sizes, uint32_t* offsets, uint32_t capacity);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPackDataDefinition(HANDLE handle, uint32_t defId, uint32_t count, const void* const* columns, void* buffer, uint32_t bufferSize);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsUnpackDataDefinition(HANDLE handle, uint32_t defId, uint32_t count, const void* buffer, uint32_t bufferSize, void* const* columns, uint32_t firstRow);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSetDataOnSimObjects(HANDLE handle, uint32_t defId, uint32_t count, const uint32_t* objectIds, uint32_t flags, const void* const* columns, int64_t* results);
+
+// With write suppression, CsSetDataOnSimObject(s) and CsSetClientData skip payloads equal to the last one sent for the
+// same (defId, objectId) or (clientDataId, defineId), returning CS_RESULT_SUPPRESSED. Numeric datums of an untagged
+// data definition count as equal within their epsilon.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetWriteSuppression(HANDLE handle, uint32_t enabled);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetSuppressedWriteCount(HANDLE handle);
+
+// With request sharing enabled, CsRequestDataOnSimObject calls for the same datums and request parameters as one already
+// sent (untagged and periodic) only subscribe to it. Received data is copied to every subscriber, with its own
+// requestId and defId.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsSetRequestSharing(HANDLE handle, uint32_t enabled);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetRequestSharingStatistics(HANDLE handle, uint32_t* sharedRequests, uint32_t* subscribers);
+
+// Keep the last "capacity" untagged rows received for a data request, one column of doubles per datum of the (fixed
+// size) definition. Times are microseconds on the clock returned by CsGetHistoryClock.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableHistory(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t capacity);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableHistory(HANDLE handle, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetHistoryClock();
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReadHistory(HANDLE handle, uint32_t requestId, int64_t fromMicros, int64_t toMicros, uint32_t maxCount, int64_t* times, double** columns);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetHistoryValueAt(HANDLE handle, uint32_t requestId, uint32_t datum, int64_t timeMicros, double* value);
+
+// Track the objects reported by a data request (typically CsRequestDataOnSimObjectType), using the given datums of the
+// definition as latitude, longitude, altitude and heading. Positions are estimated for any time on CsGetHistoryClock,
+// interpolated between the last two reports or extrapolated for at most maxExtrapolationMs after the last one.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableTracking(HANDLE handle, uint32_t requestId, uint32_t defId, uint32_t latDatum, uint32_t lonDatum, uint32_t altDatum, uint32_t headingDatum,
+											   uint32_t maxExtrapolationMs, uint32_t expiryMs);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableTracking(HANDLE handle, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetTrackedPositions(HANDLE handle, uint32_t requestId, int64_t timeMicros, uint32_t capacity, uint32_t* objectIds,
+													double* latitudes, double* longitudes, double* altitudes, double* headings);
+
+// Let the interval of a periodic data request follow its consumer. Every windowMs the time spent in the callback for
+// its messages, as a fraction of the window, is compared with highLoad and lowLoad, and the largest depth reported
+// with CsReportConsumerLag with maxDepth. After "hold" windows in a row over the limits, the interval is doubled; after
+// as many under them, it is halved. The request is then sent again, once SimConnect is free, and the change recorded
+// with its time on the CsGetHistoryClock clock. A request that receives copies of a shared request cannot be controlled,
+// and the carrier of one leaves it. With frame aggregation, only the depth reported with CsReportConsumerLag counts.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableRateControl(HANDLE handle, uint32_t requestId, uint32_t minInterval, uint32_t maxInterval, uint32_t windowMs, uint32_t hold,
+												  double highLoad, double lowLoad, uint32_t maxDepth);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableRateControl(HANDLE handle, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsReportConsumerLag(HANDLE handle, uint32_t requestId, uint32_t queueDepth);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRateHistory(HANDLE handle, uint32_t requestId, uint32_t capacity, int64_t* times, uint32_t* intervals);
+
+// The arrival monitor keeps, per data request, the number of messages received, the time of the last one on the
+// CsGetHistoryClock clock, a histogram of the time between them, and the number of periods that passed without one.
+// Periods are expected from the request: in seconds times (interval + 1), or learned from the arrivals for frames.
+// Requests only sent on change have no period. CsGetArrivalStatistics copies the statistics of all requests at once.
+#define CS_ARRIVAL_SIMOBJECT_DATA	0
+#define CS_ARRIVAL_CLIENT_DATA		1
+#define CS_ARRIVAL_BUCKETS			24		// Bucket i counts gaps below 2^i microseconds, down to half that
+
+struct CsArrivalStatistics {
+	uint32_t requestId;
+	uint32_t kind;
+	uint64_t count;
+	int64_t lastArrivalMicros;
+	int64_t periodMicros;
+	uint64_t missedPeriods;
+	uint64_t histogram[CS_ARRIVAL_BUCKETS];
+};
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableArrivalMonitor(HANDLE handle, uint32_t capacity);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableArrivalMonitor(HANDLE handle);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetArrivalStatistics(HANDLE handle, CsArrivalStatistics* stats, uint32_t capacity);
+
+// With frame aggregation, data messages (SIMOBJECT_DATA, SIMOBJECT_DATA_BYTYPE and CLIENT_DATA) are held until the
+// frame event with the given client event id arrives; subscribe to the "Frame" system event for it. That event is
+// then replaced by a single message with dwID CS_RECV_ID_FRAME: a CsFrameHeader, "count" directory entries, and the
+// original messages, each at its entry's offset from the start of the record. A frame that would grow beyond
+// maxFrameSize is passed on early, flagged CS_FRAME_FLAG_PARTIAL. Records are valid for the duration of the callback.
+#define CS_RECV_ID_FRAME		0x10000
+#define CS_FRAME_FLAG_PARTIAL	1
+
+struct CsFrameHeader {
+	DWORD dwSize;
+	DWORD dwVersion;
+	DWORD dwID;
+	uint32_t frameNumber;
+	float frameRate;
+	float simSpeed;
+	uint32_t count;
+	uint32_t flags;
+};
+
+struct CsFrameEntry {
+	uint32_t id;
+	uint32_t requestId;
+	uint32_t offset;
+	uint32_t size;
+};
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsEnableFrameAggregation(HANDLE handle, uint32_t frameEventId, uint32_t maxFrameSize);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisableFrameAggregation(HANDLE handle);
+
+// Record the untagged rows of selected data requests to a file, for analysis afterwards. Rows are copied on the
+// dispatch thread and written in compressed chunks by a background thread; if it falls behind by more than 16MB, rows
+// are dropped and counted. Times are on the CsGetHistoryClock clock; CsGetRecordingEpoch gives the wall clock time
+// (Unix microseconds) at its zero. CsStopRecorder writes the chunk index; a recording without one is read by walking
+// the file. CsReadRecording fills the (optional) times and objectIds, and per datum a column with its raw values,
+// as with CsUnpackDataDefinition; CsGetRecordingLayout gives the datum types and sizes.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartRecorder(HANDLE handle, const char* path);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsRecordRequest(HANDLE handle, uint32_t requestId, uint32_t defId);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopRecorder(HANDLE handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetRecorderStatistics(HANDLE handle, uint64_t* rows, uint64_t* dropped, uint64_t* bytes);
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsOpenRecording(const char* path, HANDLE& recording);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsCloseRecording(HANDLE recording);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingEpoch(HANDLE recording);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingStreams(HANDLE recording, uint32_t* requestIds, uint32_t capacity);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsGetRecordingLayout(HANDLE recording, uint32_t requestId, uint32_t* datumTypes, uint32_t* sizes, uint32_t capacity);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsReadRecording(HANDLE recording, uint32_t requestId, int64_t fromMicros, int64_t toMicros, uint32_t maxCount,
+											  int64_t* times, uint32_t* objectIds, void* const* columns);
+
+// A pool opens several connections ("shards") with an event each. Data requests made through the pool go to the
+// shard assigned to their requestId, else the one assigned to their class, else one picked by hash among the shards
+// without assignments. Data definitions registered on the first shard are copied to other shards when a request needs
+// them. Each shard has its own receive thread, all calling the same callback. Use CsGetPoolShard for anything else,
+// such as affinities or other requests.
+#define CS_POOL_CLASS_OBJECT		0	// CsPoolRequestDataOnSimObject
+#define CS_POOL_CLASS_OBJECT_TYPE	1	// CsPoolRequestDataOnSimObjectType
+
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectPool(const char* appName, uint32_t shardCount, HANDLE& pool);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsDisconnectPool(HANDLE pool);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetPoolShard(HANDLE pool, uint32_t index, HANDLE& shard);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsAssignPoolRequests(HANDLE pool, uint32_t firstRequestId, uint32_t lastRequestId, uint32_t shard);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsAssignPoolClass(HANDLE pool, uint32_t requestClass, uint32_t shard);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetPoolShardForRequest(HANDLE pool, uint32_t requestId, uint32_t requestClass, HANDLE& shard);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPoolRequestDataOnSimObject(HANDLE pool, uint32_t requestId, uint32_t defId, uint32_t objectId, uint32_t period, uint32_t dataRequestFlags,
+														   DWORD origin, DWORD interval, DWORD limit);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsPoolRequestDataOnSimObjectType(HANDLE pool, uint32_t requestId, uint32_t defId, uint32_t radius, uint32_t objectType);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartPoolDispatch(HANDLE pool, DispatchProc callback);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopPoolDispatch(HANDLE pool);
+
+// A broker shares a connection with other processes on this machine, through shared memory with the given name.
+// Clients get a handle from CsConnectBroker that works with the other calls, but their requests are performed by
+// the owner's broker thread, so they return 1 instead of a SendID. Every client sees all messages received by the
+// owner from the moment it connected, so processes must use distinct ids. Clients poll with CsGetNextDispatch,
+// CsCallDispatch or CsGetDispatchBatch. Statistics: for the owner, messages published, messages too large for a slot
+// and requests performed; for a client, only the messages it lost by falling a full ring behind.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartBroker(HANDLE handle, const char* name, uint32_t slotCount, uint32_t slotSize);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStopBroker(HANDLE handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectBroker(const char* name, HANDLE& handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsGetBrokerStatistics(HANDLE handle, uint64_t* messages, uint64_t* dropped, uint64_t* requests);
+
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraft(HANDLE handle, const char* title, const char* tailNumber, int flightNumber, const char* flightPlanPath, double flightPlanPosition, uint32_t touchAndGo, uint32_t requestId);
-#if IS_PREPAR3D
-CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, int flightNumber, const wchar_t* flightPlanPath, double flightPlanPosition, uint32_t touchAndGo, uint32_t requestId);
-#endif
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateNonATCAircraft(HANDLE handle, const char* title, const char* tailNumber, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateParkedATCAircraft(HANDLE handle, const char* title, const char* tailNumber, const char* airportId, uint32_t requestId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateSimulatedObject(HANDLE handle, const char* title, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId);
 CS_SIMCONNECT_DLL_EXPORT_LONG CsAIRemoveObject(HANDLE handle, uint32_t objectId, uint32_t requestId);
+
+// UTF-16 variants of the calls taking names, so managed callers can pass strings pinned. They are converted on the
+// native side (to the ANSI code page, as marshalling would) without allocating for names under 64 characters.
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectW(const wchar_t* appName, HANDLE& handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectWithEventW(const wchar_t* appName, HANDLE& handle);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectPoolW(const wchar_t* appName, uint32_t shardCount, HANDLE& pool);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsStartBrokerW(HANDLE handle, const wchar_t* name, uint32_t slotCount, uint32_t slotSize);
+CS_SIMCONNECT_DLL_EXPORT_BOOL CsConnectBrokerW(const wchar_t* name, HANDLE& handle);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientEventToSimEventW(HANDLE handle, uint32_t eventId, const wchar_t* eventName);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapInputEventToClientEventW(HANDLE handle, uint32_t groupId, const wchar_t* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternClientEventW(HANDLE handle, const wchar_t* eventName, uint32_t proposedId, uint32_t* eventId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsInternInputEventW(HANDLE handle, uint32_t groupId, const wchar_t* inputDefinition, uint32_t downEventId, DWORD downValue, uint32_t upEventId, DWORD upValue, uint32_t maskable,
+												  uint32_t* mappedDownEventId, uint32_t* mappedUpEventId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsLookupClientEventsW(HANDLE handle, const wchar_t* const* eventNames, uint32_t count, int64_t* eventIds);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsMapClientDataNameToIDW(HANDLE handle, const wchar_t* clientDataName, uint32_t clientDataId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsSubscribeToSystemEventW(HANDLE handle, int id, const wchar_t* eventName);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateW(HANDLE handle, int id, const wchar_t* eventName);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsRequestSystemStateAsyncW(HANDLE handle, uint32_t requestId, const wchar_t* stateName, TicketProc callback);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAddToDataDefinitionW(HANDLE handle, uint32_t defId, const wchar_t* datumName, const wchar_t* unitsName, uint32_t datumType, float epsilon, uint32_t datumId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateEnrouteATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, int flightNumber, const wchar_t* flightPlanPath, double flightPlanPosition, uint32_t touchAndGo, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateNonATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateParkedATCAircraftW(HANDLE handle, const wchar_t* title, const wchar_t* tailNumber, const wchar_t* airportId, uint32_t requestId);
+CS_SIMCONNECT_DLL_EXPORT_LONG CsAICreateSimulatedObjectW(HANDLE handle, const wchar_t* title, SIMCONNECT_DATA_LATLONALT* pos, SIMCONNECT_DATA_XYZ* pbh, uint32_t onGround, uint32_t airspeed, uint32_t requestId);
@@ -0,0 +1,143 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <mutex>
+
+#include "DataSchema.h"
+
+using namespace nl::rakis::interop;
+
+
+/*static*/ uint32_t DataSchema::datumSize(uint32_t datumType)
+{
+	switch (datumType) {
+	case SIMCONNECT_DATATYPE_INT32:			return 4;
+	case SIMCONNECT_DATATYPE_INT64:			return 8;
+	case SIMCONNECT_DATATYPE_FLOAT32:		return 4;
+	case SIMCONNECT_DATATYPE_FLOAT64:		return 8;
+	case SIMCONNECT_DATATYPE_STRING8:		return 8;
+	case SIMCONNECT_DATATYPE_STRING32:		return 32;
+	case SIMCONNECT_DATATYPE_STRING64:		return 64;
+	case SIMCONNECT_DATATYPE_STRING128:		return 128;
+	case SIMCONNECT_DATATYPE_STRING256:		return 256;
+	case SIMCONNECT_DATATYPE_STRING260:		return 260;
+	case SIMCONNECT_DATATYPE_INITPOSITION:	return sizeof(SIMCONNECT_DATA_INITPOSITION);
+	case SIMCONNECT_DATATYPE_MARKERSTATE:	return sizeof(SIMCONNECT_DATA_MARKERSTATE);
+	case SIMCONNECT_DATATYPE_WAYPOINT:		return sizeof(SIMCONNECT_DATA_WAYPOINT);
+	case SIMCONNECT_DATATYPE_LATLONALT:		return sizeof(SIMCONNECT_DATA_LATLONALT);
+	case SIMCONNECT_DATATYPE_XYZ:			return sizeof(SIMCONNECT_DATA_XYZ);
+	default:								return 0;	// SIMCONNECT_DATATYPE_STRINGV and anything we don't know
+	}
+}
+
+/*static*/ double DataSchema::toDouble(const DataField& field, const void* row)
+{
+	const uint8_t* p{ static_cast<const uint8_t*>(row) + field.offset };
+	switch (field.datumType) {
+	case SIMCONNECT_DATATYPE_INT32:		{ int32_t v; std::memcpy(&v, p, sizeof(v)); return double(v); }
+	case SIMCONNECT_DATATYPE_INT64:		{ int64_t v; std::memcpy(&v, p, sizeof(v)); return double(v); }
+	case SIMCONNECT_DATATYPE_FLOAT32:	{ float v; std::memcpy(&v, p, sizeof(v)); return double(v); }
+	case SIMCONNECT_DATATYPE_FLOAT64:	{ double v; std::memcpy(&v, p, sizeof(v)); return v; }
+	default:							return std::numeric_limits<double>::quiet_NaN();
+	}
+}
+
+void DataSchema::add(const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId)
+{
+	uint32_t size{ datumSize(datumType) };
+
+	fields_.push_back(DataField{
+		(datumName != nullptr) ? datumName : "",
+		(unitsName != nullptr) ? unitsName : "",
+		datumType, epsilon, datumId, size, size_ });
+	if (size == 0) {
+		fixedSize_ = false;
+	}
+	size_ += size;
+}
+
+void DataSchema::pack(uint32_t count, const void* const* columns, void* rows) const
+{
+	auto out{ static_cast<uint8_t*>(rows) };
+
+	for (size_t i = 0; i < fields_.size(); i++) {
+		const auto& field{ fields_[i] };
+		auto in{ static_cast<const uint8_t*>(columns[i]) };
+
+		for (uint32_t row = 0; row < count; row++) {
+			std::memcpy(out + row * size_ + field.offset, in + row * field.size, field.size);
+		}
+	}
+}
+
+void DataSchema::unpack(uint32_t count, const void* rows, void* const* columns, uint32_t firstRow) const
+{
+	auto in{ static_cast<const uint8_t*>(rows) };
+
+	for (size_t i = 0; i < fields_.size(); i++) {
+		const auto& field{ fields_[i] };
+		auto out{ static_cast<uint8_t*>(columns[i]) + firstRow * field.size };
+
+		for (uint32_t row = 0; row < count; row++) {
+			std::memcpy(out + row * field.size, in + row * size_ + field.offset, field.size);
+		}
+	}
+}
+
+void DataSchema::packRow(uint32_t row, const void* const* columns, void* data) const
+{
+	auto out{ static_cast<uint8_t*>(data) };
+
+	for (size_t i = 0; i < fields_.size(); i++) {
+		const auto& field{ fields_[i] };
+		std::memcpy(out + field.offset, static_cast<const uint8_t*>(columns[i]) + row * field.size, field.size);
+	}
+}
+
+
+void DataSchemas::add(uint32_t defId, const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	auto& current{ schemas_[defId] };
+	auto schema{ (current != nullptr) ? std::make_shared<DataSchema>(*current) : std::make_shared<DataSchema>() };
+	schema->add(datumName, unitsName, datumType, epsilon, datumId);
+	current = schema;
+}
+
+void DataSchemas::clear(uint32_t defId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	schemas_.erase(defId);
+}
+
+void DataSchemas::clear()
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	schemas_.clear();
+}
+
+std::shared_ptr<const DataSchema> DataSchemas::find(uint32_t defId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	auto it{ schemas_.find(defId) };
+	return (it != schemas_.end()) ? it->second : nullptr;
+}
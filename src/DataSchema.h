@@ -0,0 +1,113 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <shared_mutex>
+
+#include "framework.h"
+#include <SimConnect.h>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * A single datum as registered through AddToDataDefinition, with its position in the default (untagged) layout.
+	 */
+	struct DataField {
+		std::string datumName;
+		std::string unitsName;
+		uint32_t datumType;
+		float epsilon;
+		uint32_t datumId;
+		uint32_t size;
+		uint32_t offset;
+
+		bool operator==(const DataField& other) const = default;
+	};
+
+	/*
+	 * The compiled layout of a data definition. Instances are immutable once published, so they can be shared
+	 * between threads without locking.
+	 */
+	class DataSchema {
+		std::vector<DataField> fields_;
+		uint32_t size_{ 0 };
+		bool fixedSize_{ true };
+
+	public:
+		DataSchema() = default;
+		DataSchema(const DataSchema& schema) = default;
+		DataSchema(DataSchema&& schema) = default;
+		~DataSchema() = default;
+
+		DataSchema& operator=(const DataSchema& schema) = default;
+		DataSchema& operator=(DataSchema&& schema) = default;
+
+		/*
+		 * Return the size SimConnect uses for a datum of the given type, or 0 if it is variable or unknown.
+		 */
+		static uint32_t datumSize(uint32_t datumType);
+
+		/*
+		 * Read a numeric datum from a row of this layout, or NaN for datums that are not numeric.
+		 */
+		static double toDouble(const DataField& field, const void* row);
+
+		void add(const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId);
+
+		inline const std::vector<DataField>& fields() const { return fields_; }
+		inline uint32_t size() const { return size_; }
+		inline bool isFixedSize() const { return fixedSize_; }
+
+		/*
+		 * Copy "count" objects from per-field column arrays into consecutive rows of this layout.
+		 */
+		void pack(uint32_t count, const void* const* columns, void* rows) const;
+
+		/*
+		 * Copy "count" consecutive rows of this layout into per-field column arrays, starting at "firstRow".
+		 */
+		void unpack(uint32_t count, const void* rows, void* const* columns, uint32_t firstRow) const;
+
+		/*
+		 * Copy a single row, taken from "row" in the columns, into "data".
+		 */
+		void packRow(uint32_t row, const void* const* columns, void* data) const;
+	};
+
+	/*
+	 * The compiled schemas for all data definitions on a single connection.
+	 */
+	class DataSchemas {
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<const DataSchema>> schemas_;
+
+	public:
+		void add(uint32_t defId, const char* datumName, const char* unitsName, uint32_t datumType, float epsilon, uint32_t datumId);
+		void clear(uint32_t defId);
+		void clear();
+
+		std::shared_ptr<const DataSchema> find(uint32_t defId) const;
+	};
+
+}
+}
+}
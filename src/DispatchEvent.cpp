@@ -0,0 +1,47 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DispatchEvent.h"
+
+using namespace nl::rakis::interop;
+
+DispatchEvent::DispatchEvent()
+	: event_(CreateEvent(nullptr, FALSE, FALSE, nullptr))
+{
+}
+
+DispatchEvent::~DispatchEvent()
+{
+	if (event_ != nullptr) {
+		CloseHandle(event_);
+	}
+}
+
+HANDLE DispatchEvent::handle()
+{
+	return event_;
+}
+
+/*static*/ void DispatchEvent::signal(HANDLE handle)
+{
+	SetEvent(handle);
+}
+
+bool DispatchEvent::wait(std::chrono::milliseconds timeout)
+{
+	return WaitForSingleObject(event_, DWORD(timeout.count())) == WAIT_OBJECT_0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+
+#include "framework.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * The auto-reset Win32 event SimConnect signals when it has messages for us.
+	 */
+	class DispatchEvent {
+		HANDLE event_;
+
+	public:
+		DispatchEvent();
+		DispatchEvent(const DispatchEvent&) = delete;
+		DispatchEvent(DispatchEvent&&) = delete;
+		~DispatchEvent();
+		DispatchEvent& operator=(const DispatchEvent&) = delete;
+		DispatchEvent& operator=(DispatchEvent&&) = delete;
+
+		/*
+		 * The handle to pass to SimConnect_Open.
+		 */
+		HANDLE handle();
+
+		/*
+		 * Signal the event behind a handle returned by handle().
+		 */
+		static void signal(HANDLE handle);
+		inline void signal() { signal(handle()); }
+
+		/*
+		 * Returns true if the event was signalled within the timeout, and resets it.
+		 */
+		bool wait(std::chrono::milliseconds timeout);
+	};
+
+}
+}
+}
@@ -0,0 +1,119 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "DispatchLoop.h"
+
+using namespace nl::rakis::interop;
+using Clock = std::chrono::steady_clock;
+
+
+void DispatchLoop::configure(const DispatchSettings& settings)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	settings_ = settings;
+}
+
+DispatchSettings DispatchLoop::settings() const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	return settings_;
+}
+
+size_t DispatchLoop::wait(const Poll& poll, DispatchEvent& event, std::chrono::milliseconds timeout) const
+{
+	size_t count{ 0 };
+	auto drain = [&poll, &count]() {
+		while (poll()) {
+			count++;
+		}
+		return count > 0;
+	};
+	if (drain()) {
+		return count;
+	}
+
+	const DispatchSettings settings{ this->settings() };
+	const auto start{ Clock::now() };
+	const auto deadline{ start + timeout };
+	const auto spinEnd{ std::min(deadline, start + std::chrono::microseconds(settings.spinMicros)) };
+	const auto yieldEnd{ std::min(deadline, spinEnd + std::chrono::microseconds(settings.yieldMicros)) };
+
+	while (Clock::now() < spinEnd) {
+		if (drain()) {
+			return count;
+		}
+	}
+	while (Clock::now() < yieldEnd) {
+		std::this_thread::yield();
+		if (drain()) {
+			return count;
+		}
+	}
+	// A wake-up without messages (from CsWakeDispatch, or a signal left over from messages already taken) returns 0.
+	if (const auto now = Clock::now(); (now < deadline) && event.wait(std::chrono::ceil<std::chrono::milliseconds>(deadline - now))) {
+		drain();
+	}
+	return count;
+}
+
+bool DispatchLoop::start(Poll poll, DispatchEvent& event)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	if (running_.exchange(true)) {
+		return false;
+	}
+	event_ = &event;
+	thread_ = std::thread([this, poll, &event]() {
+		applyToCurrentThread(settings());
+		while (isRunning()) {
+			wait(poll, event, std::chrono::milliseconds(100));
+		}
+	});
+	return true;
+}
+
+bool DispatchLoop::stop()
+{
+	std::thread thread;
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+		if (!running_.exchange(false)) {
+			return false;
+		}
+		event_->signal();
+		thread = std::move(thread_);
+	}
+	if (thread.joinable()) {
+		thread.join();
+	}
+	return true;
+}
+
+/*static*/ bool DispatchLoop::applyToCurrentThread(const DispatchSettings& settings)
+{
+	bool ok{ true };
+	if (settings.affinityMask != 0) {
+		ok = (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(settings.affinityMask)) != 0) && ok;
+	}
+	if (settings.priority != 0) {
+		ok = (SetThreadPriority(GetCurrentThread(), settings.priority) != 0) && ok;
+	}
+	return ok;
+}
@@ -0,0 +1,84 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "DispatchEvent.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	struct DispatchSettings {
+		uint64_t affinityMask{ 0 };		// 0 leaves the affinity alone
+		int32_t priority{ 0 };			// Relative thread priority, as for SetThreadPriority
+		uint32_t spinMicros{ 0 };		// Poll continuously this long before yielding
+		uint32_t yieldMicros{ 0 };		// Then poll between yields this long before blocking
+	};
+
+	/*
+	 * Waits for received messages using a spin, then yield, then block strategy, either on the calling thread or on
+	 * a dedicated receive thread with its own affinity and priority.
+	 */
+	class DispatchLoop {
+	public:
+		// Dispatch one message, returning false if there was none.
+		using Poll = std::function<bool()>;
+
+	private:
+		mutable std::mutex mutex_;
+		DispatchSettings settings_;
+
+		std::thread thread_;
+		std::atomic<bool> running_{ false };
+		DispatchEvent* event_{ nullptr };
+
+	public:
+		DispatchLoop() = default;
+		DispatchLoop(const DispatchLoop&) = delete;
+		DispatchLoop(DispatchLoop&&) = delete;
+		~DispatchLoop() { stop(); }
+		DispatchLoop& operator=(const DispatchLoop&) = delete;
+		DispatchLoop& operator=(DispatchLoop&&) = delete;
+
+		void configure(const DispatchSettings& settings);
+		DispatchSettings settings() const;
+
+		/*
+		 * Dispatch everything that is queued, waiting at most the timeout for the first message. Returns the number
+		 * of messages dispatched.
+		 */
+		size_t wait(const Poll& poll, DispatchEvent& event, std::chrono::milliseconds timeout) const;
+
+		/*
+		 * Run wait() on a dedicated thread until stopped. Returns false if the thread was already running.
+		 */
+		bool start(Poll poll, DispatchEvent& event);
+		bool stop();
+		inline bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+		static bool applyToCurrentThread(const DispatchSettings& settings);
+	};
+
+}
+}
+}
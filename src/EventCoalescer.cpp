@@ -0,0 +1,169 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "EventCoalescer.h"
+
+using namespace nl::rakis::interop;
+
+
+EventCoalescer::Slot* EventCoalescer::find(uint32_t eventId)
+{
+	const uint64_t key{ SLOT_USED | eventId };
+
+	for (size_t i = 0, index = eventId % CAPACITY; i < CAPACITY; i++, index = (index + 1) % CAPACITY) {
+		uint64_t slotKey{ slots_[index].key.load(std::memory_order_acquire) };
+		if (slotKey == key) {
+			return &slots_[index];
+		}
+		if (slotKey == 0) {
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
+
+bool EventCoalescer::enable(uint32_t eventId, bool enabled)
+{
+	std::scoped_lock<std::mutex> lock(configMutex_);
+
+	Slot* slot{ find(eventId) };
+	if ((slot == nullptr) && enabled) {
+		for (size_t i = 0, index = eventId % CAPACITY; i < CAPACITY; i++, index = (index + 1) % CAPACITY) {
+			if (slots_[index].key.load(std::memory_order_acquire) == 0) {
+				slot = &slots_[index];
+				slot->key.store(SLOT_USED | eventId, std::memory_order_release);
+				break;
+			}
+		}
+		if (slot == nullptr) {
+			return false;
+		}
+	}
+	if ((slot != nullptr) && (slot->enabled.exchange(enabled) != enabled)) {
+		if (enabled) {
+			enabledCount_++;
+		}
+		else {
+			enabledCount_--;
+		}
+	}
+	return true;
+}
+
+/*
+ * Find the value kept for an event and object, claiming a free one if there is none yet.
+ */
+EventCoalescer::Value* EventCoalescer::value(uint32_t eventId, uint32_t objectId)
+{
+	const uint64_t key{ (uint64_t(eventId) << 32) | objectId };
+
+	for (size_t i = 0, index = (eventId * 31 + objectId) % VALUES; i < VALUES; i++, index = (index + 1) % VALUES) {
+		Value& value{ values_[index] };
+		uint32_t state{ value.state.load(std::memory_order_acquire) };
+		if ((state == EMPTY) && value.state.compare_exchange_strong(state, CLAIMING, std::memory_order_acq_rel)) {
+			value.key = key;
+			value.state.store(READY, std::memory_order_release);
+			return &value;
+		}
+		while (state == CLAIMING) {
+			state = value.state.load(std::memory_order_acquire);
+		}
+		if (value.key == key) {
+			return &value;
+		}
+	}
+	return nullptr;
+}
+
+bool EventCoalescer::offer(uint32_t objectId, uint32_t eventId, uint32_t data, uint32_t groupId, uint32_t flags)
+{
+	Slot* slot{ find(eventId) };
+	if ((slot == nullptr) || !slot->enabled.load(std::memory_order_relaxed)) {
+		return false;
+	}
+	Value* value{ this->value(eventId, objectId) };
+	if (value == nullptr) {
+		return false;
+	}
+	while (value->busy.test_and_set(std::memory_order_acquire)) {
+	}
+	value->pending = true;
+	value->data = data;
+	value->groupId = groupId;
+	value->flags = flags;
+	value->busy.clear(std::memory_order_release);
+	pending_.store(true, std::memory_order_release);
+
+	return true;
+}
+
+size_t EventCoalescer::flush(const Sender& send)
+{
+	if (!pending_.exchange(false, std::memory_order_acq_rel)) {
+		return 0;
+	}
+	size_t sent{ 0 };
+	for (auto& value : values_) {
+		if (value.state.load(std::memory_order_acquire) != READY) {
+			continue;
+		}
+		while (value.busy.test_and_set(std::memory_order_acquire)) {
+		}
+		const bool pending{ std::exchange(value.pending, false) };
+		CoalescedEvent event{ uint32_t(value.key), uint32_t(value.key >> 32), value.data, value.groupId, value.flags };
+		value.busy.clear(std::memory_order_release);
+
+		if (pending) {
+			send(event);
+			sent++;
+		}
+	}
+	return sent;
+}
+
+void EventCoalescer::start(std::chrono::microseconds interval, std::function<void()> flush)
+{
+	stop();
+
+	std::scoped_lock<std::mutex> lock(timerMutex_);
+	stopTimer_ = false;
+	timer_ = std::thread([this, interval, flush]() {
+		std::unique_lock<std::mutex> lock(timerMutex_);
+		auto next{ std::chrono::steady_clock::now() + interval };
+		while (!timerCv_.wait_until(lock, next, [this]() { return stopTimer_; })) {
+			lock.unlock();
+			flush();
+			lock.lock();
+			next = std::max(next + interval, std::chrono::steady_clock::now());
+		}
+	});
+}
+
+void EventCoalescer::stop()
+{
+	{
+		std::scoped_lock<std::mutex> lock(timerMutex_);
+		stopTimer_ = true;
+	}
+	timerCv_.notify_all();
+	if (timer_.joinable()) {
+		timer_.join();
+	}
+}
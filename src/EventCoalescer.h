@@ -0,0 +1,123 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	struct CoalescedEvent {
+		uint32_t objectId;
+		uint32_t eventId;
+		uint32_t data;
+		uint32_t groupId;
+		uint32_t flags;
+	};
+
+	/*
+	 * Keeps only the latest value of high-rate client events until they are flushed, per event and target object.
+	 * Producers never wait for a flush to send: offering a value is a lock-free table lookup and a few stores under
+	 * a per-value spin flag. A flush holds that flag only while it copies the value out, so the fields of a value are
+	 * always sent together and a producer spins for a few stores at most.
+	 */
+	class EventCoalescer {
+	public:
+		static constexpr size_t CAPACITY{ 256 };		// Coalesced events
+		static constexpr size_t VALUES{ 1024 };			// Pending values, per event and object
+		static constexpr uint32_t MAX_RATE{ 1000 };		// Timed flushes per second
+
+		using Sender = std::function<void(const CoalescedEvent&)>;
+
+	private:
+		static constexpr uint64_t SLOT_USED{ 1ull << 32 };
+
+		struct Slot {
+			std::atomic<uint64_t> key{ 0 };			// SLOT_USED | eventId once claimed
+			std::atomic<bool> enabled{ false };
+		};
+		std::array<Slot, CAPACITY> slots_;
+
+		enum : uint32_t { EMPTY, CLAIMING, READY };
+
+		struct Value {
+			std::atomic<uint32_t> state{ EMPTY };
+			uint64_t key{ 0 };						// eventId and objectId, set once before the value is READY
+			std::atomic_flag busy;					// Held while the fields below are written or taken
+			bool pending{ false };
+			uint32_t data{ 0 };
+			uint32_t groupId{ 0 };
+			uint32_t flags{ 0 };
+		};
+		std::array<Value, VALUES> values_;
+
+		std::atomic<size_t> enabledCount_{ 0 };
+		std::atomic<bool> pending_{ false };
+		std::atomic<bool> flushOnFrame_{ false };
+		std::mutex configMutex_;
+
+		std::mutex timerMutex_;
+		std::condition_variable timerCv_;
+		std::thread timer_;
+		bool stopTimer_{ false };
+
+		Slot* find(uint32_t eventId);
+		Value* value(uint32_t eventId, uint32_t objectId);
+
+	public:
+		EventCoalescer() = default;
+		EventCoalescer(const EventCoalescer&) = delete;
+		EventCoalescer(EventCoalescer&&) = delete;
+		~EventCoalescer() { stop(); }
+		EventCoalescer& operator=(const EventCoalescer&) = delete;
+		EventCoalescer& operator=(EventCoalescer&&) = delete;
+
+		bool enable(uint32_t eventId, bool enabled);
+		inline bool isActive() const { return enabledCount_.load(std::memory_order_relaxed) != 0; }
+
+		/*
+		 * Store the value if the event is coalesced. Returns false if it should be sent directly, which is also the
+		 * case once values for VALUES different event and object pairs are kept.
+		 */
+		bool offer(uint32_t objectId, uint32_t eventId, uint32_t data, uint32_t groupId, uint32_t flags);
+
+		inline bool hasPending() const { return pending_.load(std::memory_order_acquire); }
+
+		inline bool flushOnFrame() const { return flushOnFrame_.load(std::memory_order_relaxed); }
+		inline void setFlushOnFrame(bool flushOnFrame) { flushOnFrame_.store(flushOnFrame, std::memory_order_relaxed); }
+
+		/*
+		 * Pass every pending value to the sender, returning the number of events sent.
+		 */
+		size_t flush(const Sender& send);
+
+		/*
+		 * Call "flush" every interval on a background thread, until stopped.
+		 */
+		void start(std::chrono::microseconds interval, std::function<void()> flush);
+		void stop();
+	};
+
+}
+}
+}
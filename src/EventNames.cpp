@@ -0,0 +1,97 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+#include "EventNames.h"
+
+using namespace nl::rakis::interop;
+
+
+/*static*/ std::string EventNames::keyOf(const char* name)
+{
+	std::string key{ (name != nullptr) ? name : "" };
+	std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return char(std::toupper(c)); });
+	return key;
+}
+
+void EventNames::addEvent(const char* eventName, uint32_t eventId)
+{
+	std::string key{ keyOf(eventName) };
+
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	if (auto old = eventNames_.find(eventId); (old != eventNames_.end()) && (old->second != key)) {
+		events_.erase(old->second);
+	}
+	events_[key] = eventId;
+	eventNames_[eventId] = std::move(key);
+}
+
+void EventNames::addInput(uint32_t groupId, const char* inputDefinition, InputMapping mapping)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	inputs_[{ groupId, keyOf(inputDefinition) }] = mapping;
+}
+
+std::optional<std::pair<uint32_t, bool>> EventNames::claimEvent(const char* eventName, uint32_t proposedId)
+{
+	std::string key{ keyOf(eventName) };
+
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	if (auto it = events_.find(key); it != events_.end()) {
+		return std::make_pair(it->second, false);
+	}
+	if (eventNames_.contains(proposedId)) {
+		return std::nullopt;
+	}
+	events_[key] = proposedId;
+	eventNames_[proposedId] = std::move(key);
+	return std::make_pair(proposedId, true);
+}
+
+void EventNames::releaseEvent(const char* eventName)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	if (auto it = events_.find(keyOf(eventName)); it != events_.end()) {
+		eventNames_.erase(it->second);
+		events_.erase(it);
+	}
+}
+
+std::pair<InputMapping, bool> EventNames::claimInput(uint32_t groupId, const char* inputDefinition, InputMapping proposed)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	auto [it, added] = inputs_.try_emplace({ groupId, keyOf(inputDefinition) }, proposed);
+	return std::make_pair(it->second, added);
+}
+
+void EventNames::releaseInput(uint32_t groupId, const char* inputDefinition)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	inputs_.erase({ groupId, keyOf(inputDefinition) });
+}
+
+std::optional<uint32_t> EventNames::findEvent(const char* eventName) const
+{
+	const std::string key{ keyOf(eventName) };
+
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+	auto it{ events_.find(key) };
+	return (it == events_.end()) ? std::nullopt : std::optional<uint32_t>(it->second);
+}
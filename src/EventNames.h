@@ -0,0 +1,71 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	struct InputMapping {
+		uint32_t downEventId;
+		uint32_t upEventId;
+	};
+
+	/*
+	 * Interning table of the sim events and input definitions mapped on a connection, so repeated mappings of the
+	 * same name can reuse the client event ids already registered. Names are compared without regard to case, as
+	 * SimConnect does.
+	 */
+	class EventNames {
+		mutable std::shared_mutex mutex_;
+		std::unordered_map<std::string, uint32_t> events_;
+		std::unordered_map<uint32_t, std::string> eventNames_;
+		std::map<std::pair<uint32_t, std::string>, InputMapping> inputs_;
+
+		static std::string keyOf(const char* name);
+
+	public:
+		/*
+		 * Record a mapping made through any route.
+		 */
+		void addEvent(const char* eventName, uint32_t eventId);
+		void addInput(uint32_t groupId, const char* inputDefinition, InputMapping mapping);
+
+		/*
+		 * Atomically find the client event for a name, or reserve the proposed id for it. Returns the id to use, and
+		 * whether it was reserved (so the caller must register it, or release it if that fails). Fails if the
+		 * proposed id is already mapped to another name.
+		 */
+		std::optional<std::pair<uint32_t, bool>> claimEvent(const char* eventName, uint32_t proposedId);
+		void releaseEvent(const char* eventName);
+
+		std::pair<InputMapping, bool> claimInput(uint32_t groupId, const char* inputDefinition, InputMapping proposed);
+		void releaseInput(uint32_t groupId, const char* inputDefinition);
+
+		std::optional<uint32_t> findEvent(const char* eventName) const;
+	};
+
+}
+}
+}
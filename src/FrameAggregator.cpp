@@ -0,0 +1,86 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include "FrameAggregator.h"
+
+using namespace nl::rakis::interop;
+
+
+void FrameAggregator::enable(uint32_t frameEventId, size_t maxSize)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	maxSize_ = maxSize;
+	frameEventId_.store(frameEventId, std::memory_order_release);
+	enabled_.store(true, std::memory_order_release);
+}
+
+size_t FrameAggregator::disable()
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	enabled_.store(false, std::memory_order_release);
+	const size_t dropped{ entries_.size() };
+	entries_.clear();
+	payload_.clear();
+	return dropped;
+}
+
+/*static*/ bool FrameAggregator::isFrameData(const SIMCONNECT_RECV* msg)
+{
+	return (msg->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA) || (msg->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE) || (msg->dwID == SIMCONNECT_RECV_ID_CLIENT_DATA);
+}
+
+bool FrameAggregator::add(const SIMCONNECT_RECV* msg, DWORD size)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	const size_t offset{ payload_.size() };
+	if (!entries_.empty() && (offset + align(size) + (entries_.size() + 1) * sizeof(FrameEntry) + sizeof(FrameHeader) > maxSize_)) {
+		return false;
+	}
+	payload_.resize(offset + align(size));
+	std::memcpy(payload_.data() + offset, msg, size);
+	entries_.push_back(FrameEntry{ msg->dwID, static_cast<const SIMCONNECT_RECV_SIMOBJECT_DATA*>(msg)->dwRequestID, uint32_t(offset), uint32_t(size) });
+	return true;
+}
+
+SIMCONNECT_RECV* FrameAggregator::close(float frameRate, float simSpeed, uint32_t flags, DWORD& size)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	const size_t directory{ sizeof(FrameHeader) + entries_.size() * sizeof(FrameEntry) };	// Both multiples of 8
+	record_.resize(directory + payload_.size());
+
+	auto header{ reinterpret_cast<FrameHeader*>(record_.data()) };
+	*header = FrameHeader{ DWORD(record_.size()), 0, RECV_ID_FRAME, frameNumber_++, frameRate, simSpeed, uint32_t(entries_.size()), flags };
+	auto entries{ reinterpret_cast<FrameEntry*>(header + 1) };
+	for (size_t i = 0; i < entries_.size(); i++) {
+		entries[i] = entries_[i];
+		entries[i].offset += uint32_t(directory);
+	}
+	if (!payload_.empty()) {
+		std::memcpy(record_.data() + directory, payload_.data(), payload_.size());
+	}
+	entries_.clear();
+	payload_.clear();
+
+	size = DWORD(record_.size());
+	return reinterpret_cast<SIMCONNECT_RECV*>(record_.data());
+}
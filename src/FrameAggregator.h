@@ -0,0 +1,114 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "framework.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Layout of a frame record: this header, a directory entry per message, then the messages themselves, each
+	 * starting at an 8-byte boundary. Offsets are from the start of the record. The header starts like every
+	 * SIMCONNECT_RECV, so a record can be passed along as a message of its own.
+	 */
+	struct FrameHeader {
+		DWORD dwSize;
+		DWORD dwVersion;
+		DWORD dwID;
+		uint32_t frameNumber;
+		float frameRate;
+		float simSpeed;
+		uint32_t count;
+		uint32_t flags;
+	};
+
+	struct FrameEntry {
+		uint32_t id;				// The dwID of the message
+		uint32_t requestId;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	/*
+	 * Collects the data messages received between two frame events into a single frame record.
+	 */
+	class FrameAggregator {
+	public:
+		static constexpr DWORD RECV_ID_FRAME{ 0x10000 };		// Outside the range of SIMCONNECT_RECV_ID
+		static constexpr uint32_t FLAG_PARTIAL{ 1 };		// Closed early because it reached the size limit
+		static constexpr size_t DEFAULT_MAX_SIZE{ 1024 * 1024 };
+
+	private:
+		std::atomic<bool> enabled_{ false };
+		std::atomic<uint32_t> frameEventId_{ 0 };
+		size_t maxSize_{ DEFAULT_MAX_SIZE };
+
+		mutable std::mutex mutex_;
+		std::vector<FrameEntry> entries_;
+		std::vector<uint8_t> payload_;
+		std::vector<uint8_t> record_;			// The last record closed, valid until the next one
+		uint32_t frameNumber_{ 0 };
+
+		static inline size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+	public:
+		FrameAggregator() = default;
+		FrameAggregator(const FrameAggregator&) = delete;
+		FrameAggregator(FrameAggregator&&) = delete;
+		~FrameAggregator() = default;
+		FrameAggregator& operator=(const FrameAggregator&) = delete;
+		FrameAggregator& operator=(FrameAggregator&&) = delete;
+
+		/*
+		 * Start collecting, closing frames on the client event that was subscribed to the "Frame" system event.
+		 */
+		void enable(uint32_t frameEventId, size_t maxSize);
+
+		/*
+		 * Stop collecting. Returns the number of messages that were still waiting for their frame, which are dropped.
+		 */
+		size_t disable();
+
+		inline bool isEnabled() const { return enabled_.load(std::memory_order_acquire); }
+		inline uint32_t frameEventId() const { return frameEventId_.load(std::memory_order_acquire); }
+
+		/*
+		 * Whether this message goes into the frame, rather than straight to the client.
+		 */
+		static bool isFrameData(const SIMCONNECT_RECV* msg);
+
+		/*
+		 * Add a message to the current frame. Returns false if the frame has reached its size limit and should be
+		 * closed first; a message larger than the limit on its own is still accepted into an empty frame.
+		 */
+		bool add(const SIMCONNECT_RECV* msg, DWORD size);
+
+		/*
+		 * Close the current frame and start the next one. The record stays valid until the next close.
+		 */
+		SIMCONNECT_RECV* close(float frameRate, float simSpeed, uint32_t flags, DWORD& size);
+	};
+
+}
+}
+}
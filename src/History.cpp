@@ -0,0 +1,143 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "History.h"
+
+using namespace nl::rakis::interop;
+
+
+HistoryRing::HistoryRing(std::shared_ptr<const DataSchema> schema, size_t capacity)
+	: schema_(std::move(schema)), capacity_(std::max<size_t>(capacity, 1)),
+	  times_(capacity_), columns_(schema_->fields().size(), std::vector<double>(capacity_))
+{
+}
+
+size_t HistoryRing::size() const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+	return count_;
+}
+
+bool HistoryRing::record(int64_t time, const void* row, size_t size)
+{
+	if (size < schema_->size()) {
+		return false;
+	}
+	const auto& fields{ schema_->fields() };
+
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	times_[head_] = time;
+	for (size_t i = 0; i < fields.size(); i++) {
+		columns_[i][head_] = DataSchema::toDouble(fields[i], row);
+	}
+	head_ = (head_ + 1) % capacity_;
+	count_ = std::min(count_ + 1, capacity_);
+	return true;
+}
+
+/*
+ * The logical index of the first row at or after the given time, or count_ if there is none.
+ */
+size_t HistoryRing::lowerBound(int64_t time) const
+{
+	size_t lo{ 0 }, hi{ count_ };
+	while (lo < hi) {
+		const size_t mid{ lo + (hi - lo) / 2 };
+		if (times_[physical(mid)] < time) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+size_t HistoryRing::read(int64_t from, int64_t to, size_t maxCount, int64_t* times, double* const* columns) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	size_t copied{ 0 };
+	for (size_t index = lowerBound(from); (index < count_) && (copied < maxCount); index++, copied++) {
+		const size_t at{ physical(index) };
+		if (times_[at] > to) {
+			break;
+		}
+		if (times != nullptr) {
+			times[copied] = times_[at];
+		}
+		for (size_t column = 0; (columns != nullptr) && (column < columns_.size()); column++) {
+			if (columns[column] != nullptr) {
+				columns[column][copied] = columns_[column][at];
+			}
+		}
+	}
+	return copied;
+}
+
+bool HistoryRing::valueAt(int64_t time, uint32_t datum, double& value) const
+{
+	if (datum >= columns_.size()) {
+		return false;
+	}
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	const size_t index{ lowerBound(time) };
+	if (index == count_) {
+		return false;
+	}
+	const size_t after{ physical(index) };
+	if (times_[after] == time) {
+		value = columns_[datum][after];
+		return true;
+	}
+	if (index == 0) {
+		return false;
+	}
+	const size_t before{ physical(index - 1) };
+	const double fraction{ double(time - times_[before]) / double(times_[after] - times_[before]) };
+	value = columns_[datum][before] + fraction * (columns_[datum][after] - columns_[datum][before]);
+	return true;
+}
+
+
+void Histories::add(uint32_t requestId, std::shared_ptr<HistoryRing> ring)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	rings_[requestId] = std::move(ring);
+	count_.store(rings_.size(), std::memory_order_release);
+}
+
+bool Histories::remove(uint32_t requestId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	const bool removed{ rings_.erase(requestId) > 0 };
+	count_.store(rings_.size(), std::memory_order_release);
+	return removed;
+}
+
+std::shared_ptr<HistoryRing> Histories::find(uint32_t requestId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	auto it{ rings_.find(requestId) };
+	return (it == rings_.end()) ? nullptr : it->second;
+}
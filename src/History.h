@@ -0,0 +1,96 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "DataSchema.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * The most recent rows received for one data request, kept as a timestamp column plus one column of doubles per
+	 * datum. All storage is allocated up front; once full, each new row overwrites the oldest. Datums that are not
+	 * numeric are stored as NaN.
+	 */
+	class HistoryRing {
+		std::shared_ptr<const DataSchema> schema_;
+		size_t capacity_;
+
+		mutable std::shared_mutex mutex_;
+		size_t head_{ 0 };		// Where the next row goes
+		size_t count_{ 0 };
+		std::vector<int64_t> times_;
+		std::vector<std::vector<double>> columns_;
+
+		inline size_t physical(size_t index) const { return (head_ + capacity_ - count_ + index) % capacity_; }
+		size_t lowerBound(int64_t time) const;
+
+	public:
+		HistoryRing(std::shared_ptr<const DataSchema> schema, size_t capacity);
+		HistoryRing(const HistoryRing&) = delete;
+		HistoryRing(HistoryRing&&) = delete;
+		~HistoryRing() = default;
+		HistoryRing& operator=(const HistoryRing&) = delete;
+		HistoryRing& operator=(HistoryRing&&) = delete;
+
+		inline size_t capacity() const { return capacity_; }
+		inline size_t columnCount() const { return columns_.size(); }
+		size_t size() const;
+
+		/*
+		 * Append an untagged row of the schema's layout. Rows must arrive in time order.
+		 */
+		bool record(int64_t time, const void* row, size_t size);
+
+		/*
+		 * Copy the rows with from <= time <= to, oldest first, up to maxCount. Null columns are skipped.
+		 * Returns the number of rows copied.
+		 */
+		size_t read(int64_t from, int64_t to, size_t maxCount, int64_t* times, double* const* columns) const;
+
+		/*
+		 * Linearly interpolate a datum at the given time. Fails outside the recorded time range.
+		 */
+		bool valueAt(int64_t time, uint32_t datum, double& value) const;
+	};
+
+	/*
+	 * The history rings of a single connection, keyed by requestId.
+	 */
+	class Histories {
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<HistoryRing>> rings_;
+		std::atomic<size_t> count_{ 0 };
+
+	public:
+		void add(uint32_t requestId, std::shared_ptr<HistoryRing> ring);
+		bool remove(uint32_t requestId);
+		std::shared_ptr<HistoryRing> find(uint32_t requestId) const;
+
+		inline bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+	};
+
+}
+}
+}
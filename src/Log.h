@@ -15,12 +15,14 @@
  * limitations under the License.
  */
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <cwchar>
 #include <functional>
+#include <source_location>
 
 #include <filesystem>
 
@@ -178,6 +180,66 @@ namespace logging {
 
 	};
 
+	/*
+	 * Every message passed to a Logger, whatever its threshold, is also kept in a fixed-size ring per thread. This costs
+	 * a copy into memory and no I/O. When an ERROR or FATAL is logged, the records added since the last dump (on all
+	 * threads) are first written to the target of that logger, oldest first, so a log kept at WARN still shows what
+	 * led up to the error.
+	 */
+	class LogRing {
+	public:
+		static constexpr size_t CAPACITY{ 256 };		// Records per thread
+		static constexpr size_t NAME_SIZE{ 32 };
+		static constexpr size_t TEXT_SIZE{ 200 };		// Longer messages are cut off
+
+		static void setEnabled(bool enabled);
+		static bool isEnabled();
+
+		static void record(LogLevel level, const std::string& name, const std::string& msg);
+
+		/*
+		 * Write the records added since the last dump to the target, returning the number written.
+		 */
+		static size_t dump(const Configurer::StringLogger& target);
+	};
+
+	/*
+	 * Limits the WARN and higher messages written per call site with a token bucket: "burst" messages at once, refilled
+	 * at "perSecond". Messages over the limit are counted, and the count is written as a summary before the next message
+	 * from that site that gets through, or at most a second later with a message from any other site. Sites live in a
+	 * fixed table of atomics, so checking takes no lock.
+	 */
+	class LogLimiter {
+	public:
+		static constexpr LogLevel LEVEL{ LOGLVL_WARN };	// Messages below this level are not limited
+		static constexpr double DEFAULT_RATE{ 10.0 };
+		static constexpr uint32_t DEFAULT_BURST{ 50 };
+		static constexpr size_t SITES{ 1024 };			// Sites beyond this are not limited
+		static constexpr int64_t FLUSH_MICROS{ 1000000 };	// Minimum time between summaries written for other sites
+
+		/*
+		 * A rate of zero turns limiting off. The buckets and the counts of suppressed messages are reset.
+		 */
+		static void setLimit(double perSecond, uint32_t burst);
+
+		/*
+		 * Whether a message from this site may be written. If so, "suppressed" is set to the number of messages
+		 * dropped since the last one that was.
+		 */
+		static bool admit(LogLevel level, const std::source_location& where, uint64_t& suppressed);
+
+		/*
+		 * Whether any site has suppressed messages not yet summarized.
+		 */
+		static bool pending();
+
+		/*
+		 * Write the summaries of all sites with suppressed messages to the target, if the last flush was at least
+		 * FLUSH_MICROS ago. Returns the number written.
+		 */
+		static size_t flush(const Configurer::StringLogger& target);
+	};
+
 	class Logger {
 	public:
 
@@ -218,6 +280,9 @@ namespace logging {
 
 		static std::string formatLine(LogLevel level, const std::string name, const std::string msg);
 
+		// Check the limit of the call site, writing the summary of what it or other sites suppressed if there is one.
+		bool admit(LogLevel level, const std::source_location& where);
+
 	public:
 		Logger() = delete;
 		Logger(Logger const& log) = default;
@@ -240,35 +305,52 @@ namespace logging {
 		inline bool isErrorEnabled() { return getLevel() <= LOGLVL_ERROR; }
 		inline bool isFatalEnabled() { return getLevel() <= LOGLVL_FATAL; }
 
-		inline void trace(const std::string& txt) {
-			if (isTraceEnabled()) {
+		inline void trace(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			LogRing::record(LOGLVL_TRACE, name_, txt);
+			if (isTraceEnabled() && admit(LOGLVL_TRACE, where)) {
 				log(LOGLVL_TRACE, txt);
 			}
 		}
-		inline void debug(const std::string& txt) {
-			if (isDebugEnabled()) {
+		inline void debug(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			LogRing::record(LOGLVL_DEBUG, name_, txt);
+			if (isDebugEnabled() && admit(LOGLVL_DEBUG, where)) {
 				log(LOGLVL_DEBUG, txt);
 			}
 		}
-		inline void info(const std::string& txt) {
-			if (isInfoEnabled()) {
+		inline void info(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			LogRing::record(LOGLVL_INFO, name_, txt);
+			if (isInfoEnabled() && admit(LOGLVL_INFO, where)) {
 				log(LOGLVL_INFO, txt);
 			}
 		}
-		inline void warn(const std::string& txt) {
-			if (isWarnEnabled()) {
+		inline void warn(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			LogRing::record(LOGLVL_WARN, name_, txt);
+			if (isWarnEnabled() && admit(LOGLVL_WARN, where)) {
 				log(LOGLVL_WARN, txt);
 			}
 		}
-		inline void error(const std::string& txt) {
-			if (isErrorEnabled()) {
+		// The ring is dumped before the error itself is logged and recorded.
+		inline void error(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			if (isErrorEnabled() && admit(LOGLVL_ERROR, where)) {
+				dumpRing();
 				log(LOGLVL_ERROR, txt);
 			}
+			LogRing::record(LOGLVL_ERROR, name_, txt);
 		}
-		inline void fatal(const std::string& txt) {
-			if (isFatalEnabled()) {
+		inline void fatal(const std::string& txt, const std::source_location& where = std::source_location::current()) {
+			if (isFatalEnabled() && admit(LOGLVL_FATAL, where)) {
+				dumpRing();
 				log(LOGLVL_FATAL, txt);
 			}
+			LogRing::record(LOGLVL_FATAL, name_, txt);
+		}
+
+		/*
+		 * Write the records in the ring since the last dump to the target of this logger.
+		 */
+		inline size_t dumpRing() {
+			const auto& target{ Configurer::getTarget(name_) };
+			return target.logger_ ? LogRing::dump(target.logger_) : 0;
 		}
 
 		friend class Configurer;
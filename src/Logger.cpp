@@ -29,6 +29,9 @@
 #include <ranges>
 #include <tuple>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "Log.h"
 
@@ -167,3 +170,297 @@ static LogLevel valueOf(const std::string& name)
 		rootLogger(LOGLVL_ERROR, std::format("getLevel(): '{}', trace is {}\n", LOGLVL_NAME[logger.getLevel()], logger.isTraceEnabled() ? "enabled" : "disabled"));
 	}
 }
+
+
+/*
+ * LogRing: records are written only by their own thread, and read by dumps under a sequence lock, so neither side
+ * waits for the other. A record is odd while it is being written.
+ */
+
+namespace {
+
+	struct RingRecord {
+		std::atomic<uint32_t> sequence{ 0 };
+		LogLevel level{ LOGLVL_INIT };
+		uint64_t serial{ 0 };
+		int64_t time{ 0 };				// System clock, microseconds
+		char name[LogRing::NAME_SIZE]{};
+		char text[LogRing::TEXT_SIZE]{};
+	};
+
+	struct Ring {
+		uint32_t thread{ 0 };
+		size_t head{ 0 };
+		std::array<RingRecord, LogRing::CAPACITY> records;
+	};
+
+	struct RingCopy {
+		uint32_t thread;
+		LogLevel level;
+		uint64_t serial;
+		int64_t time;
+		char name[LogRing::NAME_SIZE];
+		char text[LogRing::TEXT_SIZE];
+	};
+
+	struct RingRegistry {
+		std::mutex mutex;
+		std::vector<std::shared_ptr<Ring>> rings;
+		std::mutex dumpMutex;
+		uint64_t dumped{ 0 };			// Serial of the last record dumped
+	};
+
+	RingRegistry& registry()
+	{
+		static RingRegistry theRegistry;
+
+		return theRegistry;
+	}
+
+	/*
+	 * Registers the ring of a thread on first use, and removes it when the thread ends.
+	 */
+	struct RingHolder {
+		std::shared_ptr<Ring> ring;
+
+		RingHolder() : ring(std::make_shared<Ring>())
+		{
+			ring->thread = uint32_t(GetCurrentThreadId());
+			std::scoped_lock<std::mutex> lock(registry().mutex);
+			registry().rings.push_back(ring);
+		}
+		~RingHolder()
+		{
+			std::scoped_lock<std::mutex> lock(registry().mutex);
+			std::erase(registry().rings, ring);
+		}
+	};
+
+}
+
+static std::atomic<bool> ringEnabled{ true };
+static std::atomic<uint64_t> ringSerial{ 0 };
+
+static void copyTruncated(char* out, size_t size, const std::string& in)
+{
+	const size_t count{ std::min(in.size(), size - 1) };
+	std::memcpy(out, in.data(), count);
+	out[count] = '\0';
+}
+
+/*static*/ void LogRing::setEnabled(bool enabled)
+{
+	ringEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*static*/ bool LogRing::isEnabled()
+{
+	return ringEnabled.load(std::memory_order_relaxed);
+}
+
+/*static*/ void LogRing::record(LogLevel level, const std::string& name, const std::string& msg)
+{
+	if (!ringEnabled.load(std::memory_order_relaxed)) {
+		return;
+	}
+	thread_local RingHolder holder;
+	Ring& ring{ *holder.ring };
+	RingRecord& record{ ring.records[ring.head++ % CAPACITY] };
+
+	const uint32_t sequence{ record.sequence.load(std::memory_order_relaxed) };
+	record.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	record.level = level;
+	record.serial = ringSerial.fetch_add(1, std::memory_order_relaxed) + 1;
+	record.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	copyTruncated(record.name, NAME_SIZE, name);
+	copyTruncated(record.text, TEXT_SIZE, msg);
+	record.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/*static*/ size_t LogRing::dump(const Configurer::StringLogger& target)
+{
+	auto& reg{ registry() };
+	std::scoped_lock<std::mutex> dumpLock(reg.dumpMutex);
+
+	std::vector<RingCopy> copies;
+	{
+		std::scoped_lock<std::mutex> lock(reg.mutex);
+		for (const auto& ring : reg.rings) {
+			for (const auto& record : ring->records) {
+				const uint32_t before{ record.sequence.load(std::memory_order_acquire) };
+				if ((before == 0) || ((before & 1) != 0)) {
+					continue;
+				}
+				RingCopy copy{ ring->thread, record.level, record.serial, record.time };
+				std::memcpy(copy.name, record.name, NAME_SIZE);
+				std::memcpy(copy.text, record.text, TEXT_SIZE);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if ((record.sequence.load(std::memory_order_relaxed) == before) && (copy.serial > reg.dumped)) {
+					copies.push_back(copy);
+				}
+			}
+		}
+	}
+	std::sort(copies.begin(), copies.end(), [](const RingCopy& a, const RingCopy& b) { return a.serial < b.serial; });
+
+	for (const auto& copy : copies) {
+		const time_t seconds{ time_t(copy.time / 1000000) };
+		tm ti;
+		localtime_s(&ti, &seconds);
+		target(copy.level, std::format("[ring {:02}:{:02}:{:02}.{:06} thread {}] {} {}",
+			ti.tm_hour, ti.tm_min, ti.tm_sec, copy.time % 1000000, copy.thread, copy.name, copy.text));
+	}
+	if (!copies.empty()) {
+		reg.dumped = copies.back().serial;
+	}
+	return copies.size();
+}
+
+
+/*
+ * LogLimiter: a site is found by hashing its file name and line into the table, claiming an empty slot with a
+ * compare-and-swap. Its bucket is a single "theoretical arrival time" (GCRA): a message gets through if that time is
+ * at most burst - 1 intervals ahead, and moves it one interval further. The number of sites with an unwritten count
+ * is kept, so the messages of other sites only look at the table when there is something to summarize.
+ */
+
+namespace {
+
+	struct LimitedSite {
+		std::atomic<uint64_t> key{ 0 };
+		std::atomic<const char*> file{ nullptr };
+		std::atomic<uint32_t> line{ 0 };
+		std::atomic<int> level{ LOGLVL_WARN };
+		std::atomic<int64_t> arrival{ 0 };
+		std::atomic<uint64_t> suppressed{ 0 };
+	};
+
+}
+
+static constexpr size_t SITE_PROBES{ 8 };
+
+static std::array<LimitedSite, LogLimiter::SITES> limitedSites;
+static std::atomic<int64_t> limitInterval{ int64_t(1000000 / LogLimiter::DEFAULT_RATE) };		// Microseconds per message
+static std::atomic<int64_t> limitBurst{ LogLimiter::DEFAULT_BURST };
+static std::atomic<uint64_t> pendingSites{ 0 };
+static std::atomic<int64_t> lastFlush{ 0 };
+
+static inline int64_t nowMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static LimitedSite* findSite(const std::source_location& where)
+{
+	const uint64_t hash{ (uint64_t(reinterpret_cast<uintptr_t>(where.file_name())) ^ (uint64_t(where.line()) * 0x9e3779b97f4a7c15ull)) * 0xbf58476d1ce4e5b9ull };
+	const uint64_t key{ hash | 1 };			// Zero marks an empty slot
+
+	for (size_t i = 0; i < SITE_PROBES; i++) {
+		auto& site{ limitedSites[(hash + i) % LogLimiter::SITES] };
+		uint64_t found{ site.key.load(std::memory_order_acquire) };
+		if ((found == 0) && site.key.compare_exchange_strong(found, key, std::memory_order_acq_rel)) {
+			site.line.store(where.line(), std::memory_order_relaxed);
+			site.file.store(where.file_name(), std::memory_order_release);
+			return &site;
+		}
+		if (found == key) {
+			return &site;
+		}
+	}
+	return nullptr;
+}
+
+// Take the count of a site, keeping the number of sites with a count in step.
+static uint64_t takeSuppressed(LimitedSite& site)
+{
+	const uint64_t suppressed{ site.suppressed.exchange(0, std::memory_order_relaxed) };
+	if (suppressed > 0) {
+		pendingSites.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return suppressed;
+}
+
+static std::string summary(uint64_t suppressed, const char* file, uint32_t line)
+{
+	return std::format("Suppressed {} similar messages from {}:{}.", suppressed, fs::path(file).filename().string(), line);
+}
+
+/*static*/ void LogLimiter::setLimit(double perSecond, uint32_t burst)
+{
+	limitInterval.store((perSecond > 0.0) ? std::max(int64_t(1000000 / perSecond), int64_t(1)) : 0, std::memory_order_relaxed);
+	limitBurst.store(std::max(burst, uint32_t(1)), std::memory_order_relaxed);
+	for (auto& site : limitedSites) {
+		site.arrival.store(0, std::memory_order_relaxed);
+		takeSuppressed(site);
+	}
+	lastFlush.store(nowMicros(), std::memory_order_relaxed);
+}
+
+/*static*/ bool LogLimiter::admit(LogLevel level, const std::source_location& where, uint64_t& suppressed)
+{
+	suppressed = 0;
+	const int64_t interval{ limitInterval.load(std::memory_order_relaxed) };
+	LimitedSite* site{ ((level >= LEVEL) && (interval > 0)) ? findSite(where) : nullptr };
+	if (site == nullptr) {
+		return true;
+	}
+	const int64_t now{ nowMicros() };
+	const int64_t tolerance{ interval * (limitBurst.load(std::memory_order_relaxed) - 1) };
+
+	int64_t arrival{ site->arrival.load(std::memory_order_relaxed) };
+	do {
+		const int64_t start{ std::max(arrival, now) };
+		if (start - now > tolerance) {
+			site->level.store(level, std::memory_order_relaxed);
+			if (site->suppressed.fetch_add(1, std::memory_order_relaxed) == 0) {
+				pendingSites.fetch_add(1, std::memory_order_relaxed);
+			}
+			return false;
+		}
+	} while (!site->arrival.compare_exchange_weak(arrival, std::max(arrival, now) + interval, std::memory_order_relaxed));
+
+	suppressed = takeSuppressed(*site);
+	return true;
+}
+
+/*static*/ bool LogLimiter::pending()
+{
+	return pendingSites.load(std::memory_order_relaxed) > 0;
+}
+
+/*static*/ size_t LogLimiter::flush(const Configurer::StringLogger& target)
+{
+	const int64_t now{ nowMicros() };
+	int64_t last{ lastFlush.load(std::memory_order_relaxed) };
+	if ((now - last < FLUSH_MICROS) || !lastFlush.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+		return 0;		// Too soon, or another thread is flushing
+	}
+	size_t written{ 0 };
+	for (auto& site : limitedSites) {
+		const char* file{ site.file.load(std::memory_order_acquire) };
+		if ((file == nullptr) || (site.suppressed.load(std::memory_order_relaxed) == 0)) {
+			continue;
+		}
+		if (const uint64_t suppressed = takeSuppressed(site); suppressed > 0) {
+			target(LogLevel(site.level.load(std::memory_order_relaxed)), summary(suppressed, file, site.line.load(std::memory_order_relaxed)));
+			written++;
+		}
+	}
+	return written;
+}
+
+bool Logger::admit(LogLevel level, const std::source_location& where)
+{
+	uint64_t suppressed{ 0 };
+	if (!LogLimiter::admit(level, where, suppressed)) {
+		return false;
+	}
+	if (LogLimiter::pending()) {
+		LogLimiter::flush([this](LogLevel summaryLevel, const std::string& msg) { log(summaryLevel, msg); });
+	}
+	if (suppressed > 0) {
+		log(level, summary(suppressed, where.file_name(), where.line()));
+	}
+	return true;
+}
@@ -0,0 +1,121 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "MessageArena.h"
+
+using namespace nl::rakis::interop;
+
+
+/*static*/ size_t MessageArena::classOf(size_t size)
+{
+	return size_t(std::lower_bound(SIZE_CLASSES.begin(), SIZE_CLASSES.end(), size) - SIZE_CLASSES.begin());
+}
+
+void MessageArena::refill(size_t sizeClass)
+{
+	const size_t blockSize{ SIZE_CLASSES[sizeClass] };
+	auto& slab{ slabs_.emplace_back(std::make_unique<std::byte[]>(SLAB_SIZE)) };
+
+	for (size_t offset = SLAB_SIZE; offset >= blockSize; offset -= blockSize) {
+		auto block{ reinterpret_cast<FreeBlock*>(slab.get() + offset - blockSize) };
+		block->next = free_[sizeClass];
+		free_[sizeClass] = block;
+	}
+}
+
+void* MessageArena::allocate(size_t size)
+{
+	allocations_++;
+
+	const size_t sizeClass{ classOf(size) };
+	if (sizeClass == SIZE_CLASSES.size()) {
+		oversized_++;
+		return new std::byte[size];
+	}
+	if (free_[sizeClass] == nullptr) {
+		refill(sizeClass);
+	}
+	FreeBlock* block{ free_[sizeClass] };
+	free_[sizeClass] = block->next;
+	return block;
+}
+
+void MessageArena::recycle(void* block, size_t size)
+{
+	const size_t sizeClass{ classOf(size) };
+	if (sizeClass == SIZE_CLASSES.size()) {
+		delete[] static_cast<std::byte*>(block);
+		return;
+	}
+	auto freed{ static_cast<FreeBlock*>(block) };
+	freed->next = free_[sizeClass];
+	free_[sizeClass] = freed;
+}
+
+MessageArena::Statistics MessageArena::statistics() const
+{
+	return Statistics{ slabs_.size(), oversized_, allocations_, slabs_.size() * SLAB_SIZE };
+}
+
+
+MessageBatch::~MessageBatch()
+{
+	for (const auto& held : taken_) {
+		arena_.recycle(held.message, held.size);
+	}
+	for (const auto& held : queued_) {
+		arena_.recycle(held.message, held.size);
+	}
+}
+
+void MessageBatch::queue(const void* message, size_t size)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	void* copy{ arena_.allocate(size) };
+	std::memcpy(copy, message, size);
+	queued_.push_back(Held{ copy, uint32_t(size) });
+}
+
+size_t MessageBatch::queued() const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	return queued_.size();
+}
+
+size_t MessageBatch::release()
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	for (const auto& held : taken_) {
+		arena_.recycle(held.message, held.size);
+	}
+	const size_t count{ taken_.size() };
+	taken_.clear();
+	return count;
+}
+
+MessageArena::Statistics MessageBatch::statistics() const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	return arena_.statistics();
+}
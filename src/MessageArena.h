@@ -0,0 +1,128 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Fixed size blocks for message copies, carved from 64KB slabs and kept on a free list per size class once
+	 * recycled, so copying messages stops allocating once the slabs cover the peak number of copies held. Messages
+	 * larger than the largest class get a heap block of their own. Not thread-safe by itself.
+	 */
+	class MessageArena {
+	public:
+		// Events and small data messages fit the first classes; client data areas are at most 8KB.
+		static constexpr std::array<uint32_t, 8> SIZE_CLASSES{ 64, 128, 256, 512, 1024, 4096, 16384, 65536 };
+		static constexpr size_t SLAB_SIZE{ 65536 };
+
+		struct Statistics {
+			uint64_t slabs;			// Heap allocations for slabs
+			uint64_t oversized;		// Heap allocations for messages larger than a slab
+			uint64_t allocations;	// All blocks handed out
+			uint64_t reserved;		// Bytes in slabs
+		};
+
+	private:
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		std::array<FreeBlock*, SIZE_CLASSES.size()> free_{};
+		std::vector<std::unique_ptr<std::byte[]>> slabs_;
+		uint64_t oversized_{ 0 };
+		uint64_t allocations_{ 0 };
+
+		static size_t classOf(size_t size);
+		void refill(size_t sizeClass);
+
+	public:
+		MessageArena() = default;
+		MessageArena(const MessageArena&) = delete;
+		MessageArena(MessageArena&&) = delete;
+		~MessageArena() = default;
+		MessageArena& operator=(const MessageArena&) = delete;
+		MessageArena& operator=(MessageArena&&) = delete;
+
+		void* allocate(size_t size);
+		void recycle(void* block, size_t size);
+
+		Statistics statistics() const;
+	};
+
+	/*
+	 * Copies of received messages, held in an arena until the consumer has seen them. Messages are queued, handed
+	 * out in batches, and recycled all at once when the consumer releases the batch.
+	 */
+	class MessageBatch {
+		struct Held {
+			void* message;
+			uint32_t size;
+		};
+
+		mutable std::mutex mutex_;
+		MessageArena arena_;
+		std::vector<Held> queued_;		// Copied, but not yet handed out
+		std::vector<Held> taken_;		// Handed out, until released
+
+	public:
+		MessageBatch() = default;
+		MessageBatch(const MessageBatch&) = delete;
+		MessageBatch(MessageBatch&&) = delete;
+		~MessageBatch();
+		MessageBatch& operator=(const MessageBatch&) = delete;
+		MessageBatch& operator=(MessageBatch&&) = delete;
+
+		void queue(const void* message, size_t size);
+		size_t queued() const;
+
+		/*
+		 * Hand out up to "max" queued messages, oldest first, as out(index, message, size). They stay valid until
+		 * release().
+		 */
+		template <typename Out>
+		size_t take(size_t max, const Out& out) {
+			std::scoped_lock<std::mutex> lock(mutex_);
+
+			const size_t count{ std::min(max, queued_.size()) };
+			for (size_t i = 0; i < count; i++) {
+				out(i, queued_[i].message, queued_[i].size);
+			}
+			taken_.insert(taken_.end(), queued_.begin(), queued_.begin() + count);
+			queued_.erase(queued_.begin(), queued_.begin() + count);
+			return count;
+		}
+
+		/*
+		 * Recycle all messages handed out so far, returning how many there were.
+		 */
+		size_t release();
+
+		MessageArena::Statistics statistics() const;
+	};
+
+}
+}
+}
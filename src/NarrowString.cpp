@@ -0,0 +1,79 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cwchar>
+
+#include "NarrowString.h"
+
+using namespace nl::rakis::interop;
+
+
+/*
+ * The most bytes a single wchar_t can need: two for a double byte code page, and up to four when the ANSI code page
+ * is UTF-8 (a surrogate pair is two wchar_t's).
+ */
+static constexpr size_t MAX_BYTES_PER_CHAR{ 4 };
+
+/*
+ * Convert "length" wide characters into "out", which has room for MAX_BYTES_PER_CHAR per character, returning the
+ * number of bytes written.
+ */
+static size_t narrow(const wchar_t* str, size_t length, char* out)
+{
+	size_t ascii{ 0 };
+	while ((ascii < length) && (uint32_t(str[ascii]) < 0x80)) {
+		out[ascii] = char(str[ascii]);
+		ascii++;
+	}
+	if (ascii == length) {
+		return length;
+	}
+	const int size{ WideCharToMultiByte(CP_ACP, 0, str + ascii, int(length - ascii), out + ascii, int((length - ascii) * MAX_BYTES_PER_CHAR), nullptr, nullptr) };
+	return ascii + size_t(size);
+}
+
+NarrowString::NarrowString(const wchar_t* str)
+{
+	if (str == nullptr) {
+		return;
+	}
+	const size_t length{ std::wcslen(str) };
+	char* out{ reserve(length * MAX_BYTES_PER_CHAR + 1) };
+	out[narrow(str, length, out)] = '\0';
+	str_ = out;
+}
+
+char* NarrowString::reserve(size_t size)
+{
+	if (size <= INLINE_SIZE) {
+		return inline_;
+	}
+	heap_.resize(size);
+	return heap_.data();
+}
+
+/*static*/ void NarrowString::convert(const wchar_t* str, std::string& out)
+{
+	if (str == nullptr) {
+		out.clear();
+		return;
+	}
+	const size_t length{ std::wcslen(str) };
+	out.resize(length * MAX_BYTES_PER_CHAR);
+	out.resize(narrow(str, length, out.data()));
+}
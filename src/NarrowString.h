@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <string>
+
+#include "framework.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * A UTF-16 string converted for the narrow SimConnect calls: to the ANSI code page, as the CLR does when it marshals
+	 * a string to char*. Short strings are converted into the object itself, so a NarrowString on the stack costs no
+	 * allocation; longer ones use the heap.
+	 */
+	class NarrowString {
+		static constexpr size_t INLINE_SIZE{ 256 };
+
+		char inline_[INLINE_SIZE];
+		std::string heap_;
+		const char* str_{ nullptr };
+
+		char* reserve(size_t size);
+
+	public:
+		explicit NarrowString(const wchar_t* str);
+		NarrowString(const NarrowString&) = delete;
+		NarrowString(NarrowString&&) = delete;
+		~NarrowString() = default;
+		NarrowString& operator=(const NarrowString&) = delete;
+		NarrowString& operator=(NarrowString&&) = delete;
+
+		/*
+		 * Null if the wide string was.
+		 */
+		inline const char* c_str() const { return str_; }
+		inline operator const char*() const { return str_; }
+
+		/*
+		 * Convert into a reused std::string, for callers that keep many strings.
+		 */
+		static void convert(const wchar_t* str, std::string& out);
+	};
+
+}
+}
+}
@@ -0,0 +1,207 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <utility>
+
+#include "ObjectTracker.h"
+
+using namespace nl::rakis::interop;
+
+
+/*
+ * Angles in radians wrap at 2*pi, anything else is taken to be degrees.
+ */
+static double periodOf(const DataField& field)
+{
+	std::string units{ field.unitsName };
+	std::transform(units.begin(), units.end(), units.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+	return (units.rfind("radian", 0) == 0) ? 2.0 * std::numbers::pi : 360.0;
+}
+
+static double wrapDelta(double delta, double period)
+{
+	return (period == 0.0) ? delta : delta - period * std::round(delta / period);
+}
+
+ObjectTracker::ObjectTracker(const DataSchema& schema, const std::array<uint32_t, CHANNELS>& datums, int64_t maxExtrapolation, int64_t expiry)
+	: rowSize_(schema.size()), maxExtrapolation_(maxExtrapolation), expiry_(expiry)
+{
+	for (size_t channel = 0; channel < CHANNELS; channel++) {
+		fields_[channel] = schema.fields()[datums[channel]];
+		periods_[channel] = ((channel == Longitude) || (channel == Heading)) ? periodOf(fields_[channel]) : 0.0;
+	}
+}
+
+/*static*/ bool ObjectTracker::isTrackable(const DataSchema& schema, const std::array<uint32_t, CHANNELS>& datums)
+{
+	if (!schema.isFixedSize()) {
+		return false;
+	}
+	for (uint32_t datum : datums) {
+		if (datum >= schema.fields().size()) {
+			return false;
+		}
+		switch (schema.fields()[datum].datumType) {
+		case SIMCONNECT_DATATYPE_INT32:
+		case SIMCONNECT_DATATYPE_INT64:
+		case SIMCONNECT_DATATYPE_FLOAT32:
+		case SIMCONNECT_DATATYPE_FLOAT64:
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t ObjectTracker::size() const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	return objectIds_.size();
+}
+
+/*
+ * Called with the lock held. Expired objects are removed by moving the last object into their place.
+ */
+void ObjectTracker::purge(int64_t now)
+{
+	lastPurge_ = now;
+	for (size_t i = objectIds_.size(); i-- > 0; ) {
+		if (now - lastTimes_[i] <= expiry_) {
+			continue;
+		}
+		const size_t last{ objectIds_.size() - 1 };
+		index_.erase(objectIds_[i]);
+		if (i != last) {
+			objectIds_[i] = objectIds_[last];
+			lastTimes_[i] = lastTimes_[last];
+			spans_[i] = spans_[last];
+			for (size_t channel = 0; channel < CHANNELS; channel++) {
+				values_[channel][i] = values_[channel][last];
+				rates_[channel][i] = rates_[channel][last];
+			}
+			index_[objectIds_[i]] = i;
+		}
+		objectIds_.pop_back();
+		lastTimes_.pop_back();
+		spans_.pop_back();
+		for (size_t channel = 0; channel < CHANNELS; channel++) {
+			values_[channel].pop_back();
+			rates_[channel].pop_back();
+		}
+	}
+}
+
+bool ObjectTracker::update(uint32_t objectId, int64_t time, const void* row, size_t size)
+{
+	if (size < rowSize_) {
+		return false;
+	}
+	std::array<double, CHANNELS> values;
+	for (size_t channel = 0; channel < CHANNELS; channel++) {
+		values[channel] = DataSchema::toDouble(fields_[channel], row);
+	}
+
+	std::scoped_lock<std::mutex> lock(mutex_);
+	if (time - lastPurge_ > expiry_) {
+		purge(time);
+	}
+	auto [it, added] = index_.try_emplace(objectId, objectIds_.size());
+	const size_t i{ it->second };
+	if (added) {
+		objectIds_.push_back(objectId);
+		lastTimes_.push_back(time);
+		spans_.push_back(0);
+		for (size_t channel = 0; channel < CHANNELS; channel++) {
+			values_[channel].push_back(values[channel]);
+			rates_[channel].push_back(0.0);
+		}
+		return true;
+	}
+	const int64_t span{ time - lastTimes_[i] };
+	if (span <= 0) {
+		return false;
+	}
+	for (size_t channel = 0; channel < CHANNELS; channel++) {
+		rates_[channel][i] = wrapDelta(values[channel] - values_[channel][i], periods_[channel]) / double(span);
+		values_[channel][i] = values[channel];
+	}
+	lastTimes_[i] = time;
+	spans_[i] = span;
+	return true;
+}
+
+size_t ObjectTracker::sample(int64_t time, size_t capacity, uint32_t* objectIds, double* const* channels) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	size_t count{ 0 };
+	for (size_t i = 0; (i < objectIds_.size()) && (count < capacity); i++) {
+		if (time - lastTimes_[i] > expiry_) {
+			continue;
+		}
+		// Going back no further than the previous report interpolates; going forward extrapolates.
+		const double dt{ double(std::clamp(time - lastTimes_[i], -spans_[i], maxExtrapolation_)) };
+		if (objectIds != nullptr) {
+			objectIds[count] = objectIds_[i];
+		}
+		for (size_t channel = 0; (channels != nullptr) && (channel < CHANNELS); channel++) {
+			if (channels[channel] == nullptr) {
+				continue;
+			}
+			double value{ values_[channel][i] + rates_[channel][i] * dt };
+			if (channel == Heading) {
+				value -= periods_[channel] * std::floor(value / periods_[channel]);
+			}
+			else if (channel == Longitude) {
+				value = wrapDelta(value, periods_[channel]);
+			}
+			channels[channel][count] = value;
+		}
+		count++;
+	}
+	return count;
+}
+
+
+void ObjectTrackers::add(uint32_t requestId, std::shared_ptr<ObjectTracker> tracker)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	trackers_[requestId] = std::move(tracker);
+	count_.store(trackers_.size(), std::memory_order_release);
+}
+
+bool ObjectTrackers::remove(uint32_t requestId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	const bool removed{ trackers_.erase(requestId) > 0 };
+	count_.store(trackers_.size(), std::memory_order_release);
+	return removed;
+}
+
+std::shared_ptr<ObjectTracker> ObjectTrackers::find(uint32_t requestId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	auto it{ trackers_.find(requestId) };
+	return (it == trackers_.end()) ? nullptr : it->second;
+}
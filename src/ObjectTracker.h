@@ -0,0 +1,107 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "DataSchema.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Kinematic state of the objects reported by one data request, used to estimate their position at any time.
+	 * Each object keeps its last reported latitude, longitude, altitude and heading, plus the rate of change of each
+	 * since the report before. Between those two reports values are interpolated; after the last one they are
+	 * extrapolated, for at most maxExtrapolation. State is kept as one array per quantity.
+	 */
+	class ObjectTracker {
+	public:
+		enum Channel : size_t { Latitude, Longitude, Altitude, Heading, CHANNELS };
+
+	private:
+		std::array<DataField, CHANNELS> fields_;
+		std::array<double, CHANNELS> periods_;		// Angles wrap around at this value, 0 for plain values
+		uint32_t rowSize_;
+		int64_t maxExtrapolation_;
+		int64_t expiry_;
+
+		mutable std::mutex mutex_;
+		std::unordered_map<uint32_t, size_t> index_;
+		std::vector<uint32_t> objectIds_;
+		std::vector<int64_t> lastTimes_;
+		std::vector<int64_t> spans_;				// Time between the last two reports
+		std::array<std::vector<double>, CHANNELS> values_;
+		std::array<std::vector<double>, CHANNELS> rates_;	// Per microsecond
+		int64_t lastPurge_{ 0 };
+
+		void purge(int64_t now);
+
+	public:
+		/*
+		 * The datums are indexes into the schema's fields. Objects not reported for longer than expiry are dropped.
+		 */
+		ObjectTracker(const DataSchema& schema, const std::array<uint32_t, CHANNELS>& datums, int64_t maxExtrapolation, int64_t expiry);
+		ObjectTracker(const ObjectTracker&) = delete;
+		ObjectTracker(ObjectTracker&&) = delete;
+		~ObjectTracker() = default;
+		ObjectTracker& operator=(const ObjectTracker&) = delete;
+		ObjectTracker& operator=(ObjectTracker&&) = delete;
+
+		/*
+		 * Check that the datums exist and are numeric.
+		 */
+		static bool isTrackable(const DataSchema& schema, const std::array<uint32_t, CHANNELS>& datums);
+
+		size_t size() const;
+
+		bool update(uint32_t objectId, int64_t time, const void* row, size_t size);
+
+		/*
+		 * Estimate the position of all live objects at the given time into the output arrays, up to capacity.
+		 * Null outputs are skipped. Returns the number of objects written.
+		 */
+		size_t sample(int64_t time, size_t capacity, uint32_t* objectIds, double* const* channels) const;
+	};
+
+	/*
+	 * The object trackers of a single connection, keyed by requestId.
+	 */
+	class ObjectTrackers {
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<ObjectTracker>> trackers_;
+		std::atomic<size_t> count_{ 0 };
+
+	public:
+		void add(uint32_t requestId, std::shared_ptr<ObjectTracker> tracker);
+		bool remove(uint32_t requestId);
+		std::shared_ptr<ObjectTracker> find(uint32_t requestId) const;
+
+		inline bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+	};
+
+}
+}
+}
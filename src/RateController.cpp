@@ -0,0 +1,151 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "RateController.h"
+
+using namespace nl::rakis::interop;
+
+
+RateController::RateController(const RateLimits& limits, uint32_t interval, int64_t now)
+	: limits_(limits), interval_(std::clamp(interval, limits.minInterval, limits.maxInterval)), windowStart_(now)
+{
+	changed(now, interval_);
+}
+
+void RateController::changed(int64_t time, uint32_t interval)
+{
+	changes_[changeCount_ % HISTORY] = Change{ time, interval };
+	changeCount_++;
+}
+
+std::optional<uint32_t> RateController::record(int64_t time, int64_t busy)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	busy_ += busy;
+	const int64_t elapsed{ time - windowStart_ };
+	if (elapsed < limits_.window) {
+		return std::nullopt;
+	}
+	const double load{ double(busy_) / double(elapsed) };
+	const bool behind{ (load > limits_.highLoad) || (depth_ > limits_.maxDepth) };
+	const bool idle{ (load < limits_.lowLoad) && (depth_ <= limits_.maxDepth / 4) };
+	windowStart_ = time;
+	busy_ = 0;
+	depth_ = 0;
+
+	if (behind) {
+		run_ = std::max(run_, 0) + 1;
+	}
+	else if (idle) {
+		run_ = std::min(run_, 0) - 1;
+	}
+	else {
+		run_ = 0;
+	}
+	if (uint32_t(std::abs(run_)) < std::max(limits_.hold, 1u)) {
+		return std::nullopt;
+	}
+	const uint32_t next{ (run_ > 0) ? std::min(limits_.maxInterval, std::max(interval_ + 1, interval_ * 2)) : std::max(limits_.minInterval, interval_ / 2) };
+	run_ = 0;
+	if (next == interval_) {
+		return std::nullopt;
+	}
+	interval_ = next;
+	changed(time, next);
+	return next;
+}
+
+void RateController::reportDepth(uint32_t depth)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	depth_ = std::max(depth_, depth);
+}
+
+uint32_t RateController::interval() const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	return interval_;
+}
+
+size_t RateController::history(size_t capacity, int64_t* times, uint32_t* intervals) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	const uint64_t available{ std::min<uint64_t>(changeCount_, HISTORY) };
+	const size_t count{ size_t(std::min<uint64_t>(available, capacity)) };
+	const uint64_t first{ changeCount_ - count };
+	for (size_t i = 0; i < count; i++) {
+		const Change& change{ changes_[(first + i) % HISTORY] };
+		if (times != nullptr) {
+			times[i] = change.time;
+		}
+		if (intervals != nullptr) {
+			intervals[i] = change.interval;
+		}
+	}
+	return count;
+}
+
+
+void RateControllers::add(uint32_t requestId, std::shared_ptr<RateController> controller)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	controllers_[requestId] = std::move(controller);
+	count_.store(controllers_.size(), std::memory_order_release);
+}
+
+bool RateControllers::remove(uint32_t requestId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	const bool removed{ controllers_.erase(requestId) > 0 };
+	count_.store(controllers_.size(), std::memory_order_release);
+	lock.unlock();
+
+	std::scoped_lock<std::mutex> changesLock(changesMutex_);
+	changes_.erase(requestId);
+	return removed;
+}
+
+std::shared_ptr<RateController> RateControllers::find(uint32_t requestId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	auto it{ controllers_.find(requestId) };
+	return (it == controllers_.end()) ? nullptr : it->second;
+}
+
+void RateControllers::post(uint32_t requestId, uint32_t interval)
+{
+	std::scoped_lock<std::mutex> lock(changesMutex_);
+	changes_[requestId] = interval;
+	changed_.store(true, std::memory_order_release);
+}
+
+bool RateControllers::take(std::vector<std::pair<uint32_t, uint32_t>>& changes)
+{
+	std::scoped_lock<std::mutex> lock(changesMutex_);
+	changes.assign(changes_.begin(), changes_.end());
+	changes_.clear();
+	changed_.store(false, std::memory_order_release);
+	return !changes.empty();
+}
@@ -0,0 +1,138 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Bounds and thresholds of a rate controller. The load is the fraction of wall time spent handling the
+	 * subscription's messages; the depth is the largest queue depth the consumer reported.
+	 */
+	struct RateLimits {
+		uint32_t minInterval;
+		uint32_t maxInterval;
+		int64_t window;			// Microseconds per evaluation
+		uint32_t hold;			// Windows in a row with the same verdict before the interval changes
+		double highLoad;
+		double lowLoad;
+		uint32_t maxDepth;		// Above this the consumer is behind; at a quarter of it or less, it keeps up
+	};
+
+	/*
+	 * Chooses the interval of one periodic data request from the lag of its consumer. The interval doubles while
+	 * the consumer is behind and halves while it is idle, within the limits. The last changes are kept, so the
+	 * chosen rate can be followed over time.
+	 */
+	class RateController {
+	public:
+		static constexpr size_t HISTORY{ 64 };
+
+		struct Change {
+			int64_t time;
+			uint32_t interval;
+		};
+
+	private:
+		RateLimits limits_;
+
+		mutable std::mutex mutex_;
+		uint32_t interval_;
+		int64_t windowStart_;
+		int64_t busy_{ 0 };
+		uint32_t depth_{ 0 };
+		int32_t run_{ 0 };					// Positive while behind, negative while idle
+		std::array<Change, HISTORY> changes_{};
+		uint64_t changeCount_{ 0 };
+
+		void changed(int64_t time, uint32_t interval);
+
+	public:
+		RateController(const RateLimits& limits, uint32_t interval, int64_t now);
+		RateController(const RateController&) = delete;
+		RateController(RateController&&) = delete;
+		~RateController() = default;
+		RateController& operator=(const RateController&) = delete;
+		RateController& operator=(RateController&&) = delete;
+
+		/*
+		 * Account for one message that took "busy" microseconds to handle. Returns the new interval if the request
+		 * should be sent again.
+		 */
+		std::optional<uint32_t> record(int64_t time, int64_t busy);
+
+		/*
+		 * Queue depth reported by the consumer, taken into account at the end of the current window.
+		 */
+		void reportDepth(uint32_t depth);
+
+		uint32_t interval() const;
+
+		/*
+		 * Copy the most recent changes, oldest first, up to capacity. The first entry is the initial interval as long
+		 * as it has not been pushed out. Returns the number of entries written.
+		 */
+		size_t history(size_t capacity, int64_t* times, uint32_t* intervals) const;
+	};
+
+	/*
+	 * The rate controllers of a single connection, keyed by requestId. New intervals chosen on the dispatch path are
+	 * posted here, and sent later by a thread that can take the lock on SimConnect.
+	 */
+	class RateControllers {
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<RateController>> controllers_;
+		std::atomic<size_t> count_{ 0 };
+
+		std::mutex changesMutex_;
+		std::map<uint32_t, uint32_t> changes_;			// Intervals not sent yet, by requestId
+		std::atomic<bool> changed_{ false };
+
+	public:
+		void add(uint32_t requestId, std::shared_ptr<RateController> controller);
+		bool remove(uint32_t requestId);
+		std::shared_ptr<RateController> find(uint32_t requestId) const;
+
+		inline bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+
+		/*
+		 * Keep a new interval to send, replacing one for the same request that was not sent yet.
+		 */
+		void post(uint32_t requestId, uint32_t interval);
+
+		/*
+		 * Move the posted intervals into "changes", returning false if there were none.
+		 */
+		bool take(std::vector<std::pair<uint32_t, uint32_t>>& changes);
+
+		inline bool hasChanges() const { return changed_.load(std::memory_order_acquire); }
+	};
+
+}
+}
+}
@@ -0,0 +1,275 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "RequestScheduler.h"
+
+using namespace nl::rakis::interop;
+
+
+enum class Resource : uint64_t {
+	DataDefinition = 1,
+	ClientDataDefinition = 2,
+	ClientData = 3,
+	ClientEvent = 4,
+};
+
+static inline uint64_t resource(Resource kind, uint32_t id)
+{
+	return (uint64_t(kind) << 32) | id;
+}
+
+/*
+ * The ids a request registers, or depends on having been registered. Returns the number of ids.
+ */
+static size_t resourcesOf(const Request& request, bool& registration, std::array<uint64_t, 2>& resources)
+{
+	const auto& args{ request.args };
+
+	registration = false;
+	switch (request.op) {
+	case RequestOp::AddToDataDefinition:
+	case RequestOp::ClearDataDefinition:
+		registration = true;
+		[[fallthrough]];
+	case RequestOp::SetDataOnSimObject:
+		resources[0] = resource(Resource::DataDefinition, args[0]);
+		return 1;
+	case RequestOp::RequestDataOnSimObject:
+	case RequestOp::RequestDataOnSimObjectType:
+		resources[0] = resource(Resource::DataDefinition, args[1]);
+		return 1;
+	case RequestOp::AddToClientDataDefinition:
+	case RequestOp::ClearClientDataDefinition:
+		registration = true;
+		resources[0] = resource(Resource::ClientDataDefinition, args[0]);
+		return 1;
+	case RequestOp::CreateClientData:
+	case RequestOp::MapClientDataNameToID:
+		registration = true;
+		resources[0] = resource(Resource::ClientData, args[0]);
+		return 1;
+	case RequestOp::RequestClientData:
+		resources[0] = resource(Resource::ClientData, args[0]);
+		resources[1] = resource(Resource::ClientDataDefinition, args[2]);
+		return 2;
+	case RequestOp::SetClientData:
+		resources[0] = resource(Resource::ClientData, args[0]);
+		resources[1] = resource(Resource::ClientDataDefinition, args[1]);
+		return 2;
+	case RequestOp::MapClientEventToSimEvent:
+		registration = true;
+		resources[0] = resource(Resource::ClientEvent, args[0]);
+		return 1;
+	case RequestOp::AddClientEventToNotificationGroup:
+	case RequestOp::TransmitClientEvent:
+	case RequestOp::TransmitClientEvent64:
+		resources[0] = resource(Resource::ClientEvent, args[1]);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+
+void RequestScheduler::start(Sender send)
+{
+	stop();
+
+	std::scoped_lock<std::mutex> lock(mutex_);
+	stopping_ = false;
+	running_.store(true, std::memory_order_release);
+	sender_ = std::thread([this, send]() { run(send); });
+}
+
+size_t RequestScheduler::stop()
+{
+	std::vector<Completion> dropped;
+	size_t count{ 0 };
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+		stopping_ = true;
+		running_.store(false, std::memory_order_release);
+	}
+	cv_.notify_all();
+	if (sender_.joinable()) {
+		sender_.join();
+	}
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+		for (auto& lane : lanes_) {
+			count += lane.entries.size();
+			for (auto& entry : lane.entries) {
+				if (entry.done) {
+					dropped.push_back(std::move(entry.done));
+				}
+			}
+			lane.entries.clear();
+			lane.stats.queued = 0;
+		}
+		registrations_.clear();
+	}
+	sent_.notify_all();
+	for (const auto& done : dropped) {
+		done(E_ABORT);
+	}
+	return count;
+}
+
+void RequestScheduler::submit(RequestPriority priority, const Request& request, Completion done)
+{
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+		auto& lane{ lanes_[size_t(priority)] };
+		Entry entry{ request, std::move(done), Clock::now(), nextSequence_++ };
+		entry.resourceCount = resourcesOf(entry.request, entry.registration, entry.resources);
+		if (entry.registration) {
+			registrations_[entry.resources[0]].push_back(entry.sequence);
+		}
+		lane.entries.push_back(std::move(entry));
+		lane.stats.submitted++;
+		lane.stats.queued = lane.entries.size();
+	}
+	cv_.notify_one();
+}
+
+void RequestScheduler::drain()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	const uint64_t mark{ nextSequence_ };
+	sent_.wait(lock, [this, mark]() {
+		return (inFlight_ >= mark) && std::all_of(lanes_.begin(), lanes_.end(), [mark](const Lane& lane) {
+			return lane.entries.empty() || (lane.entries.front().sequence >= mark);
+		});
+	});
+}
+
+void RequestScheduler::setRateLimit(RequestPriority priority, double requestsPerSecond, uint32_t burst)
+{
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+		auto& lane{ lanes_[size_t(priority)] };
+		lane.rate = std::max(requestsPerSecond, 0.0);
+		lane.burst = std::max(burst, 1u);
+		lane.tokens = lane.burst;
+		lane.refilled = Clock::now();
+	}
+	cv_.notify_one();
+}
+
+SchedulerStatistics RequestScheduler::statistics(RequestPriority priority) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	return lanes_[size_t(priority)].stats;
+}
+
+/*
+ * A request can be sent once no registration of an id it uses, submitted before it, is still queued.
+ */
+bool RequestScheduler::ready(const Entry& entry) const
+{
+	for (size_t i = 0; i < entry.resourceCount; i++) {
+		if (auto it = registrations_.find(entry.resources[i]); (it != registrations_.end()) && (it->second.front() < entry.sequence)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Token bucket check. If the lane has work but no token, the time the next token arrives is merged into wakeup.
+ * A lane waiting for a registration in another lane is skipped; it is woken when that registration is sent.
+ */
+bool RequestScheduler::take(Lane& lane, Clock::time_point now, Clock::time_point& wakeup)
+{
+	if (lane.entries.empty() || !ready(lane.entries.front())) {
+		return false;
+	}
+	if (lane.rate == 0.0) {
+		return true;
+	}
+	std::chrono::duration<double> elapsed{ now - lane.refilled };
+	lane.tokens = std::min(lane.burst, lane.tokens + elapsed.count() * lane.rate);
+	lane.refilled = now;
+	if (lane.tokens >= 1.0) {
+		lane.tokens -= 1.0;
+		return true;
+	}
+	auto next{ now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((1.0 - lane.tokens) / lane.rate)) };
+	wakeup = std::min(wakeup, next);
+	return false;
+}
+
+void RequestScheduler::run(Sender send)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	while (!stopping_) {
+		auto now{ Clock::now() };
+		auto wakeup{ Clock::time_point::max() };
+		Lane* lane{ nullptr };
+		for (auto& candidate : lanes_) {
+			if (take(candidate, now, wakeup)) {
+				lane = &candidate;
+				break;
+			}
+		}
+		if (lane == nullptr) {
+			if (wakeup == Clock::time_point::max()) {
+				cv_.wait(lock);
+			}
+			else {
+				cv_.wait_until(lock, wakeup);
+			}
+			continue;
+		}
+		Entry entry{ std::move(lane->entries.front()) };
+		lane->entries.pop_front();
+		lane->stats.queued = lane->entries.size();
+		if (entry.registration) {
+			auto it{ registrations_.find(entry.resources[0]) };
+			it->second.pop_front();
+			if (it->second.empty()) {
+				registrations_.erase(it);
+			}
+		}
+		inFlight_ = entry.sequence;
+		uint64_t waited = std::chrono::duration_cast<std::chrono::microseconds>(now - entry.queued).count();
+
+		lock.unlock();
+		const long result{ send(entry.request) };
+		if (entry.done) {
+			entry.done(result);
+		}
+		lock.lock();
+
+		inFlight_ = NOT_SENDING;
+		sent_.notify_all();
+
+		if (result > 0) {
+			lane->stats.sent++;
+		}
+		else {
+			lane->stats.failed++;
+		}
+		lane->stats.maxWaitMicros = std::max(lane->stats.maxWaitMicros, waited);
+		lane->stats.totalWaitMicros += waited;
+	}
+}
@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Requests.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	struct SchedulerStatistics {
+		uint64_t submitted;
+		uint64_t sent;
+		uint64_t failed;
+		uint64_t queued;
+		uint64_t maxWaitMicros;
+		uint64_t totalWaitMicros;
+	};
+
+	/*
+	 * Queues outbound requests per priority class and sends them from a single thread, always taking the highest
+	 * class that has a request and is within its rate limit. A realtime request therefore never waits for more
+	 * than the one call that is already in progress, however much bulk work is queued.
+	 *
+	 * Calls that depend on a registration (a data request on a data definition, an event sent with a mapped client
+	 * event id, and so on) are never sent before a registration of the same id submitted earlier, whatever their
+	 * class. Registrations of the same id are sent in the order they were submitted. A class stays first-in
+	 * first-out, so a call waiting for a registration also holds back the calls queued behind it in its class.
+	 */
+	class RequestScheduler {
+	public:
+		// Both take the result of a call as the Cs* functions return it: a SendID (or TRUE), or a failed HRESULT.
+		using Sender = std::function<long(const Request&)>;
+		using Completion = std::function<void(long result)>;
+
+		static constexpr size_t CLASSES{ size_t(RequestPriority::Count) };
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr size_t MAX_RESOURCES{ 2 };
+
+		struct Entry {
+			Request request;
+			Completion done;
+			Clock::time_point queued;
+			uint64_t sequence;
+			bool registration;
+			size_t resourceCount;
+			std::array<uint64_t, MAX_RESOURCES> resources;	// The ids it registers or depends on
+		};
+
+		struct Lane {
+			std::deque<Entry> entries;
+			double rate{ 0.0 };			// Requests per second, 0 is unlimited
+			double burst{ 1.0 };
+			double tokens{ 0.0 };
+			Clock::time_point refilled;
+			SchedulerStatistics stats{};
+		};
+		std::array<Lane, CLASSES> lanes_;
+
+		uint64_t nextSequence_{ 0 };
+		uint64_t inFlight_{ NOT_SENDING };
+		std::unordered_map<uint64_t, std::deque<uint64_t>> registrations_;	// Sequence numbers of queued registrations, by id
+
+		static constexpr uint64_t NOT_SENDING{ UINT64_MAX };
+
+		mutable std::mutex mutex_;
+		std::condition_variable cv_;
+		std::condition_variable sent_;
+		std::thread sender_;
+		std::atomic<bool> running_{ false };
+		bool stopping_{ false };
+
+		bool ready(const Entry& entry) const;
+		bool take(Lane& lane, Clock::time_point now, Clock::time_point& wakeup);
+		void run(Sender send);
+
+	public:
+		RequestScheduler() = default;
+		RequestScheduler(const RequestScheduler&) = delete;
+		RequestScheduler(RequestScheduler&&) = delete;
+		~RequestScheduler() { stop(); }
+		RequestScheduler& operator=(const RequestScheduler&) = delete;
+		RequestScheduler& operator=(RequestScheduler&&) = delete;
+
+		void start(Sender send);
+
+		/*
+		 * Stop the sender thread. Requests still queued are dropped, and their completions called with E_ABORT.
+		 */
+		size_t stop();
+
+		inline bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+		/*
+		 * Queue a request. The completion, if any, is called on the sender thread with the result once it was sent.
+		 */
+		void submit(RequestPriority priority, const Request& request, Completion done = nullptr);
+
+		/*
+		 * Wait until every request submitted before this call was sent, or the scheduler was stopped.
+		 */
+		void drain();
+
+		/*
+		 * Limit a class to a number of requests per second, allowing bursts of up to "burst" requests.
+		 */
+		void setRateLimit(RequestPriority priority, double requestsPerSecond, uint32_t burst);
+
+		SchedulerStatistics statistics(RequestPriority priority) const;
+	};
+
+}
+}
+}
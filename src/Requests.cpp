@@ -0,0 +1,244 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "Requests.h"
+
+using namespace nl::rakis::interop;
+
+
+static constexpr auto REALTIME{ RequestPriority::Realtime };
+static constexpr auto NORMAL{ RequestPriority::Normal };
+static constexpr auto BULK{ RequestPriority::Bulk };
+
+static const RequestOpInfo opInfo[] = {
+	{ "None", 0, 0, false, NORMAL },
+	{ "AddToDataDefinition", 4, 2, false, BULK },
+	{ "ClearDataDefinition", 1, 0, false, BULK },
+	{ "AddToClientDataDefinition", 5, 0, false, BULK },
+	{ "ClearClientDataDefinition", 1, 0, false, BULK },
+	{ "CreateClientData", 3, 0, false, BULK },
+	{ "MapClientDataNameToID", 1, 1, false, BULK },
+	{ "MapClientEventToSimEvent", 1, 1, false, BULK },
+	{ "MapInputEventToClientEvent", 6, 1, false, BULK },
+	{ "AddClientEventToNotificationGroup", 3, 0, false, BULK },
+	{ "RemoveClientEvent", 2, 0, false, BULK },
+	{ "SetNotificationGroupPriority", 2, 0, false, BULK },
+	{ "ClearNotificationGroup", 1, 0, false, BULK },
+	{ "RequestNotificationGroup", 1, 0, false, NORMAL },
+	{ "SubscribeToSystemEvent", 1, 1, false, BULK },
+	{ "RequestDataOnSimObject", 8, 0, false, NORMAL },
+	{ "RequestClientData", 8, 0, false, NORMAL },
+	{ "TransmitClientEvent", 5, 0, false, REALTIME },
+	{ "TransmitClientEvent64", 6, 0, false, REALTIME },
+	{ "SetClientData", 4, 0, true, NORMAL },
+	{ "RequestSystemState", 1, 1, false, NORMAL },
+	{ "RequestDataOnSimObjectType", 4, 0, false, NORMAL },
+	{ "SetDataOnSimObject", 5, 0, true, NORMAL },
+	{ "AICreateEnrouteATCAircraft", 3, 3, true, BULK },
+	{ "AICreateNonATCAircraft", 1, 2, true, BULK },
+	{ "AICreateParkedATCAircraft", 1, 3, false, BULK },
+	{ "AICreateSimulatedObject", 1, 1, true, BULK },
+	{ "AIRemoveObject", 2, 0, false, BULK },
+};
+static_assert(std::size(opInfo) == size_t(RequestOp::Count), "Every RequestOp needs an entry in opInfo");
+
+/*static*/ const RequestOpInfo& Request::info(RequestOp op)
+{
+	return (op < RequestOp::Count) ? opInfo[size_t(op)] : opInfo[0];
+}
+
+/*static*/ uint32_t Request::fromFloat(float value)
+{
+	return std::bit_cast<uint32_t>(value);
+}
+
+/*static*/ float Request::toFloat(uint32_t value)
+{
+	return std::bit_cast<float>(value);
+}
+
+static inline const char* optional(const Name& s)
+{
+	return s.empty() ? nullptr : s.c_str();
+}
+
+template <typename T>
+static inline T payloadAs(const Payload& payload)
+{
+	T value{};
+	std::memcpy(&value, payload.data(), std::min(sizeof(T), payload.size()));
+	return value;
+}
+
+HRESULT Request::execute(HANDLE handle) const
+{
+	const auto& a{ args };
+
+	switch (op) {
+	case RequestOp::AddToDataDefinition:
+		return SimConnect_AddToDataDefinition(handle, a[0], strings[0].c_str(), optional(strings[1]), SIMCONNECT_DATATYPE(a[1]), toFloat(a[2]), a[3]);
+	case RequestOp::ClearDataDefinition:
+		return SimConnect_ClearDataDefinition(handle, a[0]);
+	case RequestOp::AddToClientDataDefinition:
+		return SimConnect_AddToClientDataDefinition(handle, a[0], a[1], a[2], toFloat(a[3]), a[4]);
+	case RequestOp::ClearClientDataDefinition:
+		return SimConnect_ClearClientDataDefinition(handle, a[0]);
+	case RequestOp::CreateClientData:
+		return SimConnect_CreateClientData(handle, a[0], a[1], a[2]);
+	case RequestOp::MapClientDataNameToID:
+		return SimConnect_MapClientDataNameToID(handle, strings[0].c_str(), a[0]);
+	case RequestOp::MapClientEventToSimEvent:
+		return SimConnect_MapClientEventToSimEvent(handle, a[0], strings[0].c_str());
+	case RequestOp::MapInputEventToClientEvent:
+		return SimConnect_MapInputEventToClientEvent(handle, a[0], strings[0].c_str(), a[1], a[2], a[3], a[4], a[5]);
+	case RequestOp::AddClientEventToNotificationGroup:
+		return SimConnect_AddClientEventToNotificationGroup(handle, a[0], a[1], a[2]);
+	case RequestOp::RemoveClientEvent:
+		return SimConnect_RemoveClientEvent(handle, a[0], a[1]);
+	case RequestOp::SetNotificationGroupPriority:
+		return SimConnect_SetNotificationGroupPriority(handle, a[0], a[1]);
+	case RequestOp::ClearNotificationGroup:
+		return SimConnect_ClearNotificationGroup(handle, a[0]);
+	case RequestOp::RequestNotificationGroup:
+		return SimConnect_RequestNotificationGroup(handle, a[0]);
+	case RequestOp::SubscribeToSystemEvent:
+		return SimConnect_SubscribeToSystemEvent(handle, a[0], strings[0].c_str());
+	case RequestOp::RequestDataOnSimObject:
+		return SimConnect_RequestDataOnSimObject(handle, a[0], a[1], a[2], SIMCONNECT_PERIOD(a[3]), a[4], a[5], a[6], a[7]);
+	case RequestOp::RequestClientData:
+		return SimConnect_RequestClientData(handle, a[0], a[1], a[2], SIMCONNECT_CLIENT_DATA_PERIOD(a[3]), a[4], a[5], a[6], a[7]);
+	case RequestOp::TransmitClientEvent:
+		return SimConnect_TransmitClientEvent(handle, a[0], a[1], a[2], a[3], a[4]);
+#if IS_PREPAR3D
+	case RequestOp::TransmitClientEvent64:
+		return SimConnect_TransmitClientEvent64(handle, a[0], a[1], (uint64_t(a[3]) << 32) | a[2], a[4], a[5]);
+#endif
+	case RequestOp::SetClientData:
+		return SimConnect_SetClientData(handle, a[0], a[1], a[2], 0, a[3], const_cast<uint8_t*>(payload.data()));
+	case RequestOp::RequestSystemState:
+		return SimConnect_RequestSystemState(handle, a[0], strings[0].c_str());
+	case RequestOp::RequestDataOnSimObjectType:
+		return SimConnect_RequestDataOnSimObjectType(handle, a[0], a[1], a[2], SIMCONNECT_SIMOBJECT_TYPE(a[3]));
+	case RequestOp::SetDataOnSimObject:
+		return SimConnect_SetDataOnSimObject(handle, a[0], a[1], a[2], a[3], a[4], const_cast<uint8_t*>(payload.data()));
+	case RequestOp::AICreateEnrouteATCAircraft:
+		return SimConnect_AICreateEnrouteATCAircraft(handle, strings[0].c_str(), strings[1].c_str(), a[0], strings[2].c_str(), payloadAs<double>(payload), a[1], a[2]);
+	case RequestOp::AICreateNonATCAircraft:
+		return SimConnect_AICreateNonATCAircraft(handle, strings[0].c_str(), strings[1].c_str(), payloadAs<SIMCONNECT_DATA_INITPOSITION>(payload), a[0]);
+	case RequestOp::AICreateParkedATCAircraft:
+		return SimConnect_AICreateParkedATCAircraft(handle, strings[0].c_str(), strings[1].c_str(), strings[2].c_str(), a[0]);
+	case RequestOp::AICreateSimulatedObject:
+		return SimConnect_AICreateSimulatedObject(handle, strings[0].c_str(), payloadAs<SIMCONNECT_DATA_INITPOSITION>(payload), a[0]);
+	case RequestOp::AIRemoveObject:
+		return SimConnect_AIRemoveObject(handle, a[0], a[1]);
+	default:
+		return E_INVALIDARG;
+	}
+}
+
+bool Request::encode(std::vector<uint8_t>& out) const
+{
+	const auto& opInfo{ info() };
+	size_t start{ out.size() };
+
+	out.resize(start + 2 * sizeof(uint16_t) + opInfo.argCount * sizeof(uint32_t));
+	uint16_t header[2]{ uint16_t(op), 0 };
+	std::memcpy(out.data() + start + sizeof(header), args.data(), opInfo.argCount * sizeof(uint32_t));
+	for (size_t i = 0; i < opInfo.stringCount; i++) {
+		out.insert(out.end(), strings[i].begin(), strings[i].end());
+		out.push_back(0);
+	}
+	if (opInfo.hasPayload) {
+		out.insert(out.end(), payload.begin(), payload.end());
+	}
+	if (out.size() - start > UINT16_MAX) {
+		out.resize(start);
+		return false;
+	}
+	header[1] = uint16_t(out.size() - start);
+	std::memcpy(out.data() + start, header, sizeof(header));
+	return true;
+}
+
+/*static*/ bool Request::decode(const uint8_t*& pos, const uint8_t* end, Request& request)
+{
+	uint16_t header[2];
+
+	if (size_t(end - pos) < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(header, pos, sizeof(header));
+	if ((header[0] == uint16_t(RequestOp::None)) || (header[0] >= uint16_t(RequestOp::Count)) || (header[1] < sizeof(header)) || (header[1] > size_t(end - pos))) {
+		return false;
+	}
+	const uint8_t* recordEnd{ pos + header[1] };
+	const uint8_t* p{ pos + sizeof(header) };
+
+	request.op = RequestOp(header[0]);
+	const auto& opInfo{ request.info() };
+	if (size_t(recordEnd - p) < opInfo.argCount * sizeof(uint32_t)) {
+		return false;
+	}
+	request.args.fill(0);
+	std::memcpy(request.args.data(), p, opInfo.argCount * sizeof(uint32_t));
+	p += opInfo.argCount * sizeof(uint32_t);
+
+	for (size_t i = 0; i < Request::MAX_STRINGS; i++) {
+		if (i < opInfo.stringCount) {
+			auto nul{ static_cast<const uint8_t*>(std::memchr(p, 0, recordEnd - p)) };
+			if (nul == nullptr) {
+				return false;
+			}
+			request.strings[i].assign(reinterpret_cast<const char*>(p), nul - p);	// Copied, like the payload
+			p = nul + 1;
+		}
+		else {
+			request.strings[i] = Name();
+		}
+	}
+	if (opInfo.hasPayload) {
+		const Payload borrowed(p, recordEnd - p);
+		request.payload = borrowed;		// Copied, so it does not point into the manifest
+		p = recordEnd;
+	}
+	else {
+		request.payload = Payload();
+	}
+	if (p != recordEnd) {
+		return false;
+	}
+	pos = recordEnd;
+	return true;
+}
+
+/*static*/ bool Request::decodeAll(const void* data, size_t size, std::vector<Request>& requests)
+{
+	auto pos{ static_cast<const uint8_t*>(data) };
+	auto end{ pos + size };
+
+	while (pos < end) {
+		if (!decode(pos, end, requests.emplace_back())) {
+			requests.pop_back();
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,214 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "framework.h"
+#include <SimConnect.h>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * The SimConnect calls that can be described as data. The numeric values are part of the manifest format
+	 * and must not change.
+	 */
+	enum class RequestOp : uint16_t {
+		None = 0,
+		AddToDataDefinition = 1,				// defId, datumType, epsilon, datumId; datumName, unitsName
+		ClearDataDefinition = 2,				// defId
+		AddToClientDataDefinition = 3,			// defId, offset, sizeOrType, epsilon, datumId
+		ClearClientDataDefinition = 4,			// defId
+		CreateClientData = 5,					// clientDataId, size, flags
+		MapClientDataNameToID = 6,				// clientDataId; clientDataName
+		MapClientEventToSimEvent = 7,			// eventId; eventName
+		MapInputEventToClientEvent = 8,			// groupId, downEventId, downValue, upEventId, upValue, maskable; inputDefinition
+		AddClientEventToNotificationGroup = 9,	// groupId, eventId, maskable
+		RemoveClientEvent = 10,					// groupId, eventId
+		SetNotificationGroupPriority = 11,		// groupId, priority
+		ClearNotificationGroup = 12,			// groupId
+		RequestNotificationGroup = 13,			// groupId
+		SubscribeToSystemEvent = 14,			// eventId; eventName
+		RequestDataOnSimObject = 15,			// requestId, defId, objectId, period, flags, origin, interval, limit
+		RequestClientData = 16,					// clientDataId, requestId, defId, period, flags, origin, interval, limit
+		TransmitClientEvent = 17,				// objectId, eventId, data, groupId, flags
+		TransmitClientEvent64 = 18,				// objectId, eventId, dataLow, dataHigh, groupId, flags (Prepar3D only)
+		SetClientData = 19,						// clientDataId, defId, flags, unitSize; data
+		RequestSystemState = 20,				// requestId; stateName
+		RequestDataOnSimObjectType = 21,		// requestId, defId, radius, objectType
+		SetDataOnSimObject = 22,				// defId, objectId, flags, count, unitSize; data
+		AICreateEnrouteATCAircraft = 23,		// flightNumber, touchAndGo, requestId; title, tailNumber, flightPlanPath; flightPlanPosition
+		AICreateNonATCAircraft = 24,			// requestId; title, tailNumber; initPos
+		AICreateParkedATCAircraft = 25,			// requestId; title, tailNumber, airportId
+		AICreateSimulatedObject = 26,			// requestId; title; initPos
+		AIRemoveObject = 27,					// objectId, requestId
+
+		Count
+	};
+
+	/*
+	 * Scheduling classes, in order of precedence.
+	 */
+	enum class RequestPriority : uint8_t {
+		Realtime = 0,
+		Normal = 1,
+		Bulk = 2,
+
+		Count
+	};
+
+	struct RequestOpInfo {
+		const char* api;
+		uint8_t argCount;
+		uint8_t stringCount;
+		bool hasPayload;
+		RequestPriority priority;
+	};
+
+	/*
+	 * The binary argument of a call. It borrows the caller's buffer until it is copied, so a request that is sent
+	 * immediately costs no allocation, while a queued copy owns its data.
+	 */
+	class Payload {
+		std::vector<uint8_t> owned_;
+		const uint8_t* data_{ nullptr };
+		size_t size_{ 0 };
+
+	public:
+		Payload() = default;
+		Payload(const void* data, size_t size) : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+		Payload(const Payload& other) : owned_(other.begin(), other.end()), data_(owned_.data()), size_(owned_.size()) {}
+		Payload(Payload&& other) noexcept { *this = std::move(other); }
+		~Payload() = default;
+
+		Payload& operator=(const Payload& other) {
+			if (this != &other) {
+				owned_.assign(other.begin(), other.end());
+				data_ = owned_.data();
+				size_ = owned_.size();
+			}
+			return *this;
+		}
+		Payload& operator=(Payload&& other) noexcept {
+			if (this != &other) {
+				bool owned{ other.data_ == other.owned_.data() };
+				owned_ = std::move(other.owned_);
+				data_ = owned ? owned_.data() : other.data_;
+				size_ = other.size_;
+				other.data_ = nullptr;
+				other.size_ = 0;
+			}
+			return *this;
+		}
+
+		inline const uint8_t* data() const { return data_; }
+		inline size_t size() const { return size_; }
+		inline bool empty() const { return size_ == 0; }
+		inline const uint8_t* begin() const { return data_; }
+		inline const uint8_t* end() const { return data_ + size_; }
+	};
+
+	/*
+	 * A name argument of a call. Like Payload it borrows the caller's string until it is copied, so the names of a
+	 * request sent immediately are not copied per call. A null pointer is taken as the empty string.
+	 */
+	class Name {
+		std::string owned_;
+		const char* data_{ "" };
+		size_t size_{ 0 };
+
+	public:
+		Name() = default;
+		Name(const char* s) : data_((s != nullptr) ? s : ""), size_(std::char_traits<char>::length(data_)) {}
+		Name(const std::string& s) : data_(s.c_str()), size_(s.size()) {}
+		Name(const Name& other) : owned_(other.data_, other.size_), data_(owned_.c_str()), size_(owned_.size()) {}
+		Name(Name&& other) noexcept { *this = std::move(other); }
+		~Name() = default;
+
+		Name& operator=(const Name& other) {
+			if (this != &other) {
+				assign(other.data_, other.size_);
+			}
+			return *this;
+		}
+		Name& operator=(Name&& other) noexcept {
+			if (this != &other) {
+				bool owned{ other.data_ == other.owned_.c_str() };
+				owned_ = std::move(other.owned_);
+				data_ = owned ? owned_.c_str() : other.data_;
+				size_ = other.size_;
+				other.data_ = "";
+				other.size_ = 0;
+			}
+			return *this;
+		}
+
+		/*
+		 * Take a copy of the given characters, which need not be NUL-terminated.
+		 */
+		void assign(const char* s, size_t size) {
+			owned_.assign(s, size);
+			data_ = owned_.c_str();
+			size_ = owned_.size();
+		}
+
+		inline const char* c_str() const { return data_; }
+		inline size_t size() const { return size_; }
+		inline bool empty() const { return size_ == 0; }
+		inline const char* begin() const { return data_; }
+		inline const char* end() const { return data_ + size_; }
+	};
+
+	/*
+	 * A single SimConnect call with its arguments. Float arguments are stored as their bit pattern.
+	 */
+	struct Request {
+		static constexpr size_t MAX_ARGS{ 8 };
+		static constexpr size_t MAX_STRINGS{ 3 };
+
+		RequestOp op{ RequestOp::None };
+		std::array<uint32_t, MAX_ARGS> args{};
+		std::array<Name, MAX_STRINGS> strings;
+		Payload payload;
+
+		static const RequestOpInfo& info(RequestOp op);
+		inline const RequestOpInfo& info() const { return info(op); }
+
+		static uint32_t fromFloat(float value);
+		static float toFloat(uint32_t value);
+
+		/*
+		 * Perform the call on the given SimConnect handle. The caller is responsible for locking.
+		 */
+		HRESULT execute(HANDLE handle) const;
+
+		/*
+		 * Manifest encoding. Every record is a 16-bit op, a 16-bit record size (including this header), the
+		 * op's 32-bit arguments, and its NUL-terminated strings, all little-endian and without padding. Ops with a
+		 * payload use the rest of the record for it. Returns false if the request does not fit in a record.
+		 */
+		bool encode(std::vector<uint8_t>& out) const;
+		static bool decode(const uint8_t*& pos, const uint8_t* end, Request& request);
+		static bool decodeAll(const void* data, size_t size, std::vector<Request>& requests);
+	};
+
+}
+}
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <format>
+#include <string>
+
+#include "SharedMemory.h"
+
+using namespace nl::rakis::interop;
+
+static std::string mappingName(const char* name)
+{
+	return std::format("Local\\CsSimConnect.{}", name);
+}
+
+/*static*/ std::unique_ptr<SharedMemory> SharedMemory::create(const char* name, size_t size)
+{
+	HANDLE mapping{ CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(uint64_t(size) >> 32), DWORD(size), mappingName(name).c_str()) };
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	if (GetLastError() == ERROR_ALREADY_EXISTS) {
+		CloseHandle(mapping);
+		return nullptr;
+	}
+	void* data{ MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) };
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		return nullptr;
+	}
+	std::unique_ptr<SharedMemory> memory{ new SharedMemory() };
+	memory->mapping_ = mapping;
+	memory->data_ = data;
+	memory->size_ = size;
+	return memory;
+}
+
+/*static*/ std::unique_ptr<SharedMemory> SharedMemory::open(const char* name)
+{
+	HANDLE mapping{ OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName(name).c_str()) };
+	if (mapping == nullptr) {
+		return nullptr;
+	}
+	void* data{ MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0) };
+	MEMORY_BASIC_INFORMATION info{};
+	if ((data == nullptr) || (VirtualQuery(data, &info, sizeof(info)) == 0)) {
+		if (data != nullptr) {
+			UnmapViewOfFile(data);
+		}
+		CloseHandle(mapping);
+		return nullptr;
+	}
+	std::unique_ptr<SharedMemory> memory{ new SharedMemory() };
+	memory->mapping_ = mapping;
+	memory->data_ = data;
+	memory->size_ = info.RegionSize;
+	return memory;
+}
+
+SharedMemory::~SharedMemory()
+{
+	UnmapViewOfFile(data_);
+	CloseHandle(mapping_);
+}
@@ -0,0 +1,57 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <memory>
+
+#include "framework.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * A named region of memory shared between processes: a file mapping backed by the page file. The name disappears
+	 * with the last process that has it open, and each process keeps its mapping until it closes it.
+	 */
+	class SharedMemory {
+		void* data_{ nullptr };
+		size_t size_{ 0 };
+		HANDLE mapping_{ nullptr };
+
+		SharedMemory() = default;
+
+	public:
+		SharedMemory(const SharedMemory&) = delete;
+		SharedMemory(SharedMemory&&) = delete;
+		~SharedMemory();
+		SharedMemory& operator=(const SharedMemory&) = delete;
+		SharedMemory& operator=(SharedMemory&&) = delete;
+
+		/*
+		 * Create a zero-filled region, failing if the name is in use.
+		 */
+		static std::unique_ptr<SharedMemory> create(const char* name, size_t size);
+		static std::unique_ptr<SharedMemory> open(const char* name);
+
+		inline void* data() const { return data_; }
+		inline size_t size() const { return size_; }
+	};
+
+}
+}
+}
@@ -0,0 +1,129 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <mutex>
+
+#include "SharedRequests.h"
+
+using namespace nl::rakis::interop;
+
+
+static void appendUpper(std::string& key, const std::string& name)
+{
+	for (char c : name) {
+		key.push_back(char(std::toupper(static_cast<unsigned char>(c))));
+	}
+	key.push_back('\x1f');
+}
+
+/*static*/ std::string SharedRequests::keyOf(const DataSchema& schema, const RequestParams& params)
+{
+	std::string key;
+	for (uint32_t param : params) {
+		key.append(std::format("{}:", param));
+	}
+	key.push_back('\x1e');
+	for (const auto& field : schema.fields()) {
+		appendUpper(key, field.datumName);
+		appendUpper(key, field.unitsName);
+		key.append(std::format("{}:{}\x1e", field.datumType, field.epsilon));
+	}
+	return key;
+}
+
+bool SharedRequests::join(const std::string& key, Subscriber subscriber, const RequestParams& params)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	auto [it, added] = groups_.try_emplace(key, Group{ subscriber, params, {} });
+	it->second.subscribers.push_back(subscriber);
+	memberOf_[subscriber.requestId] = key;
+	if (added) {
+		carriers_[subscriber.requestId] = &it->second;
+		count_.store(groups_.size(), std::memory_order_release);
+	}
+	return added;
+}
+
+SharedRequests::Leave SharedRequests::leave(uint32_t requestId)
+{
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+
+	auto member{ memberOf_.find(requestId) };
+	if (member == memberOf_.end()) {
+		return Leave{ Left::NotShared, {}, {} };
+	}
+	auto group{ groups_.find(member->second) };
+	memberOf_.erase(member);
+
+	auto& subscribers{ group->second.subscribers };
+	std::erase_if(subscribers, [requestId](const Subscriber& s) { return s.requestId == requestId; });
+	if (subscribers.empty()) {
+		const Leave result{ Left::Last, group->second.carrier, group->second.params };
+		carriers_.erase(requestId);
+		groups_.erase(group);
+		count_.store(groups_.size(), std::memory_order_release);
+		return result;
+	}
+	if (group->second.carrier.requestId != requestId) {
+		return Leave{ Left::Subscriber, group->second.carrier, group->second.params };
+	}
+	group->second.carrier = subscribers.front();
+	carriers_.erase(requestId);
+	carriers_[subscribers.front().requestId] = &group->second;
+	return Leave{ Left::Handover, group->second.carrier, group->second.params };
+}
+
+bool SharedRequests::subscribers(uint32_t carrierRequestId, std::vector<Subscriber>& subscribers) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	auto it{ carriers_.find(carrierRequestId) };
+	if (it == carriers_.end()) {
+		return false;
+	}
+	subscribers.clear();
+	for (const auto& subscriber : it->second->subscribers) {
+		if (subscriber.requestId != carrierRequestId) {
+			subscribers.push_back(subscriber);
+		}
+	}
+	return true;
+}
+
+bool SharedRequests::isMember(uint32_t requestId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+	return memberOf_.contains(requestId);
+}
+
+bool SharedRequests::isCarrier(uint32_t requestId) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+	return carriers_.contains(requestId);
+}
+
+void SharedRequests::statistics(uint32_t& requests, uint32_t& subscribers) const
+{
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+
+	requests = uint32_t(groups_.size());
+	subscribers = uint32_t(memberOf_.size());
+}
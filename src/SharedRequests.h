@@ -0,0 +1,118 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataSchema.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	struct Subscriber {
+		uint32_t requestId;
+		uint32_t defId;
+	};
+
+	/*
+	 * The parameters of a RequestDataOnSimObject call, after the requestId and defId.
+	 */
+	using RequestParams = std::array<uint32_t, 6>;
+
+	/*
+	 * Data requests with the same layout and parameters, merged into one request sent for one of the subscribers (the
+	 * carrier). Its data is copied to the other subscribers as if they had requested it themselves.
+	 */
+	class SharedRequests {
+	public:
+		enum class Left {
+			NotShared,		// The requestId had no shared subscription
+			Subscriber,		// It was not the carrier, so nothing changes in SimConnect
+			Handover,		// It was the carrier; the request must now be sent for "carrier" instead
+			Last,			// It was the last subscriber
+		};
+
+		struct Leave {
+			Left left;
+			Subscriber carrier;
+			RequestParams params;
+		};
+
+	private:
+		struct Group {
+			Subscriber carrier;
+			RequestParams params;
+			std::vector<Subscriber> subscribers;
+		};
+
+		std::atomic<bool> enabled_{ false };
+		std::atomic<size_t> count_{ 0 };
+
+		mutable std::shared_mutex mutex_;
+		std::unordered_map<std::string, Group> groups_;
+		std::unordered_map<uint32_t, std::string> memberOf_;	// Subscriber requestId to key
+		std::unordered_map<uint32_t, const Group*> carriers_;	// Carrier requestId to group
+
+	public:
+		/*
+		 * The key of a request: the datums of its definition (not their ids) and all other request parameters.
+		 */
+		static std::string keyOf(const DataSchema& schema, const RequestParams& params);
+
+		inline bool isEnabled() const { return enabled_.load(std::memory_order_acquire); }
+		inline void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_release); }
+
+		inline bool empty() const { return count_.load(std::memory_order_acquire) == 0; }
+
+		/*
+		 * Subscribe to the request with this key, or make the subscriber the carrier of a new one. Returns true if
+		 * the caller must send the request.
+		 */
+		bool join(const std::string& key, Subscriber subscriber, const RequestParams& params);
+
+		/*
+		 * Drop the subscription of a requestId, if any. The carrier is always one of the remaining subscribers.
+		 */
+		Leave leave(uint32_t requestId);
+
+		/*
+		 * Copy the subscribers of a carrier request, other than the carrier itself, into "subscribers". Returns
+		 * false if the request is not shared.
+		 */
+		bool subscribers(uint32_t carrierRequestId, std::vector<Subscriber>& subscribers) const;
+
+		/*
+		 * Whether a requestId subscribes to a shared request, and whether it is the one carrying it.
+		 */
+		bool isMember(uint32_t requestId) const;
+		bool isCarrier(uint32_t requestId) const;
+
+		/*
+		 * The number of requests sent to SimConnect, and of subscriptions they serve.
+		 */
+		void statistics(uint32_t& requests, uint32_t& subscribers) const;
+	};
+
+}
+}
+}
@@ -0,0 +1,887 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+#include "TelemetryRecorder.h"
+
+using namespace nl::rakis::interop;
+
+
+static constexpr char FILE_MAGIC[4]{ 'C', 'S', 'T', 'R' };
+static constexpr char TRAILER_MAGIC[4]{ 'C', 'S', 'T', 'E' };
+static constexpr char STREAM_TAG[4]{ 'S', 'T', 'R', 'M' };
+static constexpr char CHUNK_TAG[4]{ 'C', 'H', 'N', 'K' };
+static constexpr char INDEX_TAG[4]{ 'I', 'N', 'D', 'X' };
+
+static constexpr size_t FILE_HEADER_SIZE{ 24 };
+static constexpr size_t RECORD_HEADER_SIZE{ 8 };
+static constexpr size_t TRAILER_SIZE{ 12 };
+static constexpr size_t CHUNK_HEADER_SIZE{ 24 };
+
+static constexpr uint8_t XOR_SAME{ 0xff };		// Never a valid (leading << 4 | trailing) byte
+
+template <typename T>
+static void put(std::vector<uint8_t>& out, T value)
+{
+	const auto data{ reinterpret_cast<const uint8_t*>(&value) };
+	out.insert(out.end(), data, data + sizeof(T));
+}
+
+template <typename T>
+static bool get(const uint8_t*& in, const uint8_t* end, T& value)
+{
+	if (size_t(end - in) < sizeof(T)) {
+		return false;
+	}
+	std::memcpy(&value, in, sizeof(T));
+	in += sizeof(T);
+	return true;
+}
+
+static void putString(std::vector<uint8_t>& out, const std::string& value)
+{
+	const auto size{ uint16_t(std::min(value.size(), size_t(UINT16_MAX))) };
+	put(out, size);
+	out.insert(out.end(), value.begin(), value.begin() + size);
+}
+
+static bool getString(const uint8_t*& in, const uint8_t* end, std::string& value)
+{
+	uint16_t size{ 0 };
+	if (!get(in, end, size) || (size_t(end - in) < size)) {
+		return false;
+	}
+	value.assign(reinterpret_cast<const char*>(in), size);
+	in += size;
+	return true;
+}
+
+static inline uint64_t zigzag(int64_t value) { return (uint64_t(value) << 1) ^ uint64_t(value >> 63); }
+static inline int64_t unzigzag(uint64_t value) { return int64_t(value >> 1) ^ -int64_t(value & 1); }
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+	while (value >= 0x80) {
+		out.push_back(uint8_t(value) | 0x80);
+		value >>= 7;
+	}
+	out.push_back(uint8_t(value));
+}
+
+static bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value)
+{
+	value = 0;
+	for (unsigned shift = 0; (shift < 64) && (in != end); shift += 7) {
+		const uint8_t b{ *in++ };
+		value |= uint64_t(b & 0x7f) << shift;
+		if ((b & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * The delta of consecutive values, wrapping like unsigned arithmetic so any two values have one.
+ */
+static inline int64_t delta(int64_t value, int64_t previous) { return int64_t(uint64_t(value) - uint64_t(previous)); }
+static inline int64_t undelta(int64_t previous, int64_t delta) { return int64_t(uint64_t(previous) + uint64_t(delta)); }
+
+
+/*
+ * TelemetryCodec: column encoding of chunks.
+ */
+
+namespace {
+
+	enum class LaneKind { Xor, Delta, Raw };
+
+	/*
+	 * A field is encoded as one or more lanes of fixed width values; a LATLONALT is three lanes of doubles.
+	 */
+	struct Lane {
+		LaneKind kind;
+		uint32_t offset;
+		uint32_t width;
+	};
+
+}
+
+static void lanesOf(const DataField& field, std::vector<Lane>& lanes)
+{
+	lanes.clear();
+	switch (field.datumType) {
+	case SIMCONNECT_DATATYPE_FLOAT64:
+		lanes.push_back(Lane{ LaneKind::Xor, field.offset, 8 });
+		break;
+
+	case SIMCONNECT_DATATYPE_FLOAT32:
+		lanes.push_back(Lane{ LaneKind::Xor, field.offset, 4 });
+		break;
+
+	case SIMCONNECT_DATATYPE_INT32:
+		lanes.push_back(Lane{ LaneKind::Delta, field.offset, 4 });
+		break;
+
+	case SIMCONNECT_DATATYPE_INT64:
+		lanes.push_back(Lane{ LaneKind::Delta, field.offset, 8 });
+		break;
+
+	case SIMCONNECT_DATATYPE_LATLONALT:
+	case SIMCONNECT_DATATYPE_XYZ:
+		for (uint32_t i = 0; i < 3; i++) {
+			lanes.push_back(Lane{ LaneKind::Xor, field.offset + i * 8, 8 });
+		}
+		break;
+
+	default:
+		lanes.push_back(Lane{ LaneKind::Raw, field.offset, field.size });
+		break;
+	}
+}
+
+static inline uint64_t load(const uint8_t* in, uint32_t width)
+{
+	uint64_t value{ 0 };
+	std::memcpy(&value, in, width);
+	return value;
+}
+
+static inline int64_t loadSigned(const uint8_t* in, uint32_t width)
+{
+	const uint64_t value{ load(in, width) };
+	return (width == 8) ? int64_t(value) : int64_t(int32_t(uint32_t(value)));
+}
+
+static void encodeLane(const Lane& lane, size_t count, const uint8_t* rows, size_t stride, std::vector<uint8_t>& out)
+{
+	const uint8_t* in{ rows + lane.offset };
+
+	switch (lane.kind) {
+	case LaneKind::Xor: {
+		uint64_t previous{ 0 };
+		for (size_t i = 0; i < count; i++, in += stride) {
+			const uint64_t value{ load(in, lane.width) };
+			const uint64_t bits{ value ^ previous };
+			previous = value;
+			if (bits == 0) {
+				out.push_back(XOR_SAME);
+				continue;
+			}
+			const uint32_t leading{ uint32_t(std::countl_zero(bits) / 8) - (8 - lane.width) };
+			const uint32_t trailing{ uint32_t(std::countr_zero(bits) / 8) };
+			out.push_back(uint8_t((leading << 4) | trailing));
+			for (uint32_t b = trailing; b < lane.width - leading; b++) {
+				out.push_back(uint8_t(bits >> (8 * b)));
+			}
+		}
+		break;
+	}
+
+	case LaneKind::Delta: {
+		int64_t previous{ 0 };
+		for (size_t i = 0; i < count; i++, in += stride) {
+			const int64_t value{ loadSigned(in, lane.width) };
+			putVarint(out, zigzag(delta(value, previous)));
+			previous = value;
+		}
+		break;
+	}
+
+	case LaneKind::Raw:
+		for (size_t i = 0; i < count; i++, in += stride) {
+			out.insert(out.end(), in, in + lane.width);
+		}
+		break;
+	}
+}
+
+static bool decodeLane(const Lane& lane, size_t count, const uint8_t*& in, const uint8_t* end, uint8_t* rows, size_t stride)
+{
+	uint8_t* out{ rows + lane.offset };
+
+	switch (lane.kind) {
+	case LaneKind::Xor: {
+		uint64_t previous{ 0 };
+		for (size_t i = 0; i < count; i++, out += stride) {
+			if (in == end) {
+				return false;
+			}
+			const uint8_t header{ *in++ };
+			uint64_t bits{ 0 };
+			if (header != XOR_SAME) {
+				const uint32_t leading{ uint32_t(header >> 4) };
+				const uint32_t trailing{ uint32_t(header & 0x0f) };
+				if ((leading + trailing >= lane.width) || (size_t(end - in) < lane.width - leading - trailing)) {
+					return false;
+				}
+				for (uint32_t b = trailing; b < lane.width - leading; b++) {
+					bits |= uint64_t(*in++) << (8 * b);
+				}
+			}
+			previous ^= bits;
+			std::memcpy(out, &previous, lane.width);
+		}
+		break;
+	}
+
+	case LaneKind::Delta: {
+		int64_t previous{ 0 };
+		for (size_t i = 0; i < count; i++, out += stride) {
+			uint64_t value{ 0 };
+			if (!getVarint(in, end, value)) {
+				return false;
+			}
+			previous = undelta(previous, unzigzag(value));
+			std::memcpy(out, &previous, lane.width);
+		}
+		break;
+	}
+
+	case LaneKind::Raw:
+		if (size_t(end - in) < count * lane.width) {
+			return false;
+		}
+		for (size_t i = 0; i < count; i++, out += stride) {
+			std::memcpy(out, in, lane.width);
+			in += lane.width;
+		}
+		break;
+	}
+	return true;
+}
+
+template <typename T>
+static void encodeDeltas(size_t count, const T* values, std::vector<uint8_t>& out)
+{
+	int64_t previous{ 0 };
+	for (size_t i = 0; i < count; i++) {
+		putVarint(out, zigzag(delta(int64_t(values[i]), previous)));
+		previous = int64_t(values[i]);
+	}
+}
+
+template <typename T>
+static bool decodeDeltas(size_t count, const uint8_t*& in, const uint8_t* end, T* values)
+{
+	int64_t previous{ 0 };
+	for (size_t i = 0; i < count; i++) {
+		uint64_t value{ 0 };
+		if (!getVarint(in, end, value)) {
+			return false;
+		}
+		previous = undelta(previous, unzigzag(value));
+		values[i] = T(previous);
+	}
+	return true;
+}
+
+/*
+ * Columns are preceded by their size, filled in when the column is complete.
+ */
+static size_t beginColumn(std::vector<uint8_t>& out)
+{
+	const size_t start{ out.size() };
+	put(out, uint32_t(0));
+	return start;
+}
+
+static void endColumn(std::vector<uint8_t>& out, size_t start)
+{
+	const uint32_t size{ uint32_t(out.size() - start - sizeof(uint32_t)) };
+	std::memcpy(out.data() + start, &size, sizeof(size));
+}
+
+static bool nextColumn(const uint8_t*& in, const uint8_t* end, const uint8_t*& columnEnd)
+{
+	uint32_t size{ 0 };
+	if (!get(in, end, size) || (size_t(end - in) < size)) {
+		return false;
+	}
+	columnEnd = in + size;
+	return true;
+}
+
+/*static*/ void TelemetryCodec::encode(const DataSchema& schema, size_t count, const int64_t* times, const uint32_t* objectIds, const uint8_t* rows, std::vector<uint8_t>& out)
+{
+	size_t start{ beginColumn(out) };
+	encodeDeltas(count, times, out);
+	endColumn(out, start);
+
+	start = beginColumn(out);
+	encodeDeltas(count, objectIds, out);
+	endColumn(out, start);
+
+	std::vector<Lane> lanes;
+	for (const auto& field : schema.fields()) {
+		lanesOf(field, lanes);
+		start = beginColumn(out);
+		for (const auto& lane : lanes) {
+			encodeLane(lane, count, rows, schema.size(), out);
+		}
+		endColumn(out, start);
+	}
+}
+
+/*static*/ bool TelemetryCodec::decode(const DataSchema& schema, size_t count, const uint8_t* data, size_t size, int64_t* times, uint32_t* objectIds, uint8_t* rows)
+{
+	const uint8_t* in{ data };
+	const uint8_t* end{ data + size };
+	const uint8_t* columnEnd{ nullptr };
+
+	if (!nextColumn(in, end, columnEnd) || !decodeDeltas(count, in, columnEnd, times) || (in != columnEnd)) {
+		return false;
+	}
+	if (!nextColumn(in, end, columnEnd) || !decodeDeltas(count, in, columnEnd, objectIds) || (in != columnEnd)) {
+		return false;
+	}
+	std::vector<Lane> lanes;
+	for (const auto& field : schema.fields()) {
+		lanesOf(field, lanes);
+		if (!nextColumn(in, end, columnEnd)) {
+			return false;
+		}
+		for (const auto& lane : lanes) {
+			if (!decodeLane(lane, count, in, columnEnd, rows, schema.size())) {
+				return false;
+			}
+		}
+		if (in != columnEnd) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/*
+ * TelemetryRecorder: staging on the dispatch thread, encoding and writing on its own.
+ */
+
+/*static*/ std::unique_ptr<TelemetryRecorder> TelemetryRecorder::create(const char* path, int64_t clock)
+{
+	std::unique_ptr<TelemetryRecorder> recorder{ new TelemetryRecorder() };
+
+	recorder->out_.open(path, std::ios::binary | std::ios::trunc);
+	if (!recorder->out_) {
+		return nullptr;
+	}
+	const int64_t wallClock{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count() };
+	std::vector<uint8_t> header(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+	put(header, VERSION);
+	put(header, wallClock);
+	put(header, clock);
+	recorder->out_.write(reinterpret_cast<const char*>(header.data()), header.size());
+	if (!recorder->out_) {
+		return nullptr;
+	}
+	recorder->offset_ = header.size();
+	recorder->bytes_ = recorder->offset_;
+	recorder->thread_ = std::thread(&TelemetryRecorder::run, recorder.get());
+	return recorder;
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+	close();
+}
+
+bool TelemetryRecorder::add(uint32_t requestId, uint32_t defId, std::shared_ptr<const DataSchema> schema)
+{
+	if ((schema == nullptr) || !schema->isFixedSize() || (schema->size() == 0)) {
+		return false;
+	}
+	// The stream is queued before its rows can be staged, so the encoder always knows it first.
+	std::scoped_lock<std::mutex> staging(stagingMutex_);
+	if (stopping_) {
+		return false;
+	}
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	if (recorded_.contains(requestId)) {
+		return false;
+	}
+	added_.emplace_back(requestId, Stream{ defId, schema, {}, {}, {} });
+	recorded_.emplace(requestId, std::move(schema));
+	count_ = recorded_.size();
+	return true;
+}
+
+void TelemetryRecorder::record(uint32_t requestId, uint32_t objectId, int64_t time, const void* row, size_t size)
+{
+	size_t rowSize{ 0 };
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex_);
+		auto it{ recorded_.find(requestId) };
+		if (it == recorded_.end()) {
+			return;
+		}
+		rowSize = it->second->size();
+	}
+	if (size < rowSize) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	const Staged header{ requestId, objectId, time };
+	const auto headerData{ reinterpret_cast<const uint8_t*>(&header) };
+	const auto rowData{ static_cast<const uint8_t*>(row) };
+
+	std::scoped_lock<std::mutex> lock(stagingMutex_);
+	if (stopping_ || (staging_.size() + sizeof(header) + rowSize > MAX_STAGED)) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	staging_.insert(staging_.end(), headerData, headerData + sizeof(header));
+	staging_.insert(staging_.end(), rowData, rowData + rowSize);
+}
+
+void TelemetryRecorder::close()
+{
+	{
+		std::scoped_lock<std::mutex> staging(stagingMutex_);
+		std::unique_lock<std::shared_mutex> lock(mutex_);
+		stopping_ = true;
+		recorded_.clear();
+		count_ = 0;
+	}
+	wakeup_.notify_one();
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+TelemetryRecorder::Statistics TelemetryRecorder::statistics() const
+{
+	return Statistics{ rows_.load(std::memory_order_relaxed), dropped_.load(std::memory_order_relaxed), bytes_.load(std::memory_order_relaxed) };
+}
+
+void TelemetryRecorder::write(const char* tag, const std::vector<uint8_t>& body)
+{
+	const uint32_t size{ uint32_t(body.size()) };
+	out_.write(tag, 4);
+	out_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	out_.write(reinterpret_cast<const char*>(body.data()), body.size());
+	offset_ += RECORD_HEADER_SIZE + body.size();
+	bytes_.store(offset_, std::memory_order_relaxed);
+}
+
+void TelemetryRecorder::writeStream(uint32_t requestId, const Stream& stream)
+{
+	std::vector<uint8_t> body;
+	put(body, requestId);
+	put(body, stream.defId);
+	put(body, uint32_t(stream.schema->fields().size()));
+	for (const auto& field : stream.schema->fields()) {
+		put(body, field.datumType);
+		putString(body, field.datumName);
+		putString(body, field.unitsName);
+	}
+	streamOffsets_.push_back(offset_);
+	write(STREAM_TAG, body);
+}
+
+void TelemetryRecorder::writeChunk(uint32_t requestId, Stream& stream)
+{
+	const TelemetryChunk chunk{ requestId, uint32_t(stream.times.size()), stream.times.front(), stream.times.back(), offset_ };
+
+	encoded_.clear();
+	put(encoded_, chunk.requestId);
+	put(encoded_, chunk.rows);
+	put(encoded_, chunk.firstTime);
+	put(encoded_, chunk.lastTime);
+	TelemetryCodec::encode(*stream.schema, stream.times.size(), stream.times.data(), stream.objectIds.data(), stream.rows.data(), encoded_);
+	write(CHUNK_TAG, encoded_);
+	index_.push_back(chunk);
+	rows_.fetch_add(chunk.rows, std::memory_order_relaxed);
+
+	stream.times.clear();
+	stream.objectIds.clear();
+	stream.rows.clear();
+}
+
+void TelemetryRecorder::writeIndex()
+{
+	std::vector<uint8_t> body;
+	put(body, uint32_t(index_.size()));
+	for (const auto& chunk : index_) {
+		put(body, chunk.requestId);
+		put(body, chunk.rows);
+		put(body, chunk.firstTime);
+		put(body, chunk.lastTime);
+		put(body, chunk.offset);
+	}
+	put(body, uint32_t(streamOffsets_.size()));
+	for (auto offset : streamOffsets_) {
+		put(body, offset);
+	}
+	const uint64_t indexOffset{ offset_ };
+	write(INDEX_TAG, body);
+
+	out_.write(reinterpret_cast<const char*>(&indexOffset), sizeof(indexOffset));
+	out_.write(TRAILER_MAGIC, sizeof(TRAILER_MAGIC));
+	offset_ += TRAILER_SIZE;
+	bytes_.store(offset_, std::memory_order_relaxed);
+}
+
+/*
+ * Sort a batch of staged rows into the chunks of their streams, writing chunks that are full or hold rows older than
+ * CHUNK_AGE compared to the latest row.
+ */
+void TelemetryRecorder::encode(std::vector<uint8_t>& staged, std::vector<std::pair<uint32_t, Stream>>& added)
+{
+	for (auto& [requestId, stream] : added) {
+		writeStream(requestId, stream);
+		streams_.insert_or_assign(requestId, std::move(stream));
+	}
+	int64_t latest{ INT64_MIN };
+	size_t pos{ 0 };
+	while (pos + sizeof(Staged) <= staged.size()) {
+		Staged header;
+		std::memcpy(&header, staged.data() + pos, sizeof(header));
+		pos += sizeof(header);
+
+		auto& stream{ streams_.at(header.requestId) };
+		const size_t rowSize{ stream.schema->size() };
+		stream.times.push_back(header.time);
+		stream.objectIds.push_back(header.objectId);
+		stream.rows.insert(stream.rows.end(), staged.data() + pos, staged.data() + pos + rowSize);
+		pos += rowSize;
+		latest = std::max(latest, header.time);
+
+		if (stream.times.size() >= CHUNK_ROWS) {
+			writeChunk(header.requestId, stream);
+		}
+	}
+	if (latest != INT64_MIN) {
+		for (auto& [requestId, stream] : streams_) {
+			if (!stream.times.empty() && (latest - stream.times.front() >= CHUNK_AGE)) {
+				writeChunk(requestId, stream);
+			}
+		}
+	}
+	out_.flush();
+}
+
+void TelemetryRecorder::run()
+{
+	std::vector<uint8_t> staged;
+	std::vector<std::pair<uint32_t, Stream>> added;
+	bool stopping{ false };
+
+	while (!stopping) {
+		{
+			std::unique_lock<std::mutex> lock(stagingMutex_);
+			wakeup_.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL), [this]() { return stopping_; });
+			stopping = stopping_;
+			staged.swap(staging_);			// Both buffers keep their capacity
+			added.swap(added_);
+		}
+		encode(staged, added);
+		staged.clear();
+		added.clear();
+	}
+	for (auto& [requestId, stream] : streams_) {
+		if (!stream.times.empty()) {
+			writeChunk(requestId, stream);
+		}
+	}
+	writeIndex();
+	out_.close();
+}
+
+
+/*
+ * TelemetryReader: reading recordings.
+ */
+
+static std::mutex readersMutex;
+static std::vector<std::unique_ptr<TelemetryReader>> readers;
+
+/*static*/ TelemetryReader* TelemetryReader::add(std::unique_ptr<TelemetryReader> reader)
+{
+	std::scoped_lock<std::mutex> lock(readersMutex);
+
+	return readers.emplace_back(std::move(reader)).get();
+}
+
+/*static*/ TelemetryReader* TelemetryReader::find(HANDLE handle)
+{
+	std::scoped_lock<std::mutex> lock(readersMutex);
+
+	auto it{ std::find_if(readers.begin(), readers.end(), [handle](const auto& reader) { return reader.get() == handle; }) };
+	return (it == readers.end()) ? nullptr : it->get();
+}
+
+/*static*/ std::unique_ptr<TelemetryReader> TelemetryReader::remove(HANDLE handle)
+{
+	std::scoped_lock<std::mutex> lock(readersMutex);
+
+	auto it{ std::find_if(readers.begin(), readers.end(), [handle](const auto& reader) { return reader.get() == handle; }) };
+	if (it == readers.end()) {
+		return nullptr;
+	}
+	auto reader{ std::move(*it) };
+	readers.erase(it);
+	return reader;
+}
+
+/*static*/ std::unique_ptr<TelemetryReader> TelemetryReader::open(const char* path)
+{
+	std::unique_ptr<TelemetryReader> reader{ new TelemetryReader() };
+
+	reader->in_.open(path, std::ios::binary | std::ios::ate);
+	if (!reader->in_) {
+		return nullptr;
+	}
+	reader->size_ = uint64_t(reader->in_.tellg());
+
+	uint8_t header[FILE_HEADER_SIZE];
+	reader->in_.seekg(0);
+	if ((reader->size_ < FILE_HEADER_SIZE) || !reader->in_.read(reinterpret_cast<char*>(header), sizeof(header))) {
+		return nullptr;
+	}
+	const uint8_t* in{ header + sizeof(FILE_MAGIC) };
+	uint32_t version{ 0 };
+	if ((std::memcmp(header, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) || !get(in, std::end(header), version) || (version != TelemetryRecorder::VERSION)) {
+		return nullptr;
+	}
+	get(in, std::end(header), reader->wallClock_);
+	get(in, std::end(header), reader->clock_);
+
+	if (!reader->readIndex()) {
+		reader->streams_.clear();
+		reader->index_.clear();
+		reader->scan();
+	}
+	for (size_t i = 0; i < reader->index_.size(); i++) {
+		if (auto it = reader->streams_.find(reader->index_[i].requestId); it != reader->streams_.end()) {
+			it->second.chunks.push_back(i);
+		}
+	}
+	for (auto& [requestId, stream] : reader->streams_) {
+		std::stable_sort(stream.chunks.begin(), stream.chunks.end(), [&index = reader->index_](size_t a, size_t b) { return index[a].firstTime < index[b].firstTime; });
+	}
+	return reader;
+}
+
+bool TelemetryReader::readRecord(uint64_t offset, char tag[4], std::vector<uint8_t>& body)
+{
+	uint32_t size{ 0 };
+
+	in_.clear();
+	if ((offset + RECORD_HEADER_SIZE > size_) || !in_.seekg(std::streamoff(offset)) ||
+		!in_.read(tag, 4) || !in_.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+		(size > size_ - offset - RECORD_HEADER_SIZE)) {
+		return false;
+	}
+	body.resize(size);
+	return bool(in_.read(reinterpret_cast<char*>(body.data()), size));
+}
+
+bool TelemetryReader::addStream(const std::vector<uint8_t>& body)
+{
+	const uint8_t* in{ body.data() };
+	const uint8_t* end{ body.data() + body.size() };
+	uint32_t requestId{ 0 };
+	uint32_t fieldCount{ 0 };
+	Stream stream{};
+
+	if (!get(in, end, requestId) || !get(in, end, stream.defId) || !get(in, end, fieldCount)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < fieldCount; i++) {
+		uint32_t datumType{ 0 };
+		std::string datumName;
+		std::string unitsName;
+		if (!get(in, end, datumType) || !getString(in, end, datumName) || !getString(in, end, unitsName)) {
+			return false;
+		}
+		stream.schema.add(datumName.c_str(), unitsName.c_str(), datumType, 0.0f, i);
+	}
+	if (!stream.schema.isFixedSize()) {
+		return false;
+	}
+	streams_.emplace(requestId, std::move(stream));
+	return true;
+}
+
+static bool getChunk(const uint8_t*& in, const uint8_t* end, TelemetryChunk& chunk)
+{
+	return get(in, end, chunk.requestId) && get(in, end, chunk.rows) && get(in, end, chunk.firstTime) && get(in, end, chunk.lastTime);
+}
+
+/*
+ * Use the index at the end of the file, if there is one.
+ */
+bool TelemetryReader::readIndex()
+{
+	uint8_t trailer[TRAILER_SIZE];
+	in_.clear();
+	if ((size_ < FILE_HEADER_SIZE + TRAILER_SIZE) || !in_.seekg(std::streamoff(size_ - TRAILER_SIZE)) ||
+		!in_.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) ||
+		(std::memcmp(trailer + sizeof(uint64_t), TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0)) {
+		return false;
+	}
+	uint64_t indexOffset{ 0 };
+	std::memcpy(&indexOffset, trailer, sizeof(indexOffset));
+
+	char tag[4];
+	std::vector<uint8_t> body;
+	if (!readRecord(indexOffset, tag, body) || (std::memcmp(tag, INDEX_TAG, sizeof(tag)) != 0)) {
+		return false;
+	}
+	const uint8_t* in{ body.data() };
+	const uint8_t* end{ body.data() + body.size() };
+	uint32_t count{ 0 };
+	if (!get(in, end, count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		TelemetryChunk chunk{};
+		if (!getChunk(in, end, chunk) || !get(in, end, chunk.offset)) {
+			return false;
+		}
+		index_.push_back(chunk);
+	}
+	std::vector<uint64_t> streamOffsets;
+	if (!get(in, end, count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t offset{ 0 };
+		if (!get(in, end, offset)) {
+			return false;
+		}
+		streamOffsets.push_back(offset);
+	}
+	for (auto offset : streamOffsets) {
+		if (!readRecord(offset, tag, body) || (std::memcmp(tag, STREAM_TAG, sizeof(tag)) != 0) || !addStream(body)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Rebuild the index by walking the records, stopping at the first incomplete one.
+ */
+bool TelemetryReader::scan()
+{
+	char tag[4];
+	std::vector<uint8_t> body;
+
+	for (uint64_t offset = FILE_HEADER_SIZE; readRecord(offset, tag, body); offset += RECORD_HEADER_SIZE + body.size()) {
+		if (std::memcmp(tag, STREAM_TAG, sizeof(tag)) == 0) {
+			addStream(body);
+		}
+		else if (std::memcmp(tag, CHUNK_TAG, sizeof(tag)) == 0) {
+			const uint8_t* in{ body.data() };
+			TelemetryChunk chunk{};
+			if (getChunk(in, body.data() + body.size(), chunk)) {
+				chunk.offset = offset;
+				index_.push_back(chunk);
+			}
+		}
+	}
+	return !streams_.empty();
+}
+
+bool TelemetryReader::load(size_t chunk)
+{
+	if (cached_ == chunk) {
+		return true;
+	}
+	cached_ = SIZE_MAX;
+
+	const auto& info{ index_[chunk] };
+	const auto& schema{ streams_.at(info.requestId).schema };
+	char tag[4];
+	std::vector<uint8_t> body;
+	if (!readRecord(info.offset, tag, body) || (std::memcmp(tag, CHUNK_TAG, sizeof(tag)) != 0) || (body.size() < CHUNK_HEADER_SIZE)) {
+		return false;
+	}
+	times_.resize(info.rows);
+	objectIds_.resize(info.rows);
+	rows_.resize(size_t(info.rows) * schema.size());
+	if (!TelemetryCodec::decode(schema, info.rows, body.data() + CHUNK_HEADER_SIZE, body.size() - CHUNK_HEADER_SIZE, times_.data(), objectIds_.data(), rows_.data())) {
+		return false;
+	}
+	cached_ = chunk;
+	return true;
+}
+
+size_t TelemetryReader::streams(uint32_t* requestIds, size_t capacity) const
+{
+	size_t count{ 0 };
+	for (const auto& [requestId, stream] : streams_) {
+		if ((requestIds != nullptr) && (count < capacity)) {
+			requestIds[count] = requestId;
+		}
+		count++;
+	}
+	return count;
+}
+
+const DataSchema* TelemetryReader::schema(uint32_t requestId) const
+{
+	auto it{ streams_.find(requestId) };
+	return (it == streams_.end()) ? nullptr : &it->second.schema;
+}
+
+size_t TelemetryReader::chunks(uint32_t requestId) const
+{
+	auto it{ streams_.find(requestId) };
+	return (it == streams_.end()) ? 0 : it->second.chunks.size();
+}
+
+size_t TelemetryReader::read(uint32_t requestId, int64_t from, int64_t to, size_t maxRows, int64_t* times, uint32_t* objectIds, void* const* columns)
+{
+	auto it{ streams_.find(requestId) };
+	if (it == streams_.end()) {
+		return 0;
+	}
+	const auto& stream{ it->second };
+
+	// Chunks of a stream do not overlap, so the first one that can hold "from" is found by bisection.
+	auto chunk{ std::partition_point(stream.chunks.begin(), stream.chunks.end(), [this, from](size_t i) { return index_[i].lastTime < from; }) };
+	size_t copied{ 0 };
+	for (; (chunk != stream.chunks.end()) && (copied < maxRows) && (index_[*chunk].firstTime < to); ++chunk) {
+		if (!load(*chunk)) {
+			break;
+		}
+		const auto first{ size_t(std::lower_bound(times_.begin(), times_.end(), from) - times_.begin()) };
+		const auto last{ size_t(std::lower_bound(times_.begin() + first, times_.end(), to) - times_.begin()) };
+		const size_t count{ std::min(last - first, maxRows - copied) };
+		if (count == 0) {
+			continue;
+		}
+		if (times != nullptr) {
+			std::copy_n(times_.begin() + first, count, times + copied);
+		}
+		if (objectIds != nullptr) {
+			std::copy_n(objectIds_.begin() + first, count, objectIds + copied);
+		}
+		if (columns != nullptr) {
+			stream.schema.unpack(uint32_t(count), rows_.data() + first * stream.schema.size(), columns, uint32_t(copied));
+		}
+		copied += count;
+	}
+	return copied;
+}
@@ -0,0 +1,234 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DataSchema.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	/*
+	 * Column encoding for a chunk of rows of one data definition. Times and objectIds are stored as zigzag varint
+	 * deltas, as are integer fields. Floating point fields (and each of the three values in LATLONALT and XYZ) are
+	 * XOR-ed with the previous value, leaving out the leading and trailing zero bytes. Anything else is stored as is.
+	 */
+	class TelemetryCodec {
+	public:
+		static void encode(const DataSchema& schema, size_t count, const int64_t* times, const uint32_t* objectIds, const uint8_t* rows, std::vector<uint8_t>& out);
+		static bool decode(const DataSchema& schema, size_t count, const uint8_t* data, size_t size, int64_t* times, uint32_t* objectIds, uint8_t* rows);
+	};
+
+	/*
+	 * Recording file layout, all little-endian. After a 24-byte header ("CSTR", version, wall clock and
+	 * CsGetHistoryClock at the start, both in microseconds) come records of a tag, a 32-bit body size and the body:
+	 *
+	 *   "STRM" requestId, defId, field count, then per field its datum type, name and units
+	 *   "CHNK" requestId, rows, first and last time, then the encoded columns, each preceded by its size
+	 *   "INDX" chunk count, per chunk its requestId, rows, first and last time and offset, then the offsets of the
+	 *          STRM records
+	 *
+	 * The file ends with the offset of the INDX record and "CSTE". A file without them, because the recorder did not
+	 * stop cleanly, can still be read by walking the records.
+	 */
+	struct TelemetryChunk {
+		uint32_t requestId;
+		uint32_t rows;
+		int64_t firstTime;
+		int64_t lastTime;
+		uint64_t offset;
+	};
+
+	/*
+	 * Writes data rows of selected requests to a recording. The dispatch thread only copies the row into a staging
+	 * buffer; a background thread sorts them into chunks per request, and encodes and writes each chunk once it is
+	 * full or old enough.
+	 */
+	class TelemetryRecorder {
+	public:
+		static constexpr uint32_t VERSION{ 1 };
+		static constexpr size_t CHUNK_ROWS{ 4096 };
+		static constexpr int64_t CHUNK_AGE{ 10'000'000 };			// Microseconds of rows held before writing anyway
+		static constexpr size_t MAX_STAGED{ 16 * 1024 * 1024 };		// Rows beyond this are dropped
+		static constexpr int64_t FLUSH_INTERVAL{ 20 };				// Milliseconds between staging buffer swaps
+
+		struct Statistics {
+			uint64_t rows;
+			uint64_t dropped;
+			uint64_t bytes;
+		};
+
+	private:
+		struct Stream {
+			uint32_t defId;
+			std::shared_ptr<const DataSchema> schema;
+			std::vector<int64_t> times;
+			std::vector<uint32_t> objectIds;
+			std::vector<uint8_t> rows;
+		};
+
+		struct Staged {
+			uint32_t requestId;
+			uint32_t objectId;
+			int64_t time;
+		};
+
+		std::ofstream out_;
+		uint64_t offset_{ 0 };
+		std::vector<TelemetryChunk> index_;
+		std::vector<uint64_t> streamOffsets_;
+		std::map<uint32_t, Stream> streams_;		// Only used by the encoder thread
+		std::vector<uint8_t> encoded_;
+
+		mutable std::shared_mutex mutex_;
+		std::map<uint32_t, std::shared_ptr<const DataSchema>> recorded_;
+		std::atomic<size_t> count_{ 0 };
+
+		std::mutex stagingMutex_;
+		std::condition_variable wakeup_;
+		std::vector<uint8_t> staging_;			// Staged headers, each followed by its row
+		std::vector<std::pair<uint32_t, Stream>> added_;
+		bool stopping_{ false };
+
+		std::atomic<uint64_t> rows_{ 0 };
+		std::atomic<uint64_t> dropped_{ 0 };
+		std::atomic<uint64_t> bytes_{ 0 };
+
+		std::thread thread_;
+
+		TelemetryRecorder() = default;
+
+		void write(const char* tag, const std::vector<uint8_t>& body);
+		void writeStream(uint32_t requestId, const Stream& stream);
+		void writeChunk(uint32_t requestId, Stream& stream);
+		void writeIndex();
+		void encode(std::vector<uint8_t>& staged, std::vector<std::pair<uint32_t, Stream>>& added);
+		void run();
+
+	public:
+		TelemetryRecorder(const TelemetryRecorder&) = delete;
+		TelemetryRecorder(TelemetryRecorder&&) = delete;
+		~TelemetryRecorder();
+		TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+		TelemetryRecorder& operator=(TelemetryRecorder&&) = delete;
+
+		/*
+		 * Create the file and start the encoder thread. "clock" is the current CsGetHistoryClock time.
+		 */
+		static std::unique_ptr<TelemetryRecorder> create(const char* path, int64_t clock);
+
+		/*
+		 * Record the rows of a request. Fails for schemas with variable sized fields and for requests already
+		 * recorded.
+		 */
+		bool add(uint32_t requestId, uint32_t defId, std::shared_ptr<const DataSchema> schema);
+
+		inline bool empty() const { return count_.load(std::memory_order_relaxed) == 0; }
+
+		/*
+		 * Stage a row if its request is recorded. Called on the dispatch thread.
+		 */
+		void record(uint32_t requestId, uint32_t objectId, int64_t time, const void* row, size_t size);
+
+		/*
+		 * Write what is left and the index, and close the file. Rows recorded afterwards are dropped.
+		 */
+		void close();
+
+		Statistics statistics() const;
+	};
+
+	/*
+	 * Reads a recording back, a chunk at a time. Not thread safe.
+	 */
+	class TelemetryReader {
+	public:
+		/*
+		 * The reader handle is the reader's address, registered here so it can be checked.
+		 */
+		static TelemetryReader* add(std::unique_ptr<TelemetryReader> reader);
+		static TelemetryReader* find(HANDLE reader);
+		static std::unique_ptr<TelemetryReader> remove(HANDLE reader);
+
+	private:
+		struct Stream {
+			uint32_t defId;
+			DataSchema schema;
+			std::vector<size_t> chunks;			// Indexes into index_, in time order
+		};
+
+		std::ifstream in_;
+		uint64_t size_{ 0 };
+		int64_t wallClock_{ 0 };
+		int64_t clock_{ 0 };
+		std::map<uint32_t, Stream> streams_;
+		std::vector<TelemetryChunk> index_;
+
+		size_t cached_{ SIZE_MAX };
+		std::vector<int64_t> times_;
+		std::vector<uint32_t> objectIds_;
+		std::vector<uint8_t> rows_;
+
+		TelemetryReader() = default;
+
+		bool readRecord(uint64_t offset, char tag[4], std::vector<uint8_t>& body);
+		bool addStream(const std::vector<uint8_t>& body);
+		bool readIndex();
+		bool scan();
+		bool load(size_t chunk);
+
+	public:
+		TelemetryReader(const TelemetryReader&) = delete;
+		TelemetryReader(TelemetryReader&&) = delete;
+		~TelemetryReader() = default;
+		TelemetryReader& operator=(const TelemetryReader&) = delete;
+		TelemetryReader& operator=(TelemetryReader&&) = delete;
+
+		static std::unique_ptr<TelemetryReader> open(const char* path);
+
+		inline HANDLE handle() { return this; }
+
+		/*
+		 * The wall clock time, in Unix microseconds, at clock time zero.
+		 */
+		inline int64_t epoch() const { return wallClock_ - clock_; }
+
+		size_t streams(uint32_t* requestIds, size_t capacity) const;
+		const DataSchema* schema(uint32_t requestId) const;
+		size_t chunks(uint32_t requestId) const;
+
+		/*
+		 * Copy up to "maxRows" rows with a time in [from, to) into the times, objectIds (both optional) and per-field
+		 * columns, returning the number of rows copied.
+		 */
+		size_t read(uint32_t requestId, int64_t from, int64_t to, size_t maxRows, int64_t* times, uint32_t* objectIds, void* const* columns);
+	};
+
+}
+}
+}
@@ -0,0 +1,195 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include "Tickets.h"
+
+using namespace nl::rakis::interop;
+
+
+TicketTable::TicketTable()
+{
+	for (auto& slot : slots_) {
+		slot.reply.reserve(REPLY_RESERVE);
+	}
+}
+
+TicketTable::Slot* TicketTable::slotOf(uint64_t ticket)
+{
+	const uint64_t index{ (ticket & SLOT_MASK) - 1 };
+	if ((index >= CAPACITY) || (slots_[index].state == TicketState::Unknown) || (slots_[index].generation != (ticket >> SLOT_BITS))) {
+		return nullptr;
+	}
+	return &slots_[index];
+}
+
+const TicketTable::Slot* TicketTable::slotOf(uint64_t ticket) const
+{
+	return const_cast<TicketTable*>(this)->slotOf(ticket);
+}
+
+uint64_t TicketTable::issue(uint32_t requestId, Callback callback)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	for (size_t i = 0; i < CAPACITY; i++) {
+		const size_t index{ (next_ + i) % CAPACITY };
+		Slot& slot{ slots_[index] };
+		if (slot.state != TicketState::Unknown) {
+			continue;
+		}
+		next_ = (index + 1) % CAPACITY;
+		slot.generation++;
+		slot.state = TicketState::Pending;
+		slot.requestId = requestId;
+		slot.sendId = 0;
+		slot.sequence = ++sequence_;
+		slot.callback = std::move(callback);
+		slot.reply.clear();
+		pending_.fetch_add(1, std::memory_order_release);
+		return ticketOf(index);
+	}
+	return 0;
+}
+
+void TicketTable::sent(uint64_t ticket, uint32_t sendId)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	if (Slot* slot = slotOf(ticket); slot != nullptr) {
+		slot->sendId = sendId;
+	}
+}
+
+bool TicketTable::release(uint64_t ticket)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	Slot* slot{ slotOf(ticket) };
+	if (slot == nullptr) {
+		return false;
+	}
+	if (slot->state == TicketState::Pending) {
+		pending_.fetch_sub(1, std::memory_order_release);
+	}
+	slot->state = TicketState::Unknown;
+	slot->callback = nullptr;
+	return true;
+}
+
+/*
+ * Called with the lock held. Tickets with a callback are handed the reply directly and released; the others keep
+ * a copy of it for the caller.
+ */
+bool TicketTable::finish(size_t index, TicketState state, const void* reply, uint32_t size, std::unique_lock<std::mutex>& lock)
+{
+	Slot& slot{ slots_[index] };
+	const uint64_t ticket{ ticketOf(index) };
+	pending_.fetch_sub(1, std::memory_order_release);
+
+	if (slot.callback) {
+		Callback callback{ std::move(slot.callback) };
+		slot.callback = nullptr;
+		slot.state = TicketState::Unknown;
+		lock.unlock();
+		callback(ticket, state, reply, size);
+		return true;
+	}
+	slot.state = state;
+	slot.reply.assign(static_cast<const uint8_t*>(reply), static_cast<const uint8_t*>(reply) + size);
+	lock.unlock();
+	cv_.notify_all();
+	return true;
+}
+
+bool TicketTable::complete(uint32_t requestId, const void* reply, uint32_t size)
+{
+	if (!hasPending()) {
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	size_t found{ CAPACITY };
+	for (size_t i = 0; i < CAPACITY; i++) {
+		const Slot& slot{ slots_[i] };
+		if ((slot.state == TicketState::Pending) && (slot.requestId == requestId) && ((found == CAPACITY) || (slot.sequence < slots_[found].sequence))) {
+			found = i;
+		}
+	}
+	return (found != CAPACITY) && finish(found, TicketState::Completed, reply, size, lock);
+}
+
+bool TicketTable::abort(uint64_t ticket)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	Slot* slot{ slotOf(ticket) };
+	if ((slot == nullptr) || (slot->state != TicketState::Pending)) {
+		return false;
+	}
+	return finish(size_t(slot - slots_.data()), TicketState::Failed, nullptr, 0, lock);
+}
+
+bool TicketTable::fail(uint32_t sendId, const void* exception, uint32_t size)
+{
+	if (!hasPending() || (sendId == 0)) {
+		return false;
+	}
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	for (size_t i = 0; i < CAPACITY; i++) {
+		if ((slots_[i].state == TicketState::Pending) && (slots_[i].sendId == sendId)) {
+			return finish(i, TicketState::Failed, exception, size, lock);
+		}
+	}
+	return false;
+}
+
+TicketState TicketTable::state(uint64_t ticket) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	const Slot* slot{ slotOf(ticket) };
+	return (slot != nullptr) ? slot->state : TicketState::Unknown;
+}
+
+TicketState TicketTable::wait(uint64_t ticket, std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	cv_.wait_for(lock, timeout, [this, ticket]() {
+		const Slot* slot{ slotOf(ticket) };
+		return (slot == nullptr) || (slot->state != TicketState::Pending);
+	});
+	const Slot* slot{ slotOf(ticket) };
+	return (slot != nullptr) ? slot->state : TicketState::Unknown;
+}
+
+size_t TicketTable::reply(uint64_t ticket, void* buffer, size_t size) const
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+
+	const Slot* slot{ slotOf(ticket) };
+	if (slot == nullptr) {
+		return 0;
+	}
+	if ((buffer != nullptr) && (size >= slot->reply.size())) {
+		std::memcpy(buffer, slot->reply.data(), slot->reply.size());
+	}
+	return slot->reply.size();
+}
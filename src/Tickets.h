@@ -0,0 +1,117 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	enum class TicketState : uint32_t {
+		Unknown = 0,		// Never issued, or already released
+		Pending = 1,
+		Completed = 2,
+		Failed = 3,			// The request was answered with an exception
+	};
+
+	/*
+	 * Outstanding one-shot requests, completed by the dispatch path when the reply for their requestId arrives.
+	 * Slots and their reply buffers are allocated up front; a ticket is the slot number plus a generation count,
+	 * so a stale ticket never matches a slot that has been reused.
+	 */
+	class TicketTable {
+	public:
+		static constexpr size_t CAPACITY{ 512 };
+		static constexpr size_t REPLY_RESERVE{ 512 };
+
+		// Called on the dispatch thread, after which the ticket is released.
+		using Callback = std::function<void(uint64_t ticket, TicketState state, const void* reply, uint32_t size)>;
+
+	private:
+		static constexpr uint64_t SLOT_BITS{ 16 };
+		static constexpr uint64_t SLOT_MASK{ (1ull << SLOT_BITS) - 1 };
+
+		struct Slot {
+			uint64_t generation{ 0 };
+			TicketState state{ TicketState::Unknown };
+			uint32_t requestId{ 0 };
+			uint32_t sendId{ 0 };
+			uint64_t sequence{ 0 };
+			Callback callback;
+			std::vector<uint8_t> reply;
+		};
+
+		mutable std::mutex mutex_;
+		std::condition_variable cv_;
+		std::array<Slot, CAPACITY> slots_;
+		size_t next_{ 0 };
+		uint64_t sequence_{ 0 };
+		std::atomic<size_t> pending_{ 0 };
+
+		Slot* slotOf(uint64_t ticket);
+		const Slot* slotOf(uint64_t ticket) const;
+		inline uint64_t ticketOf(size_t index) const { return (slots_[index].generation << SLOT_BITS) | (index + 1); }
+
+		bool finish(size_t index, TicketState state, const void* reply, uint32_t size, std::unique_lock<std::mutex>& lock);
+
+	public:
+		TicketTable();
+		TicketTable(const TicketTable&) = delete;
+		TicketTable(TicketTable&&) = delete;
+		~TicketTable() = default;
+		TicketTable& operator=(const TicketTable&) = delete;
+		TicketTable& operator=(TicketTable&&) = delete;
+
+		/*
+		 * Returns the new ticket, or 0 if all slots are in use.
+		 */
+		uint64_t issue(uint32_t requestId, Callback callback = nullptr);
+		void sent(uint64_t ticket, uint32_t sendId);
+
+		/*
+		 * Fail a pending ticket whose request could not be sent, without a reply.
+		 */
+		bool abort(uint64_t ticket);
+		bool release(uint64_t ticket);
+
+		inline bool hasPending() const { return pending_.load(std::memory_order_acquire) > 0; }
+
+		/*
+		 * Complete the oldest pending ticket for this requestId, or fail the one sent with this SendID.
+		 */
+		bool complete(uint32_t requestId, const void* reply, uint32_t size);
+		bool fail(uint32_t sendId, const void* exception, uint32_t size);
+
+		TicketState state(uint64_t ticket) const;
+		TicketState wait(uint64_t ticket, std::chrono::milliseconds timeout);
+
+		/*
+		 * Copy the reply into the buffer, if it fits, and return its size.
+		 */
+		size_t reply(uint64_t ticket, void* buffer, size_t size) const;
+	};
+
+}
+}
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "WriteFilter.h"
+
+using namespace nl::rakis::interop;
+
+
+void WriteFilter::setEnabled(bool enabled)
+{
+	enabled_.store(enabled, std::memory_order_release);
+	if (!enabled) {
+		clear();
+	}
+}
+
+/*static*/ bool WriteFilter::withinTolerance(const DataSchema& schema, const uint8_t* last, const uint8_t* next)
+{
+	for (const auto& field : schema.fields()) {
+		if (field.epsilon > 0.0f) {
+			const double before{ DataSchema::toDouble(field, last) };
+			const double after{ DataSchema::toDouble(field, next) };
+			if (!std::isnan(before) && !std::isnan(after)) {
+				if (std::abs(after - before) > field.epsilon) {
+					return false;
+				}
+				continue;
+			}
+		}
+		if (std::memcmp(last + field.offset, next + field.offset, field.size) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool WriteFilter::offer(WriteTarget target, uint32_t first, uint32_t second, const DataSchema* schema, const void* data, size_t size)
+{
+	auto bytes{ static_cast<const uint8_t*>(data) };
+	const bool useSchema{ (schema != nullptr) && schema->isFixedSize() && (schema->size() == size) };
+
+	std::scoped_lock<std::mutex> lock(mutex_);
+	auto [it, added] = last_[size_t(target)].try_emplace(keyOf(first, second));
+	auto& last{ it->second };
+	if (!added && (last.size() == size)) {
+		const bool unchanged{ useSchema ? withinTolerance(*schema, last.data(), bytes) : (std::memcmp(last.data(), bytes, size) == 0) };
+		if (unchanged) {
+			suppressed_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+	last.assign(bytes, bytes + size);
+	return true;
+}
+
+void WriteFilter::forget(WriteTarget target, uint32_t first, uint32_t second)
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	last_[size_t(target)].erase(keyOf(first, second));
+}
+
+void WriteFilter::clear()
+{
+	std::scoped_lock<std::mutex> lock(mutex_);
+	for (auto& last : last_) {
+		last.clear();
+	}
+}
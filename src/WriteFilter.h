@@ -0,0 +1,70 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "DataSchema.h"
+
+namespace nl {
+namespace rakis {
+namespace interop {
+
+	enum class WriteTarget : uint8_t {
+		SimObject,		// Keyed by (defId, objectId)
+		ClientData,		// Keyed by (clientDataId, defineId)
+	};
+
+	/*
+	 * The last payload sent per write target, so writes that change nothing can be skipped. With a schema, numeric
+	 * datums compare within their epsilon; everything else must match byte for byte.
+	 */
+	class WriteFilter {
+		std::atomic<bool> enabled_{ false };
+		std::atomic<uint64_t> suppressed_{ 0 };
+
+		mutable std::mutex mutex_;
+		std::unordered_map<uint64_t, std::vector<uint8_t>> last_[2];
+
+		static inline uint64_t keyOf(uint32_t first, uint32_t second) { return (uint64_t(first) << 32) | second; }
+		static bool withinTolerance(const DataSchema& schema, const uint8_t* last, const uint8_t* next);
+
+	public:
+		inline bool isEnabled() const { return enabled_.load(std::memory_order_acquire); }
+		void setEnabled(bool enabled);
+
+		inline uint64_t suppressed() const { return suppressed_.load(std::memory_order_relaxed); }
+
+		/*
+		 * Returns false if the payload is the same as the last one for this target. Otherwise it becomes the last
+		 * one, and the caller should send it. The schema is only used if it describes the whole payload.
+		 */
+		bool offer(WriteTarget target, uint32_t first, uint32_t second, const DataSchema* schema, const void* data, size_t size);
+
+		/*
+		 * Forget the last payload for a target, for example because sending it failed.
+		 */
+		void forget(WriteTarget target, uint32_t first, uint32_t second);
+		void clear();
+	};
+
+}
+}
+}
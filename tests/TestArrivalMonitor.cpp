@@ -0,0 +1,110 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ArrivalMonitor.h"
+
+using namespace nl::rakis::interop;
+
+using Kind = ArrivalMonitor::Kind;
+
+static ArrivalMonitor::Snapshot find(const ArrivalMonitor& monitor, Kind kind, uint32_t requestId)
+{
+	std::vector<ArrivalMonitor::Snapshot> snapshots(16);
+	snapshots.resize(monitor.snapshot(snapshots.data(), snapshots.size()));
+	for (const auto& snapshot : snapshots) {
+		if ((snapshot.kind == kind) && (snapshot.requestId == requestId)) {
+			return snapshot;
+		}
+	}
+	return ArrivalMonitor::Snapshot{};
+}
+
+TEST(ArrivalMonitorTests, TestDisabledByDefault)
+{
+	ArrivalMonitor monitor;
+	monitor.expect(Kind::SimObjectData, 1, 1000000);
+	monitor.arrived(Kind::SimObjectData, 1, 100);
+
+	ArrivalMonitor::Snapshot snapshot;
+	EXPECT_EQ(monitor.snapshot(&snapshot, 1), 0);
+}
+
+TEST(ArrivalMonitorTests, TestExpectedPeriod)
+{
+	ArrivalMonitor monitor;
+	monitor.enable(4);
+	monitor.expect(Kind::SimObjectData, 1, 1000000);
+
+	int64_t time{ 1000 };
+	for (int i = 0; i < 5; i++) {
+		monitor.arrived(Kind::SimObjectData, 1, time);
+		time += 1000000;
+	}
+	time += 2000000;		// Two periods pass without a message
+	monitor.arrived(Kind::SimObjectData, 1, time);
+
+	auto snapshot{ find(monitor, Kind::SimObjectData, 1) };
+	EXPECT_EQ(snapshot.count, 6);
+	EXPECT_EQ(snapshot.lastArrival, time);
+	EXPECT_EQ(snapshot.period, 1000000);
+	EXPECT_EQ(snapshot.missed, 2);
+	EXPECT_EQ(snapshot.histogram[20], 4) << "One second falls between 2^19 and 2^20 microseconds";
+	EXPECT_EQ(snapshot.histogram[22], 1);
+}
+
+TEST(ArrivalMonitorTests, TestLearnedPeriod)
+{
+	ArrivalMonitor monitor;
+	monitor.enable(4);
+	monitor.expect(Kind::ClientData, 7, ArrivalMonitor::LEARN_PERIOD);
+	monitor.expect(Kind::SimObjectData, 7, ArrivalMonitor::NO_PERIOD);
+
+	int64_t time{ 1 };
+	for (int i = 0; i < 50; i++) {
+		monitor.arrived(Kind::ClientData, 7, time);
+		monitor.arrived(Kind::SimObjectData, 7, time);
+		time += 16667;		// 60 frames per second
+	}
+	time += 5 * 16667;
+	monitor.arrived(Kind::ClientData, 7, time);
+	monitor.arrived(Kind::SimObjectData, 7, time);
+
+	auto frames{ find(monitor, Kind::ClientData, 7) };
+	EXPECT_NEAR(double(frames.period), 17000.0, 3000.0);
+	EXPECT_EQ(frames.missed, 5) << "Requests of different kinds are kept apart";
+	EXPECT_EQ(find(monitor, Kind::SimObjectData, 7).missed, 0) << "Without a period nothing is missed";
+}
+
+TEST(ArrivalMonitorTests, TestOverflow)
+{
+	ArrivalMonitor monitor;
+	monitor.enable(2);		// Room for four entries
+
+	for (uint32_t requestId = 0; requestId < 10; requestId++) {
+		monitor.arrived(Kind::SimObjectData, requestId, 100);
+	}
+	std::vector<ArrivalMonitor::Snapshot> snapshots(16);
+	EXPECT_EQ(monitor.snapshot(snapshots.data(), snapshots.size()), 4);
+	EXPECT_EQ(monitor.overflow(), 6);
+
+	monitor.disable();
+	monitor.arrived(Kind::SimObjectData, snapshots[0].requestId, 200);
+	EXPECT_EQ(find(monitor, Kind::SimObjectData, snapshots[0].requestId).count, 1) << "Nothing is counted while disabled";
+}
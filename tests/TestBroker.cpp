@@ -0,0 +1,284 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Broker.h"
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using nl::rakis::interop::BrokerRegion;
+
+/*
+ * Shared memory names outlive a crashed test run, so every run uses its own.
+ */
+static std::string uniqueName(const char* base)
+{
+	return std::format("{}.{}", base, std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+TEST(BrokerTests, TestRegionRing)
+{
+	const std::string name{ uniqueName("BrokerTests.Ring") };
+	auto owner{ BrokerRegion::create(name.c_str(), 4, 16) };
+	ASSERT_NE(owner, nullptr);
+	EXPECT_EQ(BrokerRegion::create(name.c_str(), 4, 16), nullptr) << "Names are exclusive";
+	auto reader{ BrokerRegion::open(name.c_str()) };		// A second mapping, at another address
+	ASSERT_NE(reader, nullptr);
+	EXPECT_EQ(reader->slotCount(), 4);
+	EXPECT_EQ(reader->slotSize(), 16);
+
+	uint64_t cursor{ reader->published() };
+	std::vector<uint8_t> message;
+	EXPECT_EQ(reader->read(cursor, message), BrokerRegion::Read::Empty);
+
+	for (uint32_t i = 0; i < 3; i++) {
+		EXPECT_TRUE(owner->publish(&i, sizeof(i)));
+	}
+	const uint8_t tooLarge[17]{};
+	EXPECT_FALSE(owner->publish(tooLarge, sizeof(tooLarge)));
+	for (uint32_t i = 0; i < 3; i++) {
+		ASSERT_EQ(reader->read(cursor, message), BrokerRegion::Read::Message);
+		ASSERT_EQ(message.size(), sizeof(uint32_t));
+		EXPECT_EQ(*reinterpret_cast<uint32_t*>(message.data()), i);
+	}
+	EXPECT_EQ(reader->read(cursor, message), BrokerRegion::Read::Empty);
+
+	// Fall more than a full ring behind
+	for (uint32_t i = 3; i < 13; i++) {
+		owner->publish(&i, sizeof(i));
+	}
+	EXPECT_EQ(reader->read(cursor, message), BrokerRegion::Read::Lapped);
+	EXPECT_EQ(cursor, 10) << "The reader skips to the oldest message that is not about to be overwritten";
+	for (uint32_t i = 10; i < 13; i++) {
+		ASSERT_EQ(reader->read(cursor, message), BrokerRegion::Read::Message);
+		EXPECT_EQ(*reinterpret_cast<uint32_t*>(message.data()), i);
+	}
+}
+
+TEST(BrokerTests, TestRegionQueue)
+{
+	const std::string name{ uniqueName("BrokerTests.Queue") };
+	auto owner{ BrokerRegion::create(name.c_str(), 4, 16) };
+	ASSERT_NE(owner, nullptr);
+
+	std::vector<std::thread> senders;
+	for (uint32_t t = 0; t < 4; t++) {
+		senders.emplace_back([&name, t]() {
+			auto client{ BrokerRegion::open(name.c_str()) };
+			for (uint32_t i = 0; i < 1000; i++) {
+				const uint32_t value{ t * 1000 + i };
+				while (!client->enqueue(&value, sizeof(value))) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	std::vector<bool> seen(4000, false);
+	std::vector<uint8_t> request;
+	uint32_t received{ 0 };
+	auto deadline{ std::chrono::steady_clock::now() + 10s };
+	while ((received < 4000) && (std::chrono::steady_clock::now() < deadline)) {
+		if (!owner->dequeue(request)) {
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_EQ(request.size(), sizeof(uint32_t));
+		const uint32_t value{ *reinterpret_cast<uint32_t*>(request.data()) };
+		ASSERT_LT(value, 4000);
+		EXPECT_FALSE(seen[value]);
+		seen[value] = true;
+		received++;
+	}
+	for (auto& sender : senders) {
+		sender.join();
+	}
+	EXPECT_EQ(received, 4000) << "Every request arrives exactly once";
+
+	for (uint32_t i = 0; i < BrokerRegion::REQUEST_SLOTS; i++) {
+		EXPECT_TRUE(owner->enqueue(&i, sizeof(i)));
+	}
+	EXPECT_FALSE(owner->enqueue(&received, sizeof(received))) << "The queue is full";
+}
+
+TEST(BrokerTests, TestSharedConnection)
+{
+	standin::reset();
+
+	const std::string name{ uniqueName("BrokerTests.Connection") };
+	HANDLE owner;
+	ASSERT_TRUE(CsConnect("BrokerTests", owner));
+	ASSERT_TRUE(CsStartBroker(owner, name.c_str(), 64, 512));
+	EXPECT_FALSE(CsStartBroker(owner, name.c_str(), 64, 512));
+
+	HANDLE client;
+	EXPECT_FALSE(CsConnectBroker("BrokerTests.Missing", client));
+	ASSERT_TRUE(CsConnectBroker(name.c_str(), client));
+
+	std::mutex mutex;
+	std::vector<std::string> calls;
+	standin::setCallHook([&mutex, &calls, owner](const standin::Call& call) {
+		if (call.handle == owner) {
+			std::scoped_lock<std::mutex> lock(mutex);
+			calls.push_back(call.api);
+		}
+	});
+	EXPECT_EQ(CsAddToDataDefinition(client, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 1) << "Clients get no SendIDs";
+	EXPECT_EQ(CsRequestDataOnSimObject(client, 70, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0), 1);
+	EXPECT_EQ(CsGetDataDefinitionSize(client, 7), 8) << "The client keeps its own native state";
+
+	auto deadline{ std::chrono::steady_clock::now() + 5s };
+	auto callsMade = [&mutex, &calls]() { std::scoped_lock<std::mutex> lock(mutex); return calls.size(); };
+	while ((callsMade() < 2) && (std::chrono::steady_clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	standin::setCallHook(nullptr);
+	const std::vector<std::string> expected{ "AddToDataDefinition", "RequestDataOnSimObject" };
+	EXPECT_EQ(calls, expected) << "The owner performs the client's requests, in order";
+
+	const double altitude{ 1234.5 };
+	standin::pushSimObjectData(owner, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+	standin::pushEvent(owner, 1, 2, 3);
+	static std::vector<DWORD> ownerReceived;
+	static std::vector<DWORD> clientReceived;
+	ownerReceived.clear();
+	clientReceived.clear();
+	while (CsGetNextDispatch(owner, [](SIMCONNECT_RECV* msg, DWORD, void*) { ownerReceived.push_back(msg->dwID); })) {
+	}
+	EXPECT_EQ(ownerReceived.size(), 2);
+
+	EXPECT_TRUE(CsCallDispatch(client, [](SIMCONNECT_RECV* msg, DWORD size, void*) {
+		clientReceived.push_back(msg->dwID);
+		if (msg->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA) {
+			auto data{ static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(msg) };
+			EXPECT_EQ(data->dwRequestID, 70);
+			EXPECT_EQ(*reinterpret_cast<const double*>(&data->dwData), 1234.5);
+		}
+	}));
+	EXPECT_EQ(clientReceived, ownerReceived) << "The client sees everything the owner received";
+
+	uint64_t messages, dropped, requests;
+	ASSERT_TRUE(CsGetBrokerStatistics(owner, &messages, &dropped, &requests));
+	EXPECT_EQ(messages, 2);
+	EXPECT_EQ(dropped, 0);
+	EXPECT_EQ(requests, 2);
+	ASSERT_TRUE(CsGetBrokerStatistics(client, &messages, &dropped, &requests));
+	EXPECT_EQ(dropped, 0);
+
+	EXPECT_FALSE(CsReconnect(client));
+	EXPECT_TRUE(CsDisconnect(client));
+	EXPECT_TRUE(CsStopBroker(owner));
+	EXPECT_FALSE(CsStopBroker(owner));
+	EXPECT_TRUE(CsDisconnect(owner));
+	standin::reset();
+}
+
+/*
+ * The client side of TestSeparateProcesses, run in a process of its own. The region name is passed in the environment.
+ */
+static constexpr const char* CHILD_REGION{ "CS_BROKER_TEST_REGION" };
+
+TEST(BrokerTests, TestClientProcess)
+{
+	char name[MAX_PATH];
+	const DWORD length{ GetEnvironmentVariableA(CHILD_REGION, name, MAX_PATH) };
+	if ((length == 0) || (length >= MAX_PATH)) {
+		GTEST_SKIP() << "Started by TestSeparateProcesses";
+	}
+	HANDLE client;
+	ASSERT_TRUE(CsConnectBroker(name, client));
+	EXPECT_EQ(CsAddToDataDefinition(client, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 1);
+	EXPECT_EQ(CsRequestDataOnSimObject(client, 70, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0), 1);
+
+	static double altitude;
+	altitude = 0.0;
+	auto deadline{ std::chrono::steady_clock::now() + 10s };
+	while ((altitude == 0.0) && (std::chrono::steady_clock::now() < deadline)) {
+		CsCallDispatch(client, [](SIMCONNECT_RECV* msg, DWORD, void*) {
+			if ((msg->dwID == SIMCONNECT_RECV_ID_SIMOBJECT_DATA) && (static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(msg)->dwRequestID == 70)) {
+				altitude = *reinterpret_cast<const double*>(&static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(msg)->dwData);
+			}
+		});
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(altitude, 1234.5) << "The owner's data reaches another process";
+	EXPECT_TRUE(CsDisconnect(client));
+}
+
+TEST(BrokerTests, TestSeparateProcesses)
+{
+	standin::reset();
+
+	const std::string name{ uniqueName("BrokerTests.Process") };
+	HANDLE owner;
+	ASSERT_TRUE(CsConnect("BrokerTests", owner));
+	ASSERT_TRUE(CsStartBroker(owner, name.c_str(), 64, 512));
+
+	static std::atomic<uint32_t> performed;
+	performed = 0;
+	standin::setCallHook([owner](const standin::Call& call) {
+		if ((call.handle == owner) && ((std::string(call.api) == "AddToDataDefinition") || (std::string(call.api) == "RequestDataOnSimObject"))) {
+			performed++;
+		}
+	});
+
+	// Run this test binary again for the client side only
+	char path[MAX_PATH];
+	ASSERT_GT(GetModuleFileNameA(nullptr, path, MAX_PATH), 0);
+	std::string commandLine{ std::format("\"{}\" --gtest_filter=BrokerTests.TestClientProcess", path) };
+	STARTUPINFOA startup{ sizeof(startup) };
+	PROCESS_INFORMATION process{};
+	SetEnvironmentVariableA(CHILD_REGION, name.c_str());
+	const BOOL started{ CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup, &process) };
+	SetEnvironmentVariableA(CHILD_REGION, nullptr);
+	ASSERT_TRUE(started);
+
+	auto deadline{ std::chrono::steady_clock::now() + 10s };
+	while ((performed < 2) && (std::chrono::steady_clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	standin::setCallHook(nullptr);
+	EXPECT_EQ(performed, 2) << "The owner performs the requests of the other process";
+
+	const double altitude{ 1234.5 };
+	standin::pushSimObjectData(owner, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+	while ((WaitForSingleObject(process.hProcess, 1) == WAIT_TIMEOUT) && (std::chrono::steady_clock::now() < deadline)) {
+		CsGetNextDispatch(owner, [](SIMCONNECT_RECV*, DWORD, void*) {});
+	}
+	DWORD exitCode{ STILL_ACTIVE };
+	EXPECT_TRUE(GetExitCodeProcess(process.hProcess, &exitCode));
+	EXPECT_EQ(exitCode, 0) << "The client process passed";
+	CloseHandle(process.hThread);
+	CloseHandle(process.hProcess);
+
+	// The region outlives the client's mapping, but not the owner's
+	HANDLE client;
+	ASSERT_TRUE(CsConnectBroker(name.c_str(), client));
+	EXPECT_TRUE(CsDisconnect(client));
+	EXPECT_TRUE(CsStopBroker(owner));
+	EXPECT_FALSE(CsConnectBroker(name.c_str(), client));
+	EXPECT_TRUE(CsDisconnect(owner));
+	standin::reset();
+}
@@ -0,0 +1,115 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "ClientDataChannel.h"
+
+using namespace nl::rakis::interop;
+
+struct Sent {
+	uint32_t defId;
+	std::vector<uint8_t> data;
+};
+
+TEST(ClientDataChannelTests, TestRanges)
+{
+	ClientDataChannel channel(7, 1000, 256, 100);
+
+	EXPECT_EQ(channel.rangeCount(), 4);
+	EXPECT_EQ(channel.rangeOffset(3), 768);
+	EXPECT_EQ(channel.rangeSize(3), 232) << "The last range is short";
+	EXPECT_EQ(channel.defId(2), 102);
+	EXPECT_TRUE(channel.ownsDefId(103));
+	EXPECT_FALSE(channel.ownsDefId(104));
+	EXPECT_FALSE(channel.ownsDefId(99));
+}
+
+TEST(ClientDataChannelTests, TestCommitSendsChangedRanges)
+{
+	ClientDataChannel channel(7, 1000, 256, 100);
+	std::vector<Sent> sent;
+	auto send = [&sent](uint32_t defId, const uint8_t* data, uint32_t size) {
+		sent.push_back(Sent{ defId, std::vector<uint8_t>(data, data + size) });
+		return true;
+	};
+
+	EXPECT_EQ(channel.commit(send), 0) << "Nothing changed yet";
+
+	channel.buffer()[10] = 1;
+	channel.buffer()[999] = 2;
+	EXPECT_EQ(channel.commit(send), 2);
+	ASSERT_EQ(sent.size(), 2);
+	EXPECT_EQ(sent[0].defId, 100);
+	EXPECT_EQ(sent[0].data.size(), 256);
+	EXPECT_EQ(sent[0].data[10], 1);
+	EXPECT_EQ(sent[1].defId, 103);
+	EXPECT_EQ(sent[1].data.size(), 232);
+	EXPECT_EQ(sent[1].data.back(), 2);
+
+	sent.clear();
+	EXPECT_EQ(channel.commit(send), 0) << "Committed ranges are not sent again";
+
+	channel.buffer()[300] = 3;
+	EXPECT_EQ(channel.commit([](uint32_t, const uint8_t*, uint32_t) { return false; }), 0);
+	EXPECT_EQ(channel.commit(send), 1) << "A failed range stays dirty";
+	ASSERT_EQ(sent.size(), 1);
+	EXPECT_EQ(sent[0].defId, 101);
+}
+
+TEST(ClientDataChannelTests, TestAccept)
+{
+	ClientDataChannel channel(7, 512, 256, 100);
+	std::vector<uint8_t> incoming(256, 9);
+
+	EXPECT_FALSE(channel.accept(102, incoming.data(), incoming.size()));
+
+	EXPECT_TRUE(channel.accept(100, incoming.data(), incoming.size()));
+	EXPECT_EQ(channel.buffer()[0], 0) << "Received data waits for the client";
+	EXPECT_EQ(channel.refresh(), 1);
+	EXPECT_EQ(channel.buffer()[0], 9) << "Clean ranges take the received data";
+	EXPECT_EQ(channel.commit([](uint32_t, const uint8_t*, uint32_t) { return true; }), 0) << "Received data is not echoed back";
+
+	channel.buffer()[256] = 1;
+	EXPECT_TRUE(channel.accept(101, incoming.data(), incoming.size()));
+	EXPECT_EQ(channel.refresh(), 0);
+	EXPECT_EQ(channel.buffer()[256], 1) << "Dirty ranges keep the client's version";
+	EXPECT_EQ(channel.commit([](uint32_t, const uint8_t*, uint32_t) { return true; }), 1);
+}
+
+TEST(ClientDataChannelTests, TestWriteDuringReceive)
+{
+	ClientDataChannel channel(7, 256, 256, 100);
+	std::vector<uint8_t> incoming(256, 9);
+
+	// The client writes while data for the same range arrives; its write must not be lost.
+	EXPECT_TRUE(channel.accept(100, incoming.data(), incoming.size()));
+	channel.buffer()[5] = 1;
+	EXPECT_TRUE(channel.accept(100, incoming.data(), incoming.size()));
+
+	std::vector<uint8_t> sent;
+	EXPECT_EQ(channel.commit([&sent](uint32_t, const uint8_t* data, uint32_t size) {
+		sent.assign(data, data + size);
+		return true;
+	}), 1);
+	ASSERT_EQ(sent.size(), 256);
+	EXPECT_EQ(sent[5], 1);
+	EXPECT_EQ(channel.buffer()[5], 1);
+}
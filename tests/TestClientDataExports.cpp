@@ -0,0 +1,106 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::string> callsTo(const std::vector<std::string>& log, const std::string& api)
+{
+	std::vector<std::string> result;
+	std::copy_if(log.begin(), log.end(), std::back_inserter(result), [&api](const std::string& line) {
+		return line.starts_with(api + " ");
+	});
+	return result;
+}
+
+static void waitForSchedulerCount(HANDLE handle, uint64_t CsSchedulerStatistics::* counter, uint64_t count)
+{
+	CsSchedulerStatistics stats{};
+	const auto deadline{ Clock::now() + 2s };
+	while ((CsGetSchedulerStatistics(handle, CS_PRIORITY_NORMAL, &stats), stats.*counter < count) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+}
+
+TEST(ClientDataExportTests, TestChannelSendsChangedRanges)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("ClientDataExportTests", handle));
+	standin::enableCallLog(true);
+
+	ASSERT_EQ(CsOpenClientDataChannel(handle, 3, 64, 16, 100, 1), 4);
+	auto log{ standin::takeCallLog() };
+	EXPECT_EQ(callsTo(log, "CreateClientData").size(), 1);
+	EXPECT_EQ(callsTo(log, "AddToClientDataDefinition").size(), 4);
+
+	void* buffer{ nullptr };
+	ASSERT_TRUE(CsGetClientDataChannelBuffer(handle, 3, &buffer));
+	ASSERT_NE(buffer, nullptr);
+	auto bytes{ static_cast<uint8_t*>(buffer) };
+
+	// Only the ranges written to are sent, and only once
+	bytes[16] = 1;
+	bytes[63] = 2;
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 2);
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "SetClientData"),
+		(std::vector<std::string>{ "SetClientData 3 101 0 16", "SetClientData 3 103 0 16" }));
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 0);
+	EXPECT_TRUE(callsTo(standin::takeCallLog(), "SetClientData").empty());
+
+	// A range that failed to send stays changed (the stand-in does not log a call it fails)
+	bytes[0] = 3;
+	standin::failNext(E_FAIL);
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 0);
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 1);
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "SetClientData"),
+		(std::vector<std::string>{ "SetClientData 3 100 0 16" }));
+
+	// A range whose queued send failed is sent again by the next commit
+	ASSERT_TRUE(CsSetScheduling(handle, true));
+	bytes[32] = 4;
+	standin::failNext(E_FAIL);
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 1);
+	waitForSchedulerCount(handle, &CsSchedulerStatistics::failed, 1);
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 1);
+	waitForSchedulerCount(handle, &CsSchedulerStatistics::sent, 1);
+	EXPECT_EQ(CsCommitClientDataChannel(handle, 3), 0);
+	ASSERT_TRUE(CsSetScheduling(handle, false));
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "SetClientData"),
+		(std::vector<std::string>{ "SetClientData 3 102 0 16" }));
+
+	EXPECT_TRUE(CsCloseClientDataChannel(handle, 3));
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "ClearClientDataDefinition"),
+		(std::vector<std::string>{ "ClearClientDataDefinition 100", "ClearClientDataDefinition 101",
+			"ClearClientDataDefinition 102", "ClearClientDataDefinition 103" }));
+	EXPECT_FALSE(CsGetClientDataChannelBuffer(handle, 3, &buffer));
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
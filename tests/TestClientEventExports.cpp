@@ -0,0 +1,151 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static void ignore(SIMCONNECT_RECV*, DWORD, void*)
+{
+}
+
+static std::vector<std::string> callsTo(const std::vector<std::string>& log, const std::string& api)
+{
+	std::vector<std::string> result;
+	std::copy_if(log.begin(), log.end(), std::back_inserter(result), [&api](const std::string& line) {
+		return line.starts_with(api + " ");
+	});
+	return result;
+}
+
+TEST(ClientEventExportTests, TestCoalescedTransmits)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("ClientEventExportTests", handle));
+	standin::enableCallLog(true);
+
+	// Transmits of a coalesced event wait for a flush, which sends only the latest value per object
+	ASSERT_TRUE(CsSetEventCoalescing(handle, 42, true));
+	for (uint32_t i = 0; i < 10; i++) {
+		EXPECT_EQ(CsTransmitClientEvent(handle, 0, 42, i, 1, 16), TRUE);
+		EXPECT_EQ(CsTransmitClientEvent(handle, 7, 42, 100 + i, 1, 16), TRUE);
+	}
+	EXPECT_TRUE(CsTransmitClientEvent(handle, 0, 43, 5, 1, 16) > 1) << "Other events are sent right away";
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "TransmitClientEvent"), (std::vector<std::string>{ "TransmitClientEvent 0 43 5 1 16" }));
+	EXPECT_EQ(CsFlushCoalescedEvents(handle), 2);
+	auto transmits{ callsTo(standin::takeCallLog(), "TransmitClientEvent") };
+	std::sort(transmits.begin(), transmits.end());
+	EXPECT_EQ(transmits, (std::vector<std::string>{ "TransmitClientEvent 0 42 9 1 16", "TransmitClientEvent 7 42 109 1 16" }));
+	EXPECT_EQ(CsFlushCoalescedEvents(handle), 0);
+
+	// Flushing on every frame
+	ASSERT_TRUE(CsSetCoalescingFlush(handle, 0, true));
+	for (uint32_t i = 0; i < 10; i++) {
+		CsTransmitClientEvent(handle, 0, 42, 200 + i, 1, 16);
+	}
+	standin::pushFrame(handle, 1);
+	EXPECT_TRUE(CsGetNextDispatch(handle, ignore));
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "TransmitClientEvent"), (std::vector<std::string>{ "TransmitClientEvent 0 42 209 1 16" }));
+
+	// Flushing on a timer, which ends with the latest value
+	EXPECT_FALSE(CsSetCoalescingFlush(handle, 1000001, false)) << "Rates above 1000 Hz are refused";
+	std::atomic<uint32_t> transmitted{ 0 };
+	std::atomic<uint32_t> lastData{ 0 };
+	standin::setCallHook([&transmitted, &lastData](const standin::Call& call) {
+		if (std::string(call.api) == "TransmitClientEvent") {
+			lastData = call.args[2];
+			transmitted++;
+		}
+	});
+	ASSERT_TRUE(CsSetCoalescingFlush(handle, 100, false));
+	for (uint32_t i = 0; i < 10; i++) {
+		CsTransmitClientEvent(handle, 0, 42, 300 + i, 1, 16);
+	}
+	const auto deadline{ Clock::now() + 2s };
+	while ((lastData != 309) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(lastData, 309);
+	EXPECT_LT(transmitted, 10) << "The timer flushed every transmit on its own";
+	ASSERT_TRUE(CsSetCoalescingFlush(handle, 0, false));
+	standin::setCallHook(nullptr);
+
+	// Disabling coalescing sends what is still pending, and later transmits go straight through
+	EXPECT_EQ(CsTransmitClientEvent(handle, 0, 42, 400, 1, 16), TRUE);
+	standin::takeCallLog();
+	ASSERT_TRUE(CsSetEventCoalescing(handle, 42, false));
+	EXPECT_EQ(callsTo(standin::takeCallLog(), "TransmitClientEvent"), (std::vector<std::string>{ "TransmitClientEvent 0 42 400 1 16" }));
+	EXPECT_GT(CsTransmitClientEvent(handle, 0, 42, 401, 1, 16), 1);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(ClientEventExportTests, TestInternedMappings)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("ClientEventExportTests", handle));
+	standin::enableCallLog(true);
+
+	// Only the first intern of a name is sent, later ones get the ids already mapped
+	uint32_t eventId{ 0 };
+	EXPECT_GT(CsInternClientEvent(handle, "AP_MASTER", 10, &eventId), 1);
+	EXPECT_EQ(eventId, 10);
+	EXPECT_EQ(CsInternClientEvent(handle, "ap_master", 20, &eventId), TRUE);
+	EXPECT_EQ(eventId, 10);
+	EXPECT_EQ(CsInternClientEvent(handle, "AP_ALT_VAR_INC", 10, &eventId), E_INVALIDARG) << "Client event 10 is taken";
+
+	uint32_t downEventId{ 0 };
+	uint32_t upEventId{ 0 };
+	EXPECT_GT(CsInternInputEvent(handle, 1, "joystick:0:button:1", 30, 0, 31, 0, 0, &downEventId, &upEventId), 1);
+	EXPECT_EQ(CsInternInputEvent(handle, 1, "joystick:0:button:1", 40, 0, 41, 0, 0, &downEventId, &upEventId), TRUE);
+	EXPECT_EQ(downEventId, 30);
+	EXPECT_EQ(upEventId, 31);
+	EXPECT_EQ(standin::takeCallLog(), (std::vector<std::string>{ "MapClientEventToSimEvent 10 AP_MASTER",
+		"MapInputEventToClientEvent 1 joystick:0:button:1 30 0 31 0 0" }));
+
+	// Lookups never call SimConnect
+	const char* const names[3]{ "AP_MASTER", "NOT_MAPPED", "Ap_Master" };
+	int64_t eventIds[3]{};
+	EXPECT_EQ(CsLookupClientEvents(handle, names, 3, eventIds), 2);
+	EXPECT_EQ(eventIds[0], 10);
+	EXPECT_EQ(eventIds[1], -1);
+	EXPECT_EQ(eventIds[2], 10);
+	EXPECT_TRUE(standin::takeCallLog().empty());
+
+	EXPECT_EQ(CsInternClientEvent(handle, "AP_MASTER", 10, nullptr), E_INVALIDARG);
+	EXPECT_EQ(CsLookupClientEvents(handle, nullptr, 3, eventIds), E_INVALIDARG);
+	EXPECT_EQ(CsLookupClientEvents(nullptr, names, 3, eventIds), FALSE);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+
+static std::atomic<uint32_t> received{ 0 };
+
+static void countMessages(SIMCONNECT_RECV*, DWORD, void*)
+{
+	received++;
+}
+
+TEST(ConnectionPoolTests, TestRouting)
+{
+	standin::reset();
+
+	HANDLE pool;
+	ASSERT_TRUE(CsConnectPool("PoolTests", 3, pool));
+	HANDLE shards[3];
+	for (uint32_t i = 0; i < 3; i++) {
+		ASSERT_TRUE(CsGetPoolShard(pool, i, shards[i]));
+	}
+	EXPECT_NE(shards[0], shards[1]);
+	EXPECT_NE(shards[1], shards[2]);
+	HANDLE shard;
+	EXPECT_FALSE(CsGetPoolShard(pool, 3, shard));
+
+	EXPECT_TRUE(CsAssignPoolRequests(pool, 1, 9, 0));
+	EXPECT_FALSE(CsAssignPoolRequests(pool, 5, 20, 1)) << "Ranges cannot overlap";
+	EXPECT_FALSE(CsAssignPoolRequests(pool, 10, 19, 3)) << "No such shard";
+
+	for (uint32_t requestId = 1; requestId <= 9; requestId++) {
+		ASSERT_TRUE(CsGetPoolShardForRequest(pool, requestId, CS_POOL_CLASS_OBJECT, shard));
+		EXPECT_EQ(shard, shards[0]);
+	}
+	std::set<HANDLE> used;
+	for (uint32_t requestId = 100; requestId < 200; requestId++) {
+		ASSERT_TRUE(CsGetPoolShardForRequest(pool, requestId, CS_POOL_CLASS_OBJECT, shard));
+		EXPECT_NE(shard, shards[0]) << "Assigned shards only carry their own requests";
+		used.insert(shard);
+	}
+	EXPECT_EQ(used.size(), 2);
+
+	EXPECT_TRUE(CsAssignPoolClass(pool, CS_POOL_CLASS_OBJECT_TYPE, 2));
+	EXPECT_FALSE(CsAssignPoolClass(pool, 2, 1)) << "No such class";
+	for (uint32_t requestId = 100; requestId < 200; requestId++) {
+		ASSERT_TRUE(CsGetPoolShardForRequest(pool, requestId, CS_POOL_CLASS_OBJECT_TYPE, shard));
+		EXPECT_EQ(shard, shards[2]);
+		ASSERT_TRUE(CsGetPoolShardForRequest(pool, requestId, CS_POOL_CLASS_OBJECT, shard));
+		EXPECT_EQ(shard, shards[1]) << "Only the unassigned shard is left for hashing";
+	}
+	ASSERT_TRUE(CsGetPoolShardForRequest(pool, 5, CS_POOL_CLASS_OBJECT_TYPE, shard));
+	EXPECT_EQ(shard, shards[0]) << "Ranges take precedence over classes";
+
+	EXPECT_TRUE(CsDisconnectPool(pool));
+	EXPECT_FALSE(CsDisconnectPool(pool));
+	standin::reset();
+}
+
+TEST(ConnectionPoolTests, TestDefinitionsFollowRequests)
+{
+	standin::reset();
+
+	HANDLE pool;
+	ASSERT_TRUE(CsConnectPool("PoolTests", 2, pool));
+	HANDLE first, second;
+	ASSERT_TRUE(CsGetPoolShard(pool, 0, first));
+	ASSERT_TRUE(CsGetPoolShard(pool, 1, second));
+	ASSERT_TRUE(CsAssignPoolRequests(pool, 50, 50, 1));
+
+	EXPECT_GT(CsAddToDataDefinition(first, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_GT(CsAddToDataDefinition(first, 7, "PLANE LATITUDE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+
+	std::mutex mutex;
+	std::vector<std::string> calls;
+	standin::setCallHook([&mutex, &calls, second](const standin::Call& call) {
+		if (call.handle == second) {
+			std::scoped_lock<std::mutex> lock(mutex);
+			calls.push_back(call.api);
+		}
+	});
+	EXPECT_GT(CsPoolRequestDataOnSimObject(pool, 50, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0), 1);
+	EXPECT_GT(CsPoolRequestDataOnSimObject(pool, 50, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_NEVER, 0, 0, 0, 0), 1);
+	standin::setCallHook(nullptr);
+
+	const std::vector<std::string> expected{ "AddToDataDefinition", "AddToDataDefinition", "RequestDataOnSimObject", "RequestDataOnSimObject" };
+	EXPECT_EQ(calls, expected) << "The definition is copied to the second shard once";
+
+	// A definition redefined on the first shard is copied again.
+	EXPECT_GT(CsClearDataDefinition(first, 7), 0);
+	EXPECT_GT(CsAddToDataDefinition(first, 7, "PLANE HEADING DEGREES TRUE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	calls.clear();
+	standin::setCallHook([&mutex, &calls, second](const standin::Call& call) {
+		if (call.handle == second) {
+			std::scoped_lock<std::mutex> lock(mutex);
+			calls.push_back(call.api);
+		}
+	});
+	EXPECT_GT(CsPoolRequestDataOnSimObject(pool, 50, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0), 1);
+	standin::setCallHook(nullptr);
+	const std::vector<std::string> recopied{ "ClearDataDefinition", "AddToDataDefinition", "RequestDataOnSimObject" };
+	EXPECT_EQ(calls, recopied);
+
+	EXPECT_TRUE(CsDisconnectPool(pool));
+	standin::reset();
+}
+
+TEST(ConnectionPoolTests, TestDispatchThreads)
+{
+	standin::reset();
+	received = 0;
+
+	HANDLE pool;
+	ASSERT_TRUE(CsConnectPool("PoolTests", 3, pool));
+	ASSERT_TRUE(CsStartPoolDispatch(pool, countMessages));
+	for (uint32_t i = 0; i < 3; i++) {
+		HANDLE shard;
+		ASSERT_TRUE(CsGetPoolShard(pool, i, shard));
+		standin::pushEvent(shard, 1, 2, i);
+		standin::pushEvent(shard, 1, 2, i);
+	}
+	auto deadline{ std::chrono::steady_clock::now() + 5s };
+	while ((received < 6) && (std::chrono::steady_clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(received, 6) << "Every shard delivers to the same callback";
+	EXPECT_TRUE(CsStopPoolDispatch(pool));
+
+	EXPECT_TRUE(CsDisconnectPool(pool));
+	standin::reset();
+}
@@ -0,0 +1,82 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+TEST(DataDefinitionExportTests, TestColumnsRoundTrip)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DataDefinitionExportTests", handle));
+
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "SIM ON GROUND", "bool", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "AIRSPEED INDICATED", "knots", SIMCONNECT_DATATYPE_FLOAT32, 0.0f, SIMCONNECT_UNUSED), 0);
+	ASSERT_EQ(CsGetDataDefinitionSize(handle, 7), 16);
+
+	const double altitudes[3]{ 1000.0, 2500.5, 0.0 };
+	const int32_t onGround[3]{ 0, 0, 1 };
+	const float speeds[3]{ 120.0f, 180.5f, 0.0f };
+	const void* const columns[3]{ altitudes, onGround, speeds };
+
+	// Packing gives the native layout, one row per object, and unpacking gives the columns back
+	uint8_t buffer[48]{};
+	ASSERT_EQ(CsPackDataDefinition(handle, 7, 3, columns, buffer, sizeof(buffer)), 48);
+	double row1Altitude;
+	std::memcpy(&row1Altitude, buffer + 16, sizeof(row1Altitude));
+	EXPECT_EQ(row1Altitude, 2500.5);
+
+	double altitudesBack[3]{};
+	int32_t onGroundBack[3]{};
+	float speedsBack[3]{};
+	void* const columnsBack[3]{ altitudesBack, onGroundBack, speedsBack };
+	ASSERT_EQ(CsUnpackDataDefinition(handle, 7, 3, buffer, sizeof(buffer), columnsBack, 0), 3);
+	EXPECT_EQ(std::memcmp(altitudesBack, altitudes, sizeof(altitudes)), 0);
+	EXPECT_EQ(std::memcmp(onGroundBack, onGround, sizeof(onGround)), 0);
+	EXPECT_EQ(std::memcmp(speedsBack, speeds, sizeof(speeds)), 0);
+	EXPECT_EQ(CsPackDataDefinition(handle, 7, 3, columns, buffer, 47), E_INVALIDARG);
+
+	// Writing the columns sends one packed row per object
+	standin::enableCallLog(true);
+	const uint32_t objectIds[3]{ 10, 11, 12 };
+	int64_t results[3]{};
+	ASSERT_EQ(CsSetDataOnSimObjects(handle, 7, 3, objectIds, 0, columns, results), 3);
+	for (auto result : results) {
+		EXPECT_GT(result, 0);
+	}
+	EXPECT_EQ(standin::takeCallLog(), (std::vector<std::string>{ "SetDataOnSimObject 7 10 0 1 16",
+		"SetDataOnSimObject 7 11 0 1 16", "SetDataOnSimObject 7 12 0 1 16" }));
+	const auto payloads{ standin::takePayloads() };
+	ASSERT_EQ(payloads.size(), 3);
+	for (size_t i = 0; i < payloads.size(); i++) {
+		ASSERT_EQ(payloads[i].size(), 16);
+		EXPECT_EQ(std::memcmp(payloads[i].data(), buffer + 16 * i, 16), 0) << "Row " << i;
+	}
+
+	EXPECT_EQ(CsSetDataOnSimObjects(handle, 8, 3, objectIds, 0, columns, results), E_INVALIDARG);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "DataSchema.h"
+
+using namespace nl::rakis::interop;
+
+TEST(DataSchemaTests, TestLayout)
+{
+	DataSchemas schemas;
+
+	schemas.add(1, "PLANE LATITUDE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schemas.add(1, "TITLE", nullptr, SIMCONNECT_DATATYPE_STRING256, 0.0f, SIMCONNECT_UNUSED);
+	schemas.add(1, "SIM ON GROUND", "bool", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED);
+
+	auto schema{ schemas.find(1) };
+	ASSERT_NE(schema, nullptr);
+	ASSERT_EQ(schema->fields().size(), 3);
+	EXPECT_EQ(schema->fields()[1].offset, 8);
+	EXPECT_EQ(schema->fields()[2].offset, 264);
+	EXPECT_EQ(schema->size(), 268);
+	EXPECT_TRUE(schema->isFixedSize());
+
+	schemas.add(1, "ATC ID", nullptr, SIMCONNECT_DATATYPE_STRINGV, 0.0f, SIMCONNECT_UNUSED);
+	EXPECT_FALSE(schemas.find(1)->isFixedSize());
+	EXPECT_TRUE(schema->isFixedSize()) << "Published schemas must not change";
+
+	schemas.clear(1);
+	EXPECT_EQ(schemas.find(1), nullptr);
+}
+
+TEST(DataSchemaTests, TestPackUnpack)
+{
+	DataSchema schema;
+	schema.add("PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema.add("TRANSPONDER CODE:1", "number", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED);
+
+	double altitudes[3]{ 1000.0, 2000.0, 3000.0 };
+	int32_t squawks[3]{ 1200, 7000, 2000 };
+	const void* columns[2]{ altitudes, squawks };
+
+	uint8_t rows[3 * 12];
+	schema.pack(3, columns, rows);
+
+	double altitude;
+	std::memcpy(&altitude, rows + 12, sizeof(altitude));
+	EXPECT_EQ(altitude, 2000.0);
+
+	double altitudesOut[4]{};
+	int32_t squawksOut[4]{};
+	void* columnsOut[2]{ altitudesOut, squawksOut };
+	schema.unpack(3, rows, columnsOut, 1);
+	EXPECT_EQ(altitudesOut[0], 0.0);
+	EXPECT_EQ(altitudesOut[3], 3000.0);
+	EXPECT_EQ(squawksOut[1], 1200);
+
+	uint8_t row[12];
+	schema.packRow(2, columns, row);
+	EXPECT_EQ(std::memcmp(row, rows + 24, sizeof(row)), 0);
+}
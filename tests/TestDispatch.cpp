@@ -0,0 +1,541 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<uint32_t> received{ 0 };
+
+static void countMessages(SIMCONNECT_RECV*, DWORD, void*)
+{
+	received++;
+}
+
+TEST(DispatchTests, TestWaitForDispatch)
+{
+	standin::reset();
+	received = 0;
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnectWithEvent("DispatchTests", handle));
+
+	auto cpuStart{ std::clock() };
+	auto start{ Clock::now() };
+	EXPECT_EQ(CsWaitForDispatch(handle, 200, countMessages), 0) << "Nothing to dispatch";
+	EXPECT_GE(Clock::now() - start, 190ms);
+	EXPECT_LT(double(std::clock() - cpuStart) / CLOCKS_PER_SEC, 0.02) << "Waiting does not burn CPU";
+
+	standin::pushEvent(handle, 1, 2, 3);
+	standin::pushEvent(handle, 1, 2, 4);
+	EXPECT_EQ(CsWaitForDispatch(handle, 200, countMessages), 2) << "All queued messages are drained";
+	EXPECT_EQ(received, 2);
+
+	std::thread waker([handle]() {
+		std::this_thread::sleep_for(20ms);
+		CsWakeDispatch(handle);
+	});
+	start = Clock::now();
+	EXPECT_EQ(CsWaitForDispatch(handle, 5000, countMessages), 0);
+	EXPECT_LT(Clock::now() - start, 1s);
+	waker.join();
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestDisconnectWhileInUse)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnectWithEvent("DispatchTests", handle));
+
+	standin::failNext(E_FAIL);
+	EXPECT_FALSE(CsDisconnect(handle));
+	EXPECT_TRUE(CsWakeDispatch(handle)) << "The connection stays registered if it could not be closed";
+
+	// Other threads keep using the handle while it is disconnected, which must not touch freed state.
+	std::atomic<bool> stop{ false };
+	std::vector<std::thread> users;
+	for (int i = 0; i < 4; i++) {
+		users.emplace_back([handle, &stop]() {
+			while (!stop.load()) {
+				CsWakeDispatch(handle);
+				CsWaitForDispatch(handle, 0, countMessages);
+				uint64_t allocations, copies, reserved;
+				CsGetDispatchBatchStatistics(handle, &allocations, &copies, &reserved);
+			}
+		});
+	}
+	std::this_thread::sleep_for(20ms);
+	EXPECT_TRUE(CsDisconnect(handle));
+	EXPECT_FALSE(CsWakeDispatch(handle));
+	stop = true;
+	for (auto& user : users) {
+		user.join();
+	}
+	standin::reset();
+}
+
+TEST(DispatchTests, TestWakeupLatency)
+{
+	constexpr size_t ROUNDS{ 200 };
+
+	standin::reset();
+	received = 0;
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnectWithEvent("DispatchTests", handle));
+
+	std::vector<Clock::duration> latencies;
+	std::atomic<bool> done{ false };
+	std::atomic<Clock::rep> pushed{ 0 };
+	std::thread receiver([&]() {
+		while (!done) {
+			if (CsWaitForDispatch(handle, 100, countMessages) > 0) {
+				latencies.push_back(Clock::now() - Clock::time_point(Clock::duration(pushed.load())));
+			}
+		}
+	});
+	for (size_t i = 0; i < ROUNDS; i++) {
+		std::this_thread::sleep_for(1ms);
+		pushed = Clock::now().time_since_epoch().count();
+		standin::pushEvent(handle, 1, 2, uint32_t(i));
+		while (received <= i) {
+			std::this_thread::yield();
+		}
+	}
+	done = true;
+	receiver.join();
+
+	ASSERT_EQ(latencies.size(), ROUNDS);
+	std::sort(latencies.begin(), latencies.end());
+	auto p50{ std::chrono::duration_cast<std::chrono::microseconds>(latencies[ROUNDS / 2]) };
+	auto p99{ std::chrono::duration_cast<std::chrono::microseconds>(latencies[ROUNDS * 99 / 100]) };
+	std::cerr << std::format("wakeup: p50 {} us, p99 {} us\n", p50.count(), p99.count());
+	EXPECT_LT(p50, 1ms);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+struct Strategy {
+	const char* name;
+	uint32_t spinMicros;
+	uint32_t yieldMicros;
+};
+
+/*
+ * Let the stand-in produce messages at a fixed rate for a dispatch thread using the given strategy, and return the
+ * sorted latencies from push to callback.
+ */
+static std::vector<Clock::duration> measureDispatch(const Strategy& strategy, uint32_t rateHz, size_t count)
+{
+	static std::vector<Clock::time_point> pushedAt, dispatchedAt;
+	pushedAt.assign(count, Clock::time_point{});
+	dispatchedAt.assign(count, Clock::time_point{});
+	received = 0;
+
+	standin::reset();
+	HANDLE handle;
+	EXPECT_TRUE(CsConnectWithEvent("DispatchTests", handle));
+	EXPECT_TRUE(CsSetDispatchWaitStrategy(handle, strategy.spinMicros, strategy.yieldMicros));
+	EXPECT_TRUE(CsStartDispatchThread(handle, [](SIMCONNECT_RECV* pData, DWORD, void*) {
+		auto index{ static_cast<SIMCONNECT_RECV_EVENT*>(pData)->dwData };
+		if (index < dispatchedAt.size()) {
+			dispatchedAt[index] = Clock::now();
+		}
+		received++;
+	}));
+
+	const auto period{ std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rateHz)) };
+	auto next{ Clock::now() + 10ms };
+	for (size_t i = 0; i < count; i++, next += period) {
+		while (Clock::now() < next) {
+			// Busy-wait, as sleeps are far too coarse for the higher rates.
+		}
+		pushedAt[i] = Clock::now();
+		standin::pushEvent(handle, 1, 2, uint32_t(i));
+	}
+	auto deadline{ Clock::now() + 5s };
+	while ((received < count) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_TRUE(CsStopDispatchThread(handle));
+	EXPECT_TRUE(CsDisconnect(handle));
+	EXPECT_EQ(received, count);
+
+	std::vector<Clock::duration> latencies;
+	for (size_t i = 0; i < count; i++) {
+		latencies.push_back(dispatchedAt[i] - pushedAt[i]);
+	}
+	std::sort(latencies.begin(), latencies.end());
+	return latencies;
+}
+
+TEST(DispatchTests, TestDispatchLatencyPercentiles)
+{
+	constexpr size_t COUNT{ 1000 };
+
+	for (uint32_t rateHz : { 1000u, 10000u }) {
+		for (const Strategy& strategy : { Strategy{ "block", 0, 0 }, Strategy{ "yield 200us", 0, 200 }, Strategy{ "spin 200us", 200, 0 } }) {
+			auto latencies{ measureDispatch(strategy, rateHz, COUNT) };
+			auto micros = [&latencies](size_t permille) {
+				return std::chrono::duration_cast<std::chrono::microseconds>(latencies[latencies.size() * permille / 1000]).count();
+			};
+			std::cerr << std::format("{:>6} Hz {:>12}: p50 {} us, p99 {} us, p99.9 {} us\n", rateHz, strategy.name, micros(500), micros(990), micros(999));
+		}
+	}
+	standin::reset();
+}
+
+TEST(DispatchTests, TestDispatchBatchIsAllocationFree)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+
+	constexpr uint32_t BATCH{ 64 };
+	SIMCONNECT_RECV* messages[BATCH];
+	DWORD sizes[BATCH];
+	auto round = [&]() {
+		for (uint32_t i = 0; i < BATCH + 10; i++) {
+			standin::pushEvent(handle, 1, 2, i);
+		}
+		int64_t count{ 0 };
+		while (standin::pending(handle) > 0) {
+			count += CsGetDispatchBatch(handle, BATCH, messages, sizes);
+			EXPECT_EQ(messages[0]->dwID, SIMCONNECT_RECV_ID_EVENT);
+			CsReleaseDispatchBatch(handle);
+		}
+		count += CsGetDispatchBatch(handle, BATCH, messages, sizes);
+		CsReleaseDispatchBatch(handle);
+		return count;
+	};
+	EXPECT_EQ(round(), BATCH + 10);
+
+	uint64_t warmAllocations, warmCopies;
+	ASSERT_TRUE(CsGetDispatchBatchStatistics(handle, &warmAllocations, &warmCopies, nullptr));
+	EXPECT_GT(warmAllocations, 0);
+	for (int i = 0; i < 100; i++) {
+		EXPECT_EQ(round(), BATCH + 10);
+	}
+	uint64_t allocations, copies;
+	ASSERT_TRUE(CsGetDispatchBatchStatistics(handle, &allocations, &copies, nullptr));
+	EXPECT_EQ(allocations, warmAllocations) << "Recycled blocks are reused";
+	EXPECT_EQ(copies, warmCopies + 100 * (BATCH + 10));
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestRateControlFollowsConsumer)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_FALSE(CsEnableRateControl(handle, 70, 1, 8, 10, 1, 0.5, 0.1, 100)) << "There is no request to control yet";
+	EXPECT_GT(CsRequestDataOnSimObject(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, 0, 0, 0, 0), 1);
+	standin::enableCallLog(true);
+	ASSERT_TRUE(CsEnableRateControl(handle, 70, 1, 8, 10, 1, 0.5, 0.1, 100));
+	EXPECT_EQ(standin::takeCallLog(), std::vector<std::string>{ "RequestDataOnSimObject 70 7 0 3 0 0 1 0" }) << "The interval is moved into its bounds";
+
+	// A consumer that needs all the time it gets backs off
+	const double altitude{ 1000.0 };
+	auto deadline{ Clock::now() + 200ms };
+	while (Clock::now() < deadline) {
+		standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		CsGetNextDispatch(handle, [](SIMCONNECT_RECV*, DWORD, void*) { std::this_thread::sleep_for(1ms); });
+	}
+	int64_t times[8];
+	uint32_t intervals[8];
+	const int64_t changes{ CsGetRateHistory(handle, 70, 8, times, intervals) };
+	ASSERT_GE(changes, 4);
+	EXPECT_EQ(intervals[changes - 1], 8);
+	EXPECT_EQ(standin::takeCallLog().back(), "RequestDataOnSimObject 70 7 0 3 0 0 8 0");
+
+	// An idle consumer speeds up again
+	deadline = Clock::now() + 200ms;
+	while (Clock::now() < deadline) {
+		standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		CsGetNextDispatch(handle, [](SIMCONNECT_RECV*, DWORD, void*) {});
+		std::this_thread::sleep_for(1ms);
+	}
+	EXPECT_EQ(intervals[CsGetRateHistory(handle, 70, 8, times, intervals) - 1], 1);
+	standin::enableCallLog(false);
+
+	EXPECT_TRUE(CsDisableRateControl(handle, 70));
+	EXPECT_FALSE(CsReportConsumerLag(handle, 70, 10));
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestRateControlWithSharingAndFrames)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_GT(CsAddToDataDefinition(handle, 8, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	ASSERT_TRUE(CsSetRequestSharing(handle, 1));
+	for (uint32_t requestId = 70; requestId < 73; requestId++) {
+		EXPECT_GT(CsRequestDataOnSimObject(handle, requestId, (requestId == 71) ? 8 : 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, 0, 0, 0, 0), 0);
+	}
+
+	// Only the carrier of a shared request can be controlled, and it leaves the others at their interval
+	standin::enableCallLog(true);
+	EXPECT_FALSE(CsEnableRateControl(handle, 71, 1, 8, 10, 1, 0.5, 0.1, 100)) << "Request 71 only receives copies";
+	ASSERT_TRUE(CsEnableRateControl(handle, 70, 1, 8, 10, 1, 0.5, 0.1, 100));
+	EXPECT_EQ(standin::takeCallLog(), (std::vector<std::string>{ "RequestDataOnSimObject 71 8 0 3 0 0 0 0", "RequestDataOnSimObject 70 7 0 3 0 0 1 0" }));
+	uint32_t sharedRequests;
+	uint32_t subscribers;
+	ASSERT_TRUE(CsGetRequestSharingStatistics(handle, &sharedRequests, &subscribers));
+	EXPECT_EQ(sharedRequests, 1);
+	EXPECT_EQ(subscribers, 2);
+
+	// Another thread holds on to SimConnect while rows of the controlled request arrive in frames
+	ASSERT_TRUE(CsEnableFrameAggregation(handle, 99, 0));
+	static std::atomic<bool> holding;
+	holding = false;
+	standin::setCallHook([](const standin::Call& call) {
+		if (std::string(call.api) == "TransmitClientEvent") {
+			holding = true;
+			std::this_thread::sleep_for(500ms);
+			holding = false;
+		}
+	});
+	std::thread sender([handle]() { CsTransmitClientEvent(handle, SIMCONNECT_OBJECT_ID_USER, 1, 0, 1, 0); });
+	while (!holding) {
+		std::this_thread::yield();
+	}
+	standin::takeCallLog();
+
+	static std::atomic<uint32_t> rows;
+	rows = 0;
+	auto countRows = [](SIMCONNECT_RECV* msg, DWORD, void*) {
+		if (msg->dwID == CS_RECV_ID_FRAME) {
+			rows += reinterpret_cast<const CsFrameHeader*>(msg)->count;
+		}
+	};
+	const double altitude{ 1000.0 };
+	auto slowest{ Clock::duration::zero() };
+	const auto deadline{ Clock::now() + 150ms };
+	while (Clock::now() < deadline) {
+		CsReportConsumerLag(handle, 70, 1000);
+		standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		standin::pushFrame(handle, 99, 30.0f);
+		for (int i = 0; i < 2; i++) {
+			const auto start{ Clock::now() };
+			CsGetNextDispatch(handle, countRows);
+			slowest = std::max(slowest, Clock::now() - start);
+		}
+		std::this_thread::sleep_for(2ms);
+	}
+	EXPECT_TRUE(holding) << "The test must finish its rows while SimConnect is in use";
+	EXPECT_LT(slowest, 100ms) << "Dispatching never waits for SimConnect";
+	EXPECT_GT(rows, 0);
+
+	int64_t times[8];
+	uint32_t intervals[8];
+	const int64_t changes{ CsGetRateHistory(handle, 70, 8, times, intervals) };
+	ASSERT_GE(changes, 4);
+	EXPECT_EQ(intervals[changes - 1], 8) << "The reported lag counts for rows held for their frame";
+	EXPECT_TRUE(standin::takeCallLog().empty()) << "The new interval is only posted";
+
+	// The thread holding SimConnect sends the latest interval when its own request is done
+	sender.join();
+	standin::setCallHook(nullptr);
+	EXPECT_EQ(standin::takeCallLog(), std::vector<std::string>{ "RequestDataOnSimObject 70 7 0 3 0 0 8 0" });
+
+	// A controlled request does not join the shared one again
+	EXPECT_GT(CsRequestDataOnSimObject(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, 0, 0, 8, 0), 1);
+	EXPECT_EQ(standin::takeCallLog(), std::vector<std::string>{ "RequestDataOnSimObject 70 7 0 3 0 0 8 0" });
+	ASSERT_TRUE(CsGetRequestSharingStatistics(handle, &sharedRequests, &subscribers));
+	EXPECT_EQ(subscribers, 2);
+	standin::enableCallLog(false);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestArrivalStatistics)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_GT(CsRequestDataOnSimObject(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0), 1);
+	ASSERT_TRUE(CsEnableArrivalMonitor(handle, 0));
+	EXPECT_GT(CsRequestClientData(handle, 3, 80, 8, SIMCONNECT_CLIENT_DATA_PERIOD_ON_SET, 0, 0, 0, 0), 1);
+
+	const double altitude{ 1000.0 };
+	for (int i = 0; i < 3; i++) {
+		standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		standin::pushClientData(handle, 80, 8, &altitude, sizeof(altitude));
+	}
+	while (CsGetNextDispatch(handle, countMessages)) {
+	}
+
+	CsArrivalStatistics stats[4];
+	ASSERT_EQ(CsGetArrivalStatistics(handle, stats, 4), 2);
+	for (const auto& s : stats) {
+		if ((s.kind == CS_ARRIVAL_SIMOBJECT_DATA) && (s.requestId == 70)) {
+			EXPECT_EQ(s.count, 3);
+			EXPECT_EQ(s.periodMicros, 1000000) << "Taken from the request made before monitoring started";
+			EXPECT_GT(s.lastArrivalMicros, 0);
+		}
+		else if ((s.kind == CS_ARRIVAL_CLIENT_DATA) && (s.requestId == 80)) {
+			EXPECT_EQ(s.count, 3);
+			EXPECT_EQ(s.periodMicros, 0);
+		}
+		else if (&s < stats + 2) {
+			ADD_FAILURE() << "Unexpected request " << s.requestId;
+		}
+	}
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestFrameAggregation)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+	ASSERT_TRUE(CsEnableFrameAggregation(handle, 99, 0));
+
+	const double altitude{ 1000.0 };
+	auto frame = [handle, &altitude]() {
+		for (uint32_t requestId = 70; requestId < 76; requestId++) {
+			standin::pushSimObjectData(handle, requestId, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		}
+		standin::pushEvent(handle, 1, 2, 3);
+		standin::pushFrame(handle, 99, 30.0f);
+	};
+	frame();
+	frame();
+
+	static std::vector<std::vector<uint8_t>> messages;
+	messages.clear();
+	while (CsGetNextDispatch(handle, [](SIMCONNECT_RECV* msg, DWORD size, void*) {
+		messages.emplace_back(reinterpret_cast<uint8_t*>(msg), reinterpret_cast<uint8_t*>(msg) + size);
+	})) {
+	}
+	ASSERT_EQ(messages.size(), 4) << "Per frame one event and one record, instead of six data messages and the frame event";
+	EXPECT_EQ(reinterpret_cast<SIMCONNECT_RECV*>(messages[0].data())->dwID, SIMCONNECT_RECV_ID_EVENT);
+	for (uint32_t frameNumber = 0; frameNumber < 2; frameNumber++) {
+		auto header{ reinterpret_cast<const CsFrameHeader*>(messages[2 * frameNumber + 1].data()) };
+		ASSERT_EQ(header->dwID, CS_RECV_ID_FRAME);
+		EXPECT_EQ(header->frameNumber, frameNumber);
+		EXPECT_EQ(header->frameRate, 30.0f);
+		ASSERT_EQ(header->count, 6);
+		auto entries{ reinterpret_cast<const CsFrameEntry*>(header + 1) };
+		for (uint32_t i = 0; i < 6; i++) {
+			EXPECT_EQ(entries[i].requestId, 70 + i);
+			auto data{ reinterpret_cast<const SIMCONNECT_RECV_SIMOBJECT_DATA*>(messages[2 * frameNumber + 1].data() + entries[i].offset) };
+			EXPECT_EQ(data->dwRequestID, 70 + i);
+			EXPECT_EQ(*reinterpret_cast<const double*>(&data->dwData), altitude);
+		}
+	}
+
+	standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+	EXPECT_TRUE(CsGetNextDispatch(handle, countMessages));
+	EXPECT_TRUE(CsDisableFrameAggregation(handle));
+	standin::pushFrame(handle, 99, 30.0f);
+	received = 0;
+	EXPECT_TRUE(CsGetNextDispatch(handle, countMessages));
+	EXPECT_EQ(received, 1) << "Without aggregation the frame event is passed on as usual";
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(DispatchTests, TestRecording)
+{
+	standin::reset();
+	const std::string path{ (std::filesystem::temp_directory_path() / "DispatchTestsRecording.cstr").string() };
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("DispatchTests", handle));
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	EXPECT_FALSE(CsRecordRequest(handle, 70, 7)) << "No recorder yet";
+	ASSERT_TRUE(CsStartRecorder(handle, path.c_str()));
+	ASSERT_TRUE(CsRecordRequest(handle, 70, 7));
+
+	const int64_t start{ CsGetHistoryClock() };
+	for (int i = 0; i < 10; i++) {
+		const double altitude{ 1000.0 + i };
+		standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+		standin::pushSimObjectData(handle, 71, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+	}
+	while (CsGetNextDispatch(handle, countMessages)) {
+	}
+	EXPECT_TRUE(CsStopRecorder(handle));
+	uint64_t rows;
+	uint64_t dropped;
+	uint64_t bytes;
+	EXPECT_FALSE(CsGetRecorderStatistics(handle, &rows, &dropped, &bytes)) << "The recorder is gone";
+	EXPECT_TRUE(CsDisconnect(handle));
+
+	HANDLE recording;
+	ASSERT_TRUE(CsOpenRecording(path.c_str(), recording));
+	uint32_t requestIds[2]{};
+	ASSERT_EQ(CsGetRecordingStreams(recording, requestIds, 2), 1);
+	EXPECT_EQ(requestIds[0], 70);
+	uint32_t datumTypes[2]{};
+	uint32_t sizes[2]{};
+	ASSERT_EQ(CsGetRecordingLayout(recording, 70, datumTypes, sizes, 2), 1);
+	EXPECT_EQ(datumTypes[0], SIMCONNECT_DATATYPE_FLOAT64);
+	EXPECT_EQ(sizes[0], sizeof(double));
+
+	int64_t times[16];
+	uint32_t objectIds[16];
+	double altitudes[16];
+	void* const columns[]{ altitudes };
+	ASSERT_EQ(CsReadRecording(recording, 70, start, INT64_MAX, 16, times, objectIds, columns), 10);
+	for (int i = 0; i < 10; i++) {
+		EXPECT_EQ(altitudes[i], 1000.0 + i);
+		EXPECT_EQ(objectIds[i], SIMCONNECT_OBJECT_ID_USER);
+	}
+	EXPECT_LT(CsReadRecording(recording, 71, 0, INT64_MAX, 16, times, objectIds, columns), 0);
+	EXPECT_TRUE(CsCloseRecording(recording));
+	EXPECT_FALSE(CsCloseRecording(recording));
+
+	std::filesystem::remove(path);
+	standin::reset();
+}
@@ -0,0 +1,138 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "EventCoalescer.h"
+
+using namespace nl::rakis::interop;
+
+TEST(EventCoalescerTests, TestLatestValueWins)
+{
+	EventCoalescer coalescer;
+	std::vector<CoalescedEvent> sent;
+	auto send = [&sent](const CoalescedEvent& event) { sent.push_back(event); };
+
+	EXPECT_FALSE(coalescer.offer(0, 1, 100, 2, 0)) << "Events are not coalesced by default";
+
+	ASSERT_TRUE(coalescer.enable(1, true));
+	EXPECT_TRUE(coalescer.isActive());
+	for (uint32_t i = 0; i < 1000; i++) {
+		EXPECT_TRUE(coalescer.offer(0, 1, i, 2, 0));
+	}
+	EXPECT_EQ(coalescer.flush(send), 1);
+	ASSERT_EQ(sent.size(), 1);
+	EXPECT_EQ(sent[0].eventId, 1);
+	EXPECT_EQ(sent[0].data, 999);
+	EXPECT_EQ(sent[0].groupId, 2);
+
+	EXPECT_EQ(coalescer.flush(send), 0) << "Values are only sent once";
+
+	ASSERT_TRUE(coalescer.enable(1, false));
+	EXPECT_FALSE(coalescer.isActive());
+	EXPECT_FALSE(coalescer.offer(0, 1, 100, 2, 0));
+}
+
+TEST(EventCoalescerTests, TestConcurrentProducers)
+{
+	EventCoalescer coalescer;
+	for (uint32_t eventId = 0; eventId < 4; eventId++) {
+		ASSERT_TRUE(coalescer.enable(eventId, true));
+	}
+
+	std::vector<std::thread> producers;
+	for (uint32_t eventId = 0; eventId < 4; eventId++) {
+		producers.emplace_back([&coalescer, eventId]() {
+			for (uint32_t i = 1; i <= 100000; i++) {
+				coalescer.offer(0, eventId, i, 0, 0);
+			}
+		});
+	}
+	size_t flushed{ 0 };
+	std::vector<uint32_t> last(4, 0);
+	auto send = [&last](const CoalescedEvent& event) {
+		EXPECT_GT(event.data, last[event.eventId]);
+		last[event.eventId] = event.data;
+	};
+	for (auto& producer : producers) {
+		flushed += coalescer.flush(send);
+		producer.join();
+	}
+	flushed += coalescer.flush(send);
+
+	EXPECT_LE(flushed, 400000);
+	for (uint32_t eventId = 0; eventId < 4; eventId++) {
+		EXPECT_EQ(last[eventId], 100000);
+	}
+}
+
+TEST(EventCoalescerTests, TestValuesPerObject)
+{
+	EventCoalescer coalescer;
+	std::vector<CoalescedEvent> sent;
+	auto send = [&sent](const CoalescedEvent& event) { sent.push_back(event); };
+
+	ASSERT_TRUE(coalescer.enable(1, true));
+	EXPECT_TRUE(coalescer.offer(10, 1, 100, 2, 0));
+	EXPECT_TRUE(coalescer.offer(11, 1, 200, 3, 0));
+	EXPECT_TRUE(coalescer.offer(10, 1, 101, 2, 0));
+
+	EXPECT_EQ(coalescer.flush(send), 2) << "Each object keeps its own value";
+	std::sort(sent.begin(), sent.end(), [](const auto& a, const auto& b) { return a.objectId < b.objectId; });
+	ASSERT_EQ(sent.size(), 2);
+	EXPECT_EQ(sent[0].objectId, 10);
+	EXPECT_EQ(sent[0].data, 101);
+	EXPECT_EQ(sent[0].groupId, 2);
+	EXPECT_EQ(sent[1].objectId, 11);
+	EXPECT_EQ(sent[1].data, 200);
+	EXPECT_EQ(sent[1].groupId, 3);
+}
+
+TEST(EventCoalescerTests, TestFieldsStayTogether)
+{
+	EventCoalescer coalescer;
+	ASSERT_TRUE(coalescer.enable(1, true));
+
+	std::atomic<bool> done{ false };
+	std::vector<std::thread> producers;
+	for (uint32_t p = 0; p < 2; p++) {
+		producers.emplace_back([&coalescer, &done]() {
+			for (uint32_t i = 1; !done.load(); i++) {
+				coalescer.offer(0, 1, i, i, i);
+			}
+		});
+	}
+	size_t mixed{ 0 };
+	auto send = [&mixed](const CoalescedEvent& event) {
+		if ((event.groupId != event.data) || (event.flags != event.data)) {
+			mixed++;
+		}
+	};
+	for (int i = 0; i < 10000; i++) {
+		coalescer.flush(send);
+	}
+	done = true;
+	for (auto& producer : producers) {
+		producer.join();
+	}
+	EXPECT_EQ(mixed, 0) << "Flushed fields all come from the same offer";
+}
@@ -0,0 +1,68 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "EventNames.h"
+
+using namespace nl::rakis::interop;
+
+TEST(EventNamesTests, TestClaimEvent)
+{
+	EventNames names;
+
+	auto first{ names.claimEvent("AXIS_ELEVATOR_SET", 10) };
+	ASSERT_TRUE(first);
+	EXPECT_EQ(first->first, 10);
+	EXPECT_TRUE(first->second) << "New names are reserved for the caller to register";
+
+	auto again{ names.claimEvent("axis_elevator_set", 20) };
+	ASSERT_TRUE(again);
+	EXPECT_EQ(again->first, 10) << "Names are case-insensitive and keep their id";
+	EXPECT_FALSE(again->second);
+
+	EXPECT_FALSE(names.claimEvent("AXIS_AILERONS_SET", 10)) << "The proposed id is taken";
+
+	names.releaseEvent("AXIS_ELEVATOR_SET");
+	EXPECT_FALSE(names.findEvent("AXIS_ELEVATOR_SET"));
+	EXPECT_TRUE(names.claimEvent("AXIS_AILERONS_SET", 10)->second) << "Released ids can be reused";
+}
+
+TEST(EventNamesTests, TestAddEvent)
+{
+	EventNames names;
+
+	names.addEvent("PAUSE_ON", 1);
+	EXPECT_EQ(names.findEvent("pause_on"), 1u);
+
+	names.addEvent("PAUSE_OFF", 1);
+	EXPECT_FALSE(names.findEvent("PAUSE_ON")) << "Remapping an id replaces its old name";
+	EXPECT_EQ(names.findEvent("PAUSE_OFF"), 1u);
+}
+
+TEST(EventNamesTests, TestClaimInput)
+{
+	EventNames names;
+
+	auto [first, claimed] = names.claimInput(1, "shift+a", { 5, 6 });
+	EXPECT_TRUE(claimed);
+	auto [again, claimedAgain] = names.claimInput(1, "SHIFT+A", { 7, 8 });
+	EXPECT_FALSE(claimedAgain);
+	EXPECT_EQ(again.downEventId, 5);
+	EXPECT_EQ(again.upEventId, 6);
+	EXPECT_TRUE(names.claimInput(2, "shift+a", { 7, 8 }).second) << "Input definitions are per group";
+}
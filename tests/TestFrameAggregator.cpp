@@ -0,0 +1,93 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "FrameAggregator.h"
+
+using namespace nl::rakis::interop;
+
+static std::vector<uint8_t> dataMessage(SIMCONNECT_RECV_ID id, uint32_t requestId, size_t dataSize)
+{
+	const size_t header{ sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD) };
+	std::vector<uint8_t> buf(header + dataSize, 0xAB);
+	auto msg{ reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(buf.data()) };
+	msg->dwSize = DWORD(buf.size());
+	msg->dwVersion = 0;
+	msg->dwID = id;
+	msg->dwRequestID = requestId;
+	return buf;
+}
+
+TEST(FrameAggregatorTests, TestRecordLayout)
+{
+	FrameAggregator frames;
+	frames.enable(5, FrameAggregator::DEFAULT_MAX_SIZE);
+	EXPECT_TRUE(frames.isEnabled());
+	EXPECT_EQ(frames.frameEventId(), 5);
+
+	auto first{ dataMessage(SIMCONNECT_RECV_ID_SIMOBJECT_DATA, 10, 8) };
+	auto second{ dataMessage(SIMCONNECT_RECV_ID_CLIENT_DATA, 20, 13) };
+	EXPECT_TRUE(FrameAggregator::isFrameData(reinterpret_cast<SIMCONNECT_RECV*>(first.data())));
+	ASSERT_TRUE(frames.add(reinterpret_cast<SIMCONNECT_RECV*>(first.data()), DWORD(first.size())));
+	ASSERT_TRUE(frames.add(reinterpret_cast<SIMCONNECT_RECV*>(second.data()), DWORD(second.size())));
+
+	DWORD size;
+	auto record{ frames.close(60.0f, 1.0f, 0, size) };
+	auto header{ reinterpret_cast<const FrameHeader*>(record) };
+	EXPECT_EQ(header->dwID, FrameAggregator::RECV_ID_FRAME);
+	EXPECT_EQ(header->dwSize, size);
+	EXPECT_EQ(header->frameNumber, 0);
+	EXPECT_EQ(header->frameRate, 60.0f);
+	ASSERT_EQ(header->count, 2);
+
+	auto entries{ reinterpret_cast<const FrameEntry*>(header + 1) };
+	const auto base{ reinterpret_cast<const uint8_t*>(record) };
+	EXPECT_EQ(entries[0].requestId, 10);
+	EXPECT_EQ(entries[1].id, SIMCONNECT_RECV_ID_CLIENT_DATA);
+	EXPECT_EQ(entries[1].requestId, 20);
+	for (size_t i = 0; i < 2; i++) {
+		EXPECT_EQ(entries[i].offset % 8, 0) << "Messages are aligned";
+		EXPECT_LE(entries[i].offset + entries[i].size, size);
+	}
+	EXPECT_EQ(std::vector<uint8_t>(base + entries[0].offset, base + entries[0].offset + entries[0].size), first);
+	EXPECT_EQ(std::vector<uint8_t>(base + entries[1].offset, base + entries[1].offset + entries[1].size), second);
+
+	record = frames.close(60.0f, 1.0f, 0, size);
+	header = reinterpret_cast<const FrameHeader*>(record);
+	EXPECT_EQ(header->frameNumber, 1);
+	EXPECT_EQ(header->count, 0) << "A frame without data still closes";
+	EXPECT_EQ(size, sizeof(FrameHeader));
+}
+
+TEST(FrameAggregatorTests, TestSizeLimit)
+{
+	FrameAggregator frames;
+	frames.enable(5, 256);
+
+	auto big{ dataMessage(SIMCONNECT_RECV_ID_SIMOBJECT_DATA, 10, 400) };
+	EXPECT_TRUE(frames.add(reinterpret_cast<SIMCONNECT_RECV*>(big.data()), DWORD(big.size()))) << "An empty frame takes any message";
+	auto small{ dataMessage(SIMCONNECT_RECV_ID_SIMOBJECT_DATA, 11, 8) };
+	EXPECT_FALSE(frames.add(reinterpret_cast<SIMCONNECT_RECV*>(small.data()), DWORD(small.size())));
+
+	DWORD size;
+	frames.close(0.0f, 0.0f, FrameAggregator::FLAG_PARTIAL, size);
+	EXPECT_TRUE(frames.add(reinterpret_cast<SIMCONNECT_RECV*>(small.data()), DWORD(small.size())));
+	EXPECT_EQ(frames.disable(), 1);
+	EXPECT_FALSE(frames.isEnabled());
+}
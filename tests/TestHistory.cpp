@@ -0,0 +1,101 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+#include "History.h"
+
+using namespace nl::rakis::interop;
+
+#pragma pack(push, 1)
+struct Row {
+	double altitude;
+	int32_t onGround;
+	char title[8];
+};
+#pragma pack(pop)
+
+static std::shared_ptr<const DataSchema> rowSchema()
+{
+	auto schema{ std::make_shared<DataSchema>() };
+	schema->add("PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("SIM ON GROUND", "bool", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("ATC ID", nullptr, SIMCONNECT_DATATYPE_STRING8, 0.0f, SIMCONNECT_UNUSED);
+	return schema;
+}
+
+static void record(HistoryRing& ring, int64_t time, double altitude)
+{
+	Row row{ altitude, altitude == 0.0, "PH-BLA" };
+	ASSERT_TRUE(ring.record(time, &row, sizeof(row)));
+}
+
+TEST(HistoryTests, TestRingWraps)
+{
+	HistoryRing ring(rowSchema(), 4);
+
+	for (int64_t t = 1; t <= 6; t++) {
+		record(ring, t * 1000, double(t * 100));
+	}
+	EXPECT_EQ(ring.size(), 4) << "The two oldest rows were overwritten";
+	EXPECT_EQ(ring.columnCount(), 3);
+
+	int64_t times[8];
+	double altitude[8], onGround[8], title[8];
+	double* columns[]{ altitude, onGround, title };
+	ASSERT_EQ(ring.read(0, 100000, 8, times, columns), 4);
+	EXPECT_EQ(times[0], 3000);
+	EXPECT_EQ(altitude[0], 300.0);
+	EXPECT_EQ(times[3], 6000);
+	EXPECT_EQ(altitude[3], 600.0);
+	EXPECT_EQ(onGround[3], 0.0);
+	EXPECT_TRUE(std::isnan(title[0])) << "Strings are not numeric";
+
+	EXPECT_EQ(ring.read(4000, 5000, 8, times, columns), 2);
+	EXPECT_EQ(times[0], 4000);
+	EXPECT_EQ(ring.read(4500, 100000, 1, times, nullptr), 1) << "maxCount limits the copy";
+	EXPECT_EQ(times[0], 5000);
+
+	Row shortRow{};
+	EXPECT_FALSE(ring.record(7000, &shortRow, sizeof(double)));
+}
+
+TEST(HistoryTests, TestValueAt)
+{
+	HistoryRing ring(rowSchema(), 16);
+	record(ring, 1000, 100.0);
+	record(ring, 2000, 300.0);
+	record(ring, 4000, 0.0);
+
+	double value{ 0.0 };
+	EXPECT_TRUE(ring.valueAt(1500, 0, value));
+	EXPECT_DOUBLE_EQ(value, 200.0);
+	EXPECT_TRUE(ring.valueAt(2000, 0, value));
+	EXPECT_DOUBLE_EQ(value, 300.0);
+	EXPECT_TRUE(ring.valueAt(3000, 0, value));
+	EXPECT_DOUBLE_EQ(value, 150.0);
+	EXPECT_TRUE(ring.valueAt(3500, 1, value));
+	EXPECT_DOUBLE_EQ(value, 0.75);
+
+	EXPECT_FALSE(ring.valueAt(999, 0, value)) << "Before the first row";
+	EXPECT_FALSE(ring.valueAt(4001, 0, value)) << "After the last row";
+	EXPECT_FALSE(ring.valueAt(1500, 3, value)) << "No such datum";
+}
@@ -17,7 +17,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <format>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Log.h"
 
@@ -36,3 +42,121 @@ TEST(LogTests, TestLogging)
     const auto actual = 1;
     ASSERT_EQ(expected, actual) << "Do something silly\n";
 }
+
+TEST(LogTests, TestRingDumpedOnError)
+{
+    Logger log{ Logger::getLogger("test") };
+    log.setLevel(LOGLVL_WARN);
+
+    std::vector<std::string> lines;
+    auto& root{ Configurer::targets() };
+    auto saved{ root.logger_ };
+    root.logger_ = [&lines](LogLevel, const std::string& msg) { lines.push_back(msg); };
+
+    log.dumpRing();
+    lines.clear();
+    log.trace("looking up event AP_MASTER");
+    log.info("sending request 42");
+    EXPECT_TRUE(lines.empty()) << "Below the threshold nothing is written";
+
+    log.error("request 42 failed");
+    ASSERT_EQ(lines.size(), 3) << "The two records before the error, then the error itself";
+    EXPECT_NE(lines[0].find("looking up event AP_MASTER"), std::string::npos);
+    EXPECT_NE(lines[1].find("sending request 42"), std::string::npos);
+    EXPECT_EQ(lines[2], "request 42 failed");
+
+    lines.clear();
+    log.trace(std::string(1000, 'x'));
+    EXPECT_EQ(log.dumpRing(), 2) << "Only records since the last dump, including the error";
+    EXPECT_NE(lines[0].find("request 42 failed"), std::string::npos);
+    EXPECT_LT(lines[1].size(), LogRing::TEXT_SIZE + 100) << "Long messages are cut off";
+
+    LogRing::setEnabled(false);
+    log.trace("not kept");
+    EXPECT_EQ(log.dumpRing(), 0);
+    LogRing::setEnabled(true);
+
+    root.logger_ = saved;
+}
+
+/*
+ * Captures what reaches the root target, and puts the target and the limiter back however the test ends.
+ */
+struct LimiterFixture {
+    std::vector<std::string> lines;
+    Configurer::StringLogger saved;
+    LogLevel savedLevel;
+
+    LimiterFixture() : saved(Configurer::targets().logger_), savedLevel(Configurer::targets().level_) {
+        Configurer::targets().logger_ = [this](LogLevel, const std::string& msg) { lines.push_back(msg); };
+        Configurer::targets().level_ = LOGLVL_TRACE;
+    }
+    ~LimiterFixture() {
+        LogLimiter::setLimit(LogLimiter::DEFAULT_RATE, LogLimiter::DEFAULT_BURST);
+        Configurer::targets().logger_ = saved;
+        Configurer::targets().level_ = savedLevel;
+    }
+};
+
+TEST(LogTests, TestRateLimitPerCallSite)
+{
+    LimiterFixture fixture;
+    auto& lines{ fixture.lines };
+    Logger log{ Logger::getLogger("test") };
+    log.setLevel(LOGLVL_WARN);
+
+    LogLimiter::setLimit(20.0, 3);
+    auto storm = [&log](int i) { log.warn(std::format("Handle passed is null! ({})", i)); };
+    auto other = [&log]() { log.warn("another call site"); };
+    for (int i = 0; i < 10; i++) {
+        storm(i);
+    }
+    ASSERT_EQ(lines.size(), 3) << "Only the burst gets through";
+    other();
+    ASSERT_EQ(lines.size(), 4) << "Other call sites have their own bucket, and do not summarize yet";
+
+    lines.clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    storm(10);
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_NE(lines[0].find("Suppressed 7 similar messages from TestLogging.cpp:"), std::string::npos) << lines[0];
+    EXPECT_EQ(lines[1], "Handle passed is null! (10)");
+
+    // A site that stays quiet has its count written with a message from another site.
+    lines.clear();
+    for (int i = 11; i < 20; i++) {
+        storm(i);
+    }
+    ASSERT_TRUE(lines.empty());
+    std::this_thread::sleep_for(std::chrono::microseconds(LogLimiter::FLUSH_MICROS));
+    other();
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_NE(lines[0].find("Suppressed 9 similar messages from TestLogging.cpp:"), std::string::npos) << lines[0];
+    EXPECT_EQ(lines[1], "another call site");
+}
+
+TEST(LogTests, TestRateLimitLevels)
+{
+    LimiterFixture fixture;
+    auto& lines{ fixture.lines };
+    Logger log{ Logger::getLogger("test") };
+    log.setLevel(LOGLVL_TRACE);
+
+    LogLimiter::setLimit(0.001, 1);
+    for (int i = 0; i < 10; i++) {
+        log.trace(std::format("tracing {}", i));
+        log.debug(std::format("debugging {}", i));
+        log.info(std::format("informing {}", i));
+    }
+    EXPECT_EQ(lines.size(), 30) << "Messages below WARN are not limited";
+
+    lines.clear();
+    for (int i = 0; i < 10; i++) {
+        log.error(std::format("failing {}", i));
+    }
+    EXPECT_EQ(std::ranges::count_if(lines, [](const std::string& line) { return line.starts_with("failing"); }), 1);
+
+    EXPECT_TRUE(LogLimiter::pending());
+    LogLimiter::setLimit(0.001, 1);
+    EXPECT_FALSE(LogLimiter::pending()) << "A new limit forgets what was suppressed";
+}
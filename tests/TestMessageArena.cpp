@@ -0,0 +1,82 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+
+#include "MessageArena.h"
+
+using namespace nl::rakis::interop;
+
+
+TEST(MessageArenaTests, TestSizeClasses)
+{
+	MessageArena arena;
+
+	void* small{ arena.allocate(40) };
+	void* other{ arena.allocate(64) };
+	EXPECT_NE(small, other);
+	EXPECT_EQ(arena.statistics().slabs, 1) << "Both come from the 64 byte slab";
+
+	arena.allocate(100);
+	EXPECT_EQ(arena.statistics().slabs, 2) << "Every size class has its own slabs";
+
+	arena.recycle(small, 40);
+	EXPECT_EQ(arena.allocate(20), small) << "Recycled blocks are reused first";
+
+	void* huge{ arena.allocate(MessageArena::SLAB_SIZE + 1) };
+	EXPECT_EQ(arena.statistics().oversized, 1);
+	arena.recycle(huge, MessageArena::SLAB_SIZE + 1);
+	EXPECT_EQ(arena.statistics().allocations, 5);
+}
+
+TEST(MessageArenaTests, TestBatch)
+{
+	MessageBatch batch;
+	std::vector<std::pair<void*, uint32_t>> taken;
+	auto collect = [&taken](size_t, void* message, uint32_t size) { taken.emplace_back(message, size); };
+
+	for (uint32_t i = 0; i < 10; i++) {
+		batch.queue(&i, sizeof(i));
+	}
+	EXPECT_EQ(batch.take(4, collect), 4);
+	EXPECT_EQ(batch.queued(), 6);
+	EXPECT_EQ(batch.take(10, collect), 6);
+	ASSERT_EQ(taken.size(), 10);
+	for (uint32_t i = 0; i < 10; i++) {
+		uint32_t value;
+		std::memcpy(&value, taken[i].first, sizeof(value));
+		EXPECT_EQ(value, i) << "Messages are copied and handed out in order";
+	}
+	EXPECT_EQ(batch.release(), 10);
+
+	std::set<void*> before;
+	for (const auto& [message, size] : taken) {
+		before.insert(message);
+	}
+	taken.clear();
+	for (uint32_t i = 0; i < 10; i++) {
+		batch.queue(&i, sizeof(i));
+	}
+	batch.take(10, collect);
+	for (const auto& [message, size] : taken) {
+		EXPECT_TRUE(before.contains(message)) << "Released blocks are recycled";
+	}
+	EXPECT_EQ(batch.statistics().slabs, 1);
+}
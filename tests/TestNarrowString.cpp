@@ -0,0 +1,69 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "NarrowString.h"
+
+using namespace nl::rakis::interop;
+
+TEST(NarrowStringTests, TestAscii)
+{
+	NarrowString name{ L"PLANE ALTITUDE" };
+	EXPECT_STREQ(name, "PLANE ALTITUDE");
+
+	NarrowString empty{ L"" };
+	EXPECT_STREQ(empty, "");
+
+	NarrowString none{ nullptr };
+	EXPECT_EQ(none.c_str(), nullptr) << "A null string stays null, for optional arguments";
+}
+
+TEST(NarrowStringTests, TestLongString)
+{
+	std::wstring wide;
+	std::string expected;
+	for (int i = 0; i < 100; i++) {
+		wide += L"GENERAL ENG RPM:";
+		expected += "GENERAL ENG RPM:";
+	}
+	NarrowString name{ wide.c_str() };
+	EXPECT_EQ(std::string(name), expected);
+}
+
+TEST(NarrowStringTests, TestNonAscii)
+{
+	NarrowString name{ L"Caf\u00e9 Airport" };
+	ASSERT_NE(name.c_str(), nullptr);
+	EXPECT_EQ(std::strncmp(name, "Caf", 3), 0) << "The ASCII prefix is unchanged";
+	EXPECT_GT(std::strlen(name), 3);
+	EXPECT_NE(static_cast<unsigned char>(name.c_str()[3]), 0) << "The accented character is converted, not dropped";
+}
+
+TEST(NarrowStringTests, TestConvertReusesString)
+{
+	std::string out;
+	NarrowString::convert(L"AP_MASTER", out);
+	EXPECT_EQ(out, "AP_MASTER");
+	NarrowString::convert(L"GEAR", out);
+	EXPECT_EQ(out, "GEAR");
+	NarrowString::convert(nullptr, out);
+	EXPECT_TRUE(out.empty());
+}
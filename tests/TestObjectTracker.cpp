@@ -0,0 +1,105 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "ObjectTracker.h"
+
+using namespace nl::rakis::interop;
+
+struct Position {
+	double latitude;
+	double longitude;
+	double altitude;
+	double heading;
+};
+
+static DataSchema positionSchema()
+{
+	DataSchema schema;
+	schema.add("PLANE LATITUDE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema.add("PLANE LONGITUDE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema.add("PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema.add("PLANE HEADING DEGREES TRUE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	return schema;
+}
+
+static constexpr int64_t SECOND{ 1000000 };
+
+TEST(ObjectTrackerTests, TestInterpolateAndExtrapolate)
+{
+	ObjectTracker tracker(positionSchema(), { 0, 1, 2, 3 }, 2 * SECOND, 10 * SECOND);
+
+	Position first{ 52.0, 179.9, 1000.0, 350.0 };
+	Position second{ 52.1, -179.9, 2000.0, 10.0 };
+	ASSERT_TRUE(tracker.update(7, 0, &first, sizeof(first)));
+	ASSERT_TRUE(tracker.update(7, SECOND, &second, sizeof(second)));
+	EXPECT_FALSE(tracker.update(7, SECOND, &second, sizeof(second))) << "Time must move forward";
+
+	uint32_t ids[4];
+	double lat[4], lon[4], alt[4], hdg[4];
+	double* channels[]{ lat, lon, alt, hdg };
+
+	ASSERT_EQ(tracker.sample(SECOND / 2, 4, ids, channels), 1);
+	EXPECT_EQ(ids[0], 7);
+	EXPECT_NEAR(lat[0], 52.05, 1e-9);
+	EXPECT_NEAR(std::abs(lon[0]), 180.0, 1e-9) << "Longitude crosses the date line the short way";
+	EXPECT_NEAR(alt[0], 1500.0, 1e-9);
+	EXPECT_NEAR(hdg[0], 0.0, 1e-9) << "Heading turns through north the short way";
+
+	ASSERT_EQ(tracker.sample(2 * SECOND, 4, ids, channels), 1);
+	EXPECT_NEAR(alt[0], 3000.0, 1e-9);
+	EXPECT_NEAR(hdg[0], 30.0, 1e-9);
+	EXPECT_NEAR(lon[0], -179.7, 1e-9);
+
+	ASSERT_EQ(tracker.sample(10 * SECOND, 4, ids, channels), 1);
+	EXPECT_NEAR(alt[0], 4000.0, 1e-9) << "Extrapolation stops after two seconds";
+
+	ASSERT_EQ(tracker.sample(-SECOND, 4, ids, channels), 1);
+	EXPECT_NEAR(alt[0], 1000.0, 1e-9) << "Interpolation stops at the previous report";
+}
+
+TEST(ObjectTrackerTests, TestExpiry)
+{
+	ObjectTracker tracker(positionSchema(), { 0, 1, 2, 3 }, SECOND, 5 * SECOND);
+
+	Position position{ 52.0, 4.0, 0.0, 90.0 };
+	for (uint32_t id = 1; id <= 3; id++) {
+		ASSERT_TRUE(tracker.update(id, 0, &position, sizeof(position)));
+	}
+	ASSERT_TRUE(tracker.update(2, 4 * SECOND, &position, sizeof(position)));
+	EXPECT_EQ(tracker.sample(6 * SECOND, 4, nullptr, nullptr), 1) << "Objects not seen for 5 seconds are skipped";
+
+	ASSERT_TRUE(tracker.update(4, 6 * SECOND, &position, sizeof(position)));
+	EXPECT_EQ(tracker.size(), 2) << "and dropped on a later update";
+
+	uint32_t ids[4];
+	ASSERT_EQ(tracker.sample(6 * SECOND, 4, ids, nullptr), 2);
+	EXPECT_TRUE(((ids[0] == 2) && (ids[1] == 4)) || ((ids[0] == 4) && (ids[1] == 2)));
+}
+
+TEST(ObjectTrackerTests, TestTrackable)
+{
+	DataSchema schema{ positionSchema() };
+	EXPECT_TRUE(ObjectTracker::isTrackable(schema, { 0, 1, 2, 3 }));
+	EXPECT_FALSE(ObjectTracker::isTrackable(schema, { 0, 1, 2, 4 }));
+
+	schema.add("TITLE", nullptr, SIMCONNECT_DATATYPE_STRING256, 0.0f, SIMCONNECT_UNUSED);
+	EXPECT_FALSE(ObjectTracker::isTrackable(schema, { 0, 1, 2, 4 }));
+}
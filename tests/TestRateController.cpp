@@ -0,0 +1,117 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "RateController.h"
+
+using namespace nl::rakis::interop;
+
+// Windows of 1000us; behind above 50% load or a depth over 8, idle under 10% load and a depth of at most 2.
+static const RateLimits limits{ 1, 16, 1000, 2, 0.5, 0.1, 8 };
+
+/*
+ * Feed one window with ten messages that each took "busy" microseconds, returning the last verdict.
+ */
+static std::optional<uint32_t> window(RateController& controller, int64_t& now, int64_t busy)
+{
+	std::optional<uint32_t> result;
+	for (int i = 0; i < 10; i++) {
+		now += 100;
+		result = controller.record(now, busy);
+	}
+	return result;
+}
+
+TEST(RateControllerTests, TestBackOffWithHysteresis)
+{
+	int64_t now{ 0 };
+	RateController controller(limits, 0, now);
+	EXPECT_EQ(controller.interval(), 1) << "The initial interval is clamped to the bounds";
+
+	EXPECT_FALSE(window(controller, now, 80).has_value()) << "One window over the limit is not enough";
+	EXPECT_EQ(window(controller, now, 80), 2);
+	EXPECT_FALSE(window(controller, now, 80).has_value());
+	EXPECT_EQ(window(controller, now, 80), 4);
+
+	EXPECT_FALSE(window(controller, now, 30).has_value()) << "Between the thresholds nothing changes";
+	EXPECT_FALSE(window(controller, now, 80).has_value()) << "The run starts over";
+	EXPECT_FALSE(window(controller, now, 30).has_value());
+	EXPECT_EQ(controller.interval(), 4);
+
+	for (int i = 0; i < 20; i++) {
+		window(controller, now, 80);
+	}
+	EXPECT_EQ(controller.interval(), 16) << "The interval never exceeds the maximum";
+}
+
+TEST(RateControllerTests, TestSpeedUpWhenIdle)
+{
+	int64_t now{ 0 };
+	RateController controller(limits, 8, now);
+
+	EXPECT_FALSE(window(controller, now, 1).has_value());
+	EXPECT_EQ(window(controller, now, 1), 4);
+	for (int i = 0; i < 20; i++) {
+		window(controller, now, 1);
+	}
+	EXPECT_EQ(controller.interval(), 1) << "The interval never drops below the minimum";
+}
+
+TEST(RateControllerTests, TestReportedDepth)
+{
+	int64_t now{ 0 };
+	RateController controller(limits, 2, now);
+
+	for (int i = 0; i < 2; i++) {
+		controller.reportDepth(20);
+		window(controller, now, 1);
+	}
+	EXPECT_EQ(controller.interval(), 4) << "A deep consumer queue counts as being behind, however cheap the messages";
+
+	for (int i = 0; i < 2; i++) {
+		controller.reportDepth(5);
+		window(controller, now, 1);
+	}
+	EXPECT_EQ(controller.interval(), 4) << "A moderately filled queue is not idle";
+}
+
+TEST(RateControllerTests, TestHistory)
+{
+	int64_t now{ 0 };
+	RateController controller(limits, 1, now);
+	for (int i = 0; i < 4; i++) {
+		window(controller, now, 80);
+	}
+	std::vector<int64_t> times(8);
+	std::vector<uint32_t> intervals(8);
+	ASSERT_EQ(controller.history(8, times.data(), intervals.data()), 3);
+	EXPECT_EQ(intervals[0], 1);
+	EXPECT_EQ(intervals[1], 2);
+	EXPECT_EQ(intervals[2], 4);
+	EXPECT_EQ(times[0], 0);
+	EXPECT_LT(times[1], times[2]);
+
+	ASSERT_EQ(controller.history(1, times.data(), intervals.data()), 1);
+	EXPECT_EQ(intervals[0], 4) << "A short buffer gets the latest changes";
+
+	for (int i = 0; i < 2 * int(RateController::HISTORY); i++) {
+		window(controller, now, (i % 4 < 2) ? 80 : 1);
+	}
+	EXPECT_EQ(controller.history(1000, nullptr, nullptr), RateController::HISTORY);
+}
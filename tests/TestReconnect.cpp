@@ -0,0 +1,128 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+TEST(ReconnectTests, TestReplayOrder)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("ReconnectTests", handle));
+	CsMapClientEventToSimEvent(handle, 3, "AXIS_ELEVATOR_SET");
+	CsAddClientEventToNotificationGroup(handle, 1, 3, 0);
+	CsSetNotificationGroupPriority(handle, 1, SIMCONNECT_GROUP_PRIORITY_HIGHEST);
+	CsAddToDataDefinition(handle, 1, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	CsRequestDataOnSimObject(handle, 7, 1, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0);
+	CsMapClientEventToSimEvent(handle, 3, "AXIS_AILERONS_SET");
+	CsSubscribeToSystemEvent(handle, 9, "Frame");
+
+	standin::enableCallLog(true);
+	HANDLE old{ handle };
+	ASSERT_TRUE(CsReconnect(handle));
+	EXPECT_NE(handle, old);
+
+	const std::vector<std::string> expected{
+		"Close",
+		"Open ReconnectTests",
+		"MapClientEventToSimEvent 3 AXIS_AILERONS_SET",
+		"AddClientEventToNotificationGroup 1 3 0",
+		"SetNotificationGroupPriority 1 1",
+		"AddToDataDefinition 1 4 4294967295 PLANE ALTITUDE feet 0",
+		"RequestDataOnSimObject 7 1 0 4 0 0 0 0",
+		"SubscribeToSystemEvent 9 Frame",
+	};
+	EXPECT_EQ(standin::takeCallLog(), expected) << "A remapped event keeps its place ahead of the group using it";
+
+	standin::enableCallLog(false);
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(ReconnectTests, TestPruning)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("ReconnectTests", handle));
+	CsAddToDataDefinition(handle, 1, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	CsAddToDataDefinition(handle, 2, "PLANE LATITUDE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	CsClearDataDefinition(handle, 2);
+	CsRequestDataOnSimObject(handle, 7, 1, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0);
+	CsRequestDataOnSimObject(handle, 8, 1, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0);
+	CsRequestDataOnSimObject(handle, 8, 1, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_NEVER, 0, 0, 0, 0);
+	CsMapClientEventToSimEvent(handle, 3, "AXIS_ELEVATOR_SET");
+	CsMapClientEventToSimEvent(handle, 4, "AXIS_AILERONS_SET");
+	CsAddClientEventToNotificationGroup(handle, 1, 3, 0);
+	CsAddClientEventToNotificationGroup(handle, 1, 4, 0);
+	CsRemoveClientEvent(handle, 1, 4);
+	CsAddClientEventToNotificationGroup(handle, 2, 4, 0);
+	CsClearNotificationGroup(handle, 2);
+
+	standin::enableCallLog(true);
+	ASSERT_TRUE(CsReconnect(handle));
+
+	const std::vector<std::string> expected{
+		"Close",
+		"Open ReconnectTests",
+		"AddToDataDefinition 1 4 4294967295 PLANE ALTITUDE feet 0",
+		"RequestDataOnSimObject 7 1 0 4 0 0 0 0",
+		"MapClientEventToSimEvent 3 AXIS_ELEVATOR_SET",
+		"MapClientEventToSimEvent 4 AXIS_AILERONS_SET",
+		"AddClientEventToNotificationGroup 1 3 0",
+	};
+	EXPECT_EQ(standin::takeCallLog(), expected) << "Only what is still in effect is replayed";
+
+	standin::enableCallLog(false);
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(ReconnectTests, TestFailedReopen)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnectWithEvent("ReconnectTests", handle));
+	CsAddToDataDefinition(handle, 1, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+
+	// Let the close succeed, and the open after it fail.
+	standin::setCallHook([](const standin::Call& call) {
+		if (std::strcmp(call.api, "Close") == 0) {
+			standin::failNext(E_FAIL);
+		}
+	});
+	standin::enableCallLog(true);
+	HANDLE old{ handle };
+	EXPECT_FALSE(CsReconnect(handle));
+	standin::setCallHook(nullptr);
+
+	EXPECT_EQ(handle, nullptr) << "The caller no longer has a handle to the closed connection";
+	EXPECT_EQ(standin::takeCallLog(), std::vector<std::string>{ "Close" }) << "Nothing is replayed after the failed open";
+	EXPECT_FALSE(CsWakeDispatch(old)) << "The native state is gone with the connection";
+	EXPECT_FALSE(CsReconnect(old));
+
+	standin::enableCallLog(false);
+	standin::reset();
+}
@@ -0,0 +1,210 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "../src/Requests.h"
+#include "standin/StandInSimConnect.h"
+
+using nl::rakis::interop::Name;
+using nl::rakis::interop::Request;
+using nl::rakis::interop::RequestOp;
+
+static void expectSame(const Request& actual, const Request& expected)
+{
+	const auto& info{ expected.info() };
+
+	EXPECT_EQ(actual.op, expected.op);
+	for (size_t i = 0; i < info.argCount; i++) {
+		EXPECT_EQ(actual.args[i], expected.args[i]) << info.api << " argument " << i;
+	}
+	for (size_t i = 0; i < info.stringCount; i++) {
+		EXPECT_STREQ(actual.strings[i].c_str(), expected.strings[i].c_str()) << info.api << " string " << i;
+	}
+	ASSERT_EQ(actual.payload.size(), expected.payload.size()) << info.api;
+	EXPECT_EQ(std::memcmp(actual.payload.data(), expected.payload.data(), expected.payload.size()), 0) << info.api;
+}
+
+/*
+ * Write a record header for the given op, with the given record size.
+ */
+static void header(std::vector<uint8_t>& out, uint16_t op, uint16_t size)
+{
+	uint16_t h[2]{ op, size };
+	out.insert(out.end(), reinterpret_cast<const uint8_t*>(h), reinterpret_cast<const uint8_t*>(h) + sizeof(h));
+}
+
+TEST(RequestTests, TestRoundTrip)
+{
+	SIMCONNECT_DATA_INITPOSITION initPos{ 52.3, 4.8, 12.0, 0.0, 0.0, 270.0, 1, 0 };
+	double flightPlanPosition{ 0.25 };
+	const uint8_t data[]{ 1, 2, 3, 4, 5, 6, 7 };
+
+	const std::vector<Request> requests{
+		Request{ RequestOp::AddToDataDefinition, { 1, SIMCONNECT_DATATYPE_FLOAT64, Request::fromFloat(0.5f), 3 }, { "PLANE ALTITUDE", "feet" } },
+		Request{ RequestOp::AddToDataDefinition, { 1, SIMCONNECT_DATATYPE_STRING256, Request::fromFloat(0.0f), SIMCONNECT_UNUSED }, { "TITLE", nullptr } },
+		Request{ RequestOp::MapInputEventToClientEvent, { 2, 10, 1, 11, 0, 1 }, { "shift+a" } },
+		Request{ RequestOp::RequestDataOnSimObject, { 7, 1, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SECOND, 1, 2, 3, 4 } },
+		Request{ RequestOp::SetClientData, { 4, 5, 0, sizeof(data) }, {}, { data, sizeof(data) } },
+		Request{ RequestOp::AICreateEnrouteATCAircraft, { 123, 1, 9 }, { "Cessna 172", "PH-ABC", "C:\\plans\\EHAM-EHRD" }, { &flightPlanPosition, sizeof(flightPlanPosition) } },
+		Request{ RequestOp::AICreateSimulatedObject, { 10 }, { "Windsock" }, { &initPos, sizeof(initPos) } },
+		Request{ RequestOp::AIRemoveObject, { 42, 11 } },
+	};
+
+	std::vector<uint8_t> manifest;
+	for (const auto& request : requests) {
+		ASSERT_TRUE(request.encode(manifest)) << request.info().api;
+	}
+	std::vector<Request> decoded;
+	ASSERT_TRUE(Request::decodeAll(manifest.data(), manifest.size(), decoded));
+	std::memset(manifest.data(), 0xcc, manifest.size());		// Decoded requests own their names and data
+
+	ASSERT_EQ(decoded.size(), requests.size());
+	for (size_t i = 0; i < requests.size(); i++) {
+		expectSame(decoded[i], requests[i]);
+	}
+	EXPECT_FLOAT_EQ(Request::toFloat(decoded[0].args[2]), 0.5f);
+	EXPECT_TRUE(decoded[1].strings[1].empty()) << "A missing name is encoded as an empty string";
+}
+
+TEST(RequestTests, TestOversizedRecord)
+{
+	std::vector<uint8_t> data(UINT16_MAX, 0);
+	std::vector<uint8_t> manifest;
+	Request{ RequestOp::MapClientEventToSimEvent, { 1 }, { "AXIS_RUDDER_SET" } }.encode(manifest);
+	size_t size{ manifest.size() };
+
+	EXPECT_FALSE((Request{ RequestOp::SetClientData, { 4, 5, 0, UINT16_MAX }, {}, { data.data(), data.size() } }.encode(manifest)));
+	EXPECT_EQ(manifest.size(), size) << "A record that does not fit leaves the manifest as it was";
+}
+
+TEST(RequestTests, TestBorrowedNames)
+{
+	char name[]{ "AXIS_RUDDER_SET" };
+	Request request{ RequestOp::MapClientEventToSimEvent, { 1 }, { name } };
+	EXPECT_EQ(request.strings[0].c_str(), name) << "A request borrows the caller's name";
+
+	Request copy{ request };
+	EXPECT_NE(copy.strings[0].c_str(), name) << "A copy owns its name";
+	Request moved{ std::move(copy) };
+	name[0] = 'X';
+	EXPECT_STREQ(moved.strings[0].c_str(), "AXIS_RUDDER_SET") << "An owned name moves with the request";
+	EXPECT_STREQ(request.strings[0].c_str(), "XXIS_RUDDER_SET");
+
+	EXPECT_STREQ(Name(nullptr).c_str(), "");
+	EXPECT_TRUE(Name(nullptr).empty());
+}
+
+TEST(RequestTests, TestRejects)
+{
+	std::vector<uint8_t> valid;
+	Request{ RequestOp::MapClientEventToSimEvent, { 1 }, { "AXIS_RUDDER_SET" } }.encode(valid);
+	std::vector<Request> decoded;
+
+	// Truncated, in the header and in the record.
+	for (size_t size : { size_t(1), size_t(3), valid.size() - 1 }) {
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(valid.data(), size, decoded)) << "Truncated to " << size;
+		EXPECT_TRUE(decoded.empty());
+	}
+
+	// A record claiming more than there is, or less than its own header.
+	for (uint16_t size : { uint16_t(valid.size() + 1), uint16_t(UINT16_MAX), uint16_t(3) }) {
+		std::vector<uint8_t> manifest(valid);
+		std::memcpy(manifest.data() + sizeof(uint16_t), &size, sizeof(size));
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(manifest.data(), manifest.size(), decoded)) << "Record size " << size;
+	}
+
+	// Unknown ops.
+	for (uint16_t op : { uint16_t(RequestOp::None), uint16_t(RequestOp::Count), uint16_t(999) }) {
+		std::vector<uint8_t> manifest;
+		header(manifest, op, 8);
+		manifest.resize(8, 0);
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(manifest.data(), manifest.size(), decoded)) << "Op " << op;
+	}
+
+	// A name without its NUL, with the next record following it.
+	{
+		std::vector<uint8_t> manifest;
+		header(manifest, uint16_t(RequestOp::MapClientEventToSimEvent), 4 + 4 + 5);
+		manifest.insert(manifest.end(), { 1, 0, 0, 0, 'A', 'X', 'I', 'S', '_' });
+		manifest.insert(manifest.end(), valid.begin(), valid.end());
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(manifest.data(), manifest.size(), decoded));
+		EXPECT_TRUE(decoded.empty());
+	}
+
+	// Trailing bytes after the last name of an op without a payload.
+	{
+		std::vector<uint8_t> manifest(valid);
+		manifest.push_back(0);
+		uint16_t size{ uint16_t(manifest.size()) };
+		std::memcpy(manifest.data() + sizeof(uint16_t), &size, sizeof(size));
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(manifest.data(), manifest.size(), decoded));
+	}
+
+	// The records before a bad one are kept, so the caller can tell where it failed.
+	{
+		std::vector<uint8_t> manifest(valid);
+		manifest.insert(manifest.end(), valid.begin(), valid.end());
+		decoded.clear();
+		EXPECT_FALSE(Request::decodeAll(manifest.data(), manifest.size() - 1, decoded));
+		EXPECT_EQ(decoded.size(), 1);
+	}
+}
+
+TEST(RequestTests, TestManifestResults)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("RequestTests", handle));
+
+	std::vector<uint8_t> manifest;
+	Request{ RequestOp::AddToDataDefinition, { 1, SIMCONNECT_DATATYPE_FLOAT64, Request::fromFloat(0.0f), SIMCONNECT_UNUSED }, { "PLANE ALTITUDE", "feet" } }.encode(manifest);
+	Request{ RequestOp::MapClientEventToSimEvent, { 3 }, { "AXIS_RUDDER_SET" } }.encode(manifest);
+	Request{ RequestOp::SubscribeToSystemEvent, { 9 }, { "Frame" } }.encode(manifest);
+
+	// Fail the record after the data definition.
+	standin::setCallHook([](const standin::Call& call) {
+		if (std::strcmp(call.api, "AddToDataDefinition") == 0) {
+			standin::failNext(E_FAIL);
+		}
+	});
+	int64_t results[3]{};
+	EXPECT_EQ(CsRegisterManifest(handle, manifest.data(), uint32_t(manifest.size()), results, 3), 3) << "The manifest is sent as a whole";
+	standin::setCallHook(nullptr);
+
+	EXPECT_GT(results[0], 1) << "Records have their own SendID";
+	EXPECT_EQ(HRESULT(results[1]), E_FAIL) << "A failed record reports its HRESULT";
+	EXPECT_GT(results[2], 1) << "Records after a failed one are still sent";
+	EXPECT_NE(results[0], results[2]);
+
+	EXPECT_EQ(CsRegisterManifest(handle, manifest.data(), uint32_t(manifest.size()), results, 2), E_INVALIDARG) << "Results must fit";
+	EXPECT_EQ(CsRegisterManifest(handle, manifest.data(), uint32_t(manifest.size() - 1), nullptr, 0), E_INVALIDARG) << "Truncated";
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,261 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "../src/Requests.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+using nl::rakis::interop::Request;
+using nl::rakis::interop::RequestOp;
+
+enum class Mode { Direct, Fifo, Prioritized };
+
+/*
+ * Send a realtime event every 2ms while another thread floods the connection with registrations, and return the
+ * sorted latencies from the call to its arrival at the stand-in.
+ */
+static std::vector<Clock::duration> measure(Mode mode)
+{
+	constexpr size_t ROUNDS{ 200 };
+	constexpr size_t BULK{ 5000 };
+
+	standin::reset();
+	standin::setCallLatency(200us);
+
+	HANDLE handle;
+	EXPECT_TRUE(CsConnect("SchedulerTests", handle));
+	if (mode != Mode::Direct) {
+		EXPECT_TRUE(CsSetScheduling(handle, true));
+	}
+
+	std::vector<Clock::time_point> submitted(ROUNDS), received(ROUNDS);
+	standin::setCallHook([&received](const standin::Call& call) {
+		if ((std::strcmp(call.api, "TransmitClientEvent") == 0) && (call.args[2] < received.size())) {
+			received[call.args[2]] = call.time;
+		}
+	});
+
+	std::thread bulk([handle]() {
+		for (uint32_t i = 0; i < BULK; i++) {
+			CsAddToDataDefinition(handle, 1 + (i % 16), "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, i);
+		}
+	});
+	std::this_thread::sleep_for(10ms);
+
+	if (mode == Mode::Fifo) {
+		CsSetThreadRequestPriority(CS_PRIORITY_BULK);
+	}
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		submitted[i] = Clock::now();
+		CsTransmitClientEvent(handle, 0, 1, i, 1, 0);
+		std::this_thread::sleep_for(2ms);
+	}
+	CsSetThreadRequestPriority(CS_PRIORITY_DEFAULT);
+	bulk.join();
+
+	if (mode != Mode::Direct) {
+		CsSchedulerStatistics stats{};
+		auto deadline{ Clock::now() + 30s };
+		do {
+			std::this_thread::sleep_for(1ms);
+			CsGetSchedulerStatistics(handle, CS_PRIORITY_BULK, &stats);
+		} while ((stats.queued > 0) && (Clock::now() < deadline));
+	}
+	CsDisconnect(handle);
+
+	std::vector<Clock::duration> latencies;
+	for (size_t i = 0; i < ROUNDS; i++) {
+		latencies.push_back(received[i] - submitted[i]);
+	}
+	std::sort(latencies.begin(), latencies.end());
+	return latencies;
+}
+
+static int64_t micros(Clock::duration d)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+TEST(SchedulerTests, TestRealtimeLatencyUnderBulkLoad)
+{
+	for (auto [mode, name] : { std::pair{ Mode::Direct, "direct" }, std::pair{ Mode::Fifo, "single class" }, std::pair{ Mode::Prioritized, "prioritized" } }) {
+		auto latencies{ measure(mode) };
+		auto p50{ latencies[latencies.size() / 2] };
+		auto p99{ latencies[latencies.size() * 99 / 100] };
+		std::cerr << std::format("{:>12}: p50 {} us, p99 {} us, max {} us\n", name, micros(p50), micros(p99), micros(latencies.back()));
+
+		if (mode == Mode::Prioritized) {
+			// One bulk call of 200us may be in progress; the rest is thread wake-up time.
+			EXPECT_LT(p99, 5ms);
+		}
+	}
+	standin::reset();
+}
+
+TEST(SchedulerTests, TestRateLimit)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("SchedulerTests", handle));
+	ASSERT_TRUE(CsSetScheduling(handle, true));
+	ASSERT_TRUE(CsSetSchedulerRateLimit(handle, CS_PRIORITY_BULK, 100.0, 10));
+	EXPECT_FALSE(CsSetSchedulerRateLimit(handle, 3, 100.0, 10));
+
+	for (uint32_t i = 0; i < 30; i++) {
+		EXPECT_EQ(CsMapClientEventToSimEvent(handle, i, "AXIS_ELEVATOR_SET"), 1) << "Queued calls have no SendID";
+	}
+	EXPECT_EQ(CsTransmitClientEvent(handle, 0, 1, 2, 1, 0), 1);
+
+	std::this_thread::sleep_for(50ms);
+	CsSchedulerStatistics bulk{}, realtime{};
+	ASSERT_TRUE(CsGetSchedulerStatistics(handle, CS_PRIORITY_BULK, &bulk));
+	ASSERT_TRUE(CsGetSchedulerStatistics(handle, CS_PRIORITY_REALTIME, &realtime));
+	EXPECT_EQ(bulk.submitted, 30);
+	EXPECT_GE(bulk.sent, 10) << "The burst is sent at once";
+	EXPECT_LT(bulk.sent, 30) << "The rest is held back by the rate limit";
+	EXPECT_EQ(realtime.sent, 1) << "Other classes are not limited";
+
+	auto deadline{ Clock::now() + 5s };
+	while ((bulk.sent < 30) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(10ms);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_BULK, &bulk);
+	}
+	EXPECT_EQ(bulk.sent, 30);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+static ptrdiff_t indexOf(const std::vector<std::string>& log, const std::string& prefix)
+{
+	auto it{ std::find_if(log.begin(), log.end(), [&prefix](const std::string& line) { return line.starts_with(prefix); }) };
+	return (it == log.end()) ? -1 : (it - log.begin());
+}
+
+TEST(SchedulerTests, TestDependentCallsKeepOrder)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("SchedulerTests", handle));
+	ASSERT_TRUE(CsSetScheduling(handle, true));
+	ASSERT_TRUE(CsSetSchedulerRateLimit(handle, CS_PRIORITY_BULK, 200.0, 1));
+	standin::enableCallLog(true);
+
+	for (uint32_t i = 0; i < 10; i++) {
+		CsMapClientEventToSimEvent(handle, 10 + i, "AXIS_ELEVATOR_SET");
+	}
+	CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 0);
+	CsTransmitClientEvent(handle, 0, 1, 0, 1, 0);
+	CsTransmitClientEvent(handle, 0, 19, 0, 1, 0);
+	CsRequestDataOnSimObject(handle, 70, 7, 0, SIMCONNECT_PERIOD_SECOND, 0, 0, 0, 0);
+
+	CsSchedulerStatistics bulk{}, normal{};
+	auto deadline{ Clock::now() + 5s };
+	while (((bulk.sent < 11) || (normal.sent < 1)) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(5ms);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_BULK, &bulk);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_NORMAL, &normal);
+	}
+	auto log{ standin::takeCallLog() };
+	ASSERT_GE(indexOf(log, "MapClientEventToSimEvent 19"), 0);
+	ASSERT_GE(indexOf(log, "TransmitClientEvent 0 19"), 0);
+	ASSERT_GE(indexOf(log, "RequestDataOnSimObject 70 7"), 0);
+	EXPECT_LT(indexOf(log, "MapClientEventToSimEvent 19"), indexOf(log, "TransmitClientEvent 0 19")) << "An event waits for its mapping";
+	EXPECT_LT(indexOf(log, "AddToDataDefinition 7"), indexOf(log, "RequestDataOnSimObject 70 7")) << "A data request waits for its definition";
+	EXPECT_LT(indexOf(log, "TransmitClientEvent 0 1 "), indexOf(log, "MapClientEventToSimEvent 19")) << "Unrelated events are not held back";
+
+	// A manifest is sent after what was queued before it, with a result per record.
+	for (uint32_t i = 0; i < 5; i++) {
+		CsMapClientEventToSimEvent(handle, 30 + i, "AXIS_AILERONS_SET");
+	}
+	std::vector<uint8_t> manifest;
+	Request{ RequestOp::AddToDataDefinition, { 8, SIMCONNECT_DATATYPE_FLOAT64, Request::fromFloat(0.0f), 0 }, { "PLANE ALTITUDE", "feet" } }.encode(manifest);
+	Request{ RequestOp::MapClientEventToSimEvent, { 40 }, { "AXIS_RUDDER_SET" } }.encode(manifest);
+	int64_t results[2]{};
+	EXPECT_EQ(CsRegisterManifest(handle, manifest.data(), uint32_t(manifest.size()), results, 2), 2);
+	EXPECT_GT(results[0], 1) << "Records have their own SendID";
+	EXPECT_GT(results[1], 1);
+	log = standin::takeCallLog();
+	ASSERT_EQ(log.size(), 7);
+	EXPECT_TRUE(log[4].starts_with("MapClientEventToSimEvent 34"));
+	EXPECT_TRUE(log[5].starts_with("AddToDataDefinition 8"));
+
+	standin::enableCallLog(false);
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(SchedulerTests, TestBatchWriteWaitsForDefinition)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("SchedulerTests", handle));
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 0), 1);
+	ASSERT_TRUE(CsSetScheduling(handle, true));
+	ASSERT_TRUE(CsSetSchedulerRateLimit(handle, CS_PRIORITY_BULK, 100.0, 1));
+	standin::enableCallLog(true);
+
+	// The definition is replaced behind other bulk work, while the batch is a normal write
+	for (uint32_t i = 0; i < 5; i++) {
+		CsMapClientEventToSimEvent(handle, 10 + i, "AXIS_ELEVATOR_SET");
+	}
+	CsClearDataDefinition(handle, 7);
+	CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 0);
+
+	const double altitudes[2]{ 1000.0, 2000.0 };
+	const void* const columns[1]{ altitudes };
+	const uint32_t objectIds[2]{ 1, 2 };
+	int64_t results[2]{};
+	EXPECT_EQ(CsSetDataOnSimObjects(handle, 7, 2, objectIds, 0, columns, results), 2);
+	EXPECT_EQ(results[0], 1) << "Queued rows have no SendID yet";
+	EXPECT_EQ(results[1], 1);
+
+	CsSchedulerStatistics bulk{}, normal{};
+	auto deadline{ Clock::now() + 5s };
+	while (((bulk.sent < 7) || (normal.sent < 2)) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(5ms);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_BULK, &bulk);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_NORMAL, &normal);
+	}
+	auto log{ standin::takeCallLog() };
+	ASSERT_GE(indexOf(log, "AddToDataDefinition 7"), 0);
+	ASSERT_GE(indexOf(log, "SetDataOnSimObject 7 1 "), 0);
+	ASSERT_GE(indexOf(log, "SetDataOnSimObject 7 2 "), 0);
+	EXPECT_LT(indexOf(log, "ClearDataDefinition 7"), indexOf(log, "AddToDataDefinition 7"));
+	EXPECT_LT(indexOf(log, "AddToDataDefinition 7"), indexOf(log, "SetDataOnSimObject 7 1 ")) << "The rows wait for the definition";
+	EXPECT_LT(indexOf(log, "SetDataOnSimObject 7 1 "), indexOf(log, "SetDataOnSimObject 7 2 "));
+
+	standin::enableCallLog(false);
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,79 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "SharedRequests.h"
+
+using namespace nl::rakis::interop;
+
+
+static DataSchema position(const char* altitudeName)
+{
+	DataSchema schema;
+	schema.add(altitudeName, "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema.add("PLANE HEADING DEGREES TRUE", "degrees", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	return schema;
+}
+
+TEST(SharedRequestsTests, TestKey)
+{
+	const RequestParams params{ SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, 0, 0, 0, 0 };
+	const auto key{ SharedRequests::keyOf(position("PLANE ALTITUDE"), params) };
+
+	EXPECT_EQ(key, SharedRequests::keyOf(position("Plane Altitude"), params)) << "SimVar names are case-insensitive";
+	EXPECT_NE(key, SharedRequests::keyOf(position("PLANE ALT ABOVE GROUND"), params));
+
+	RequestParams changed{ params };
+	changed[1] = SIMCONNECT_PERIOD_SECOND;
+	EXPECT_NE(key, SharedRequests::keyOf(position("PLANE ALTITUDE"), changed));
+}
+
+TEST(SharedRequestsTests, TestJoinAndLeave)
+{
+	SharedRequests shared;
+	const RequestParams params{ SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME, 0, 0, 0, 0 };
+	const auto key{ SharedRequests::keyOf(position("PLANE ALTITUDE"), params) };
+	std::vector<Subscriber> subscribers;
+
+	EXPECT_TRUE(shared.join(key, { 1, 10 }, params)) << "The first subscriber sends the request";
+	EXPECT_FALSE(shared.join(key, { 2, 20 }, params));
+	EXPECT_FALSE(shared.join(key, { 3, 30 }, params));
+
+	ASSERT_TRUE(shared.subscribers(1, subscribers));
+	ASSERT_EQ(subscribers.size(), 2);
+	EXPECT_EQ(subscribers[0].requestId, 2);
+	EXPECT_EQ(subscribers[0].defId, 20);
+	EXPECT_FALSE(shared.subscribers(2, subscribers)) << "Only the carrier receives data";
+
+	uint32_t requests, total;
+	shared.statistics(requests, total);
+	EXPECT_EQ(requests, 1);
+	EXPECT_EQ(total, 3);
+
+	EXPECT_EQ(shared.leave(2).left, SharedRequests::Left::Subscriber);
+	auto handover{ shared.leave(1) };
+	EXPECT_EQ(handover.left, SharedRequests::Left::Handover);
+	EXPECT_EQ(handover.carrier.requestId, 3) << "A remaining subscriber takes over";
+	EXPECT_EQ(handover.params, params);
+	EXPECT_TRUE(shared.subscribers(3, subscribers));
+	EXPECT_TRUE(subscribers.empty());
+
+	EXPECT_EQ(shared.leave(3).left, SharedRequests::Left::Last);
+	EXPECT_TRUE(shared.empty());
+	EXPECT_EQ(shared.leave(3).left, SharedRequests::Left::NotShared);
+}
@@ -0,0 +1,189 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <psapi.h>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/LoadGenerator.h"
+#include "standin/StandInSimConnect.h"
+
+/*
+ * Soak tests for the dispatch path: a generated mix of inbound messages at a target rate, received through
+ * CsCallDispatch or CsGetNextDispatch while other threads keep sending. The defaults make a short run; set
+ * CS_SOAK_SECONDS, CS_SOAK_RATE (messages per second), CS_SOAK_SIZE (data payload bytes), CS_SOAK_SENDERS and
+ * CS_SOAK_CAPACITY (inbox limit, 0 for none) to scale it up.
+ */
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static uint32_t setting(const char* name, uint32_t defaultValue)
+{
+	const char* value{ std::getenv(name) };
+	return (value != nullptr) ? uint32_t(std::strtoul(value, nullptr, 10)) : defaultValue;
+}
+
+static uint64_t residentBytes()
+{
+	PROCESS_MEMORY_COUNTERS counters{};
+	return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+}
+
+/*
+ * Queueing latencies in 1us buckets up to 10ms, so recording them does not allocate however long the run.
+ */
+class LatencyHistogram {
+	static constexpr size_t BUCKETS{ 10000 };
+
+	std::vector<uint64_t> buckets_ = std::vector<uint64_t>(BUCKETS + 1, 0);
+	uint64_t count_{ 0 };
+	int64_t max_{ 0 };
+
+public:
+	void record(int64_t nanos) {
+		const int64_t micros{ std::max<int64_t>(nanos / 1000, 0) };
+		buckets_[std::min<size_t>(size_t(micros), BUCKETS)]++;
+		max_ = std::max(max_, micros);
+		count_++;
+	}
+
+	int64_t percentile(uint32_t permille) const {
+		const uint64_t target{ (count_ * permille + 999) / 1000 };
+		uint64_t seen{ 0 };
+		for (size_t i = 0; i < BUCKETS; i++) {
+			if ((seen += buckets_[i]) >= target) {
+				return int64_t(i);
+			}
+		}
+		return max_;
+	}
+
+	inline uint64_t count() const { return count_; }
+	inline int64_t max() const { return max_; }
+};
+
+static std::atomic<uint64_t> received{ 0 };
+static LatencyHistogram latencies;
+
+static void receive(SIMCONNECT_RECV* pData, DWORD cbData, void*)
+{
+	received++;
+	if (const int64_t pushedAt{ standin::LoadGenerator::pushedAt(pData, cbData) }; pushedAt >= 0) {
+		const int64_t now{ std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count() };
+		latencies.record(now - pushedAt);
+	}
+}
+
+static void soak(const char* mode, bool callDispatch)
+{
+	const auto duration{ std::chrono::seconds(setting("CS_SOAK_SECONDS", 2)) };
+	const uint32_t senders{ setting("CS_SOAK_SENDERS", 2) };
+	standin::LoadProfile profile;
+	profile.messagesPerSecond = setting("CS_SOAK_RATE", 20000);
+	profile.dataSize = setting("CS_SOAK_SIZE", 64);
+
+	standin::reset();
+	standin::setInboxCapacity(setting("CS_SOAK_CAPACITY", 0));
+	received = 0;
+	latencies = LatencyHistogram();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("SoakTests", handle));
+
+	// Outbound traffic competing for the SimConnect lock, at 1000 calls per second per thread.
+	std::atomic<bool> sending{ true };
+	std::atomic<uint64_t> sent{ 0 };
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < senders; t++) {
+		threads.emplace_back([&sending, &sent, handle, t]() {
+			for (uint32_t i = 0; sending; i++) {
+				if ((i % 2) == 0) {
+					CsTransmitClientEvent(handle, 0, t + 1, i, 1, 0);
+				}
+				else {
+					CsRequestDataOnSimObject(handle, 100 + t, 1, 0, 0, 0, 0, 0, 0);
+				}
+				sent++;
+				std::this_thread::sleep_for(1ms);
+			}
+		});
+	}
+
+	auto dispatch = [handle, callDispatch]() {
+		if (callDispatch) {
+			CsCallDispatch(handle, receive);
+		}
+		else {
+			while (CsGetNextDispatch(handle, receive)) {
+			}
+		}
+	};
+
+	const auto start{ Clock::now() };
+	standin::LoadGenerator generator(handle, profile);
+	uint64_t warmMemory{ 0 };
+	while (Clock::now() - start < duration) {
+		dispatch();
+		if ((warmMemory == 0) && (Clock::now() - start >= duration / 10)) {
+			warmMemory = residentBytes();
+		}
+		std::this_thread::yield();
+	}
+	generator.stop();
+	const double elapsed{ std::chrono::duration<double>(Clock::now() - start).count() };
+	while (standin::pending(handle) > 0) {
+		dispatch();
+	}
+	const int64_t growth{ int64_t(residentBytes()) - int64_t(warmMemory) };
+
+	sending = false;
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	const uint64_t dropped{ standin::dropped(handle) };
+	EXPECT_EQ(received + dropped, generator.generated()) << "Every message is either received or dropped by the queue";
+
+	std::cerr << std::format("{:>16}: {} generated, {} received, {} dropped, {:.0f} msg/s sustained, {:.0f} calls/s outbound\n",
+		mode, generator.generated(), received.load(), dropped, double(received) / elapsed, double(sent) / elapsed);
+	std::cerr << std::format("{:>16}  latency p50 {} us, p99 {} us, p99.9 {} us, max {} us; memory growth {} KB\n",
+		"", latencies.percentile(500), latencies.percentile(990), latencies.percentile(999), latencies.max(), growth / 1024);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(SoakTests, TestCallDispatch)
+{
+	soak("CsCallDispatch", true);
+}
+
+TEST(SoakTests, TestGetNextDispatch)
+{
+	soak("CsGetNextDispatch", false);
+}
@@ -0,0 +1,187 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "TelemetryRecorder.h"
+
+using namespace nl::rakis::interop;
+
+#pragma pack(push, 1)
+struct Row {
+	double altitude;
+	SIMCONNECT_DATA_LATLONALT position;
+	float heading;
+	int32_t onGround;
+	char title[8];
+};
+#pragma pack(pop)
+
+static std::shared_ptr<const DataSchema> rowSchema()
+{
+	auto schema{ std::make_shared<DataSchema>() };
+	schema->add("PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("STRUCT LATLONALT", nullptr, SIMCONNECT_DATATYPE_LATLONALT, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("PLANE HEADING DEGREES TRUE", "degrees", SIMCONNECT_DATATYPE_FLOAT32, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("SIM ON GROUND", "bool", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED);
+	schema->add("ATC ID", nullptr, SIMCONNECT_DATATYPE_STRING8, 0.0f, SIMCONNECT_UNUSED);
+	return schema;
+}
+
+static Row makeRow(int i)
+{
+	Row row{ 1000.0 + i * 0.5, { 52.0 + i * 1e-6, 4.75, 1000.0 }, float(i % 360), (i < 10) ? 1 : -7, "PH-BLA" };
+	return row;
+}
+
+static std::string tempPath(const char* name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(TelemetryRecorderTests, TestCodecRoundTrip)
+{
+	auto schema{ rowSchema() };
+	std::vector<Row> rows;
+	std::vector<int64_t> times;
+	std::vector<uint32_t> objectIds;
+	for (int i = 0; i < 100; i++) {
+		rows.push_back(makeRow(i));
+		times.push_back(1'000'000 + i * 16'667);
+		objectIds.push_back((i % 2 == 0) ? 1 : 4242);
+	}
+	std::vector<uint8_t> encoded;
+	TelemetryCodec::encode(*schema, rows.size(), times.data(), objectIds.data(), reinterpret_cast<const uint8_t*>(rows.data()), encoded);
+	EXPECT_LT(encoded.size(), rows.size() * sizeof(Row) * 2 / 3) << "Slowly changing values take less space";
+
+	std::vector<Row> decoded(rows.size());
+	std::vector<int64_t> decodedTimes(rows.size());
+	std::vector<uint32_t> decodedIds(rows.size());
+	ASSERT_TRUE(TelemetryCodec::decode(*schema, rows.size(), encoded.data(), encoded.size(), decodedTimes.data(), decodedIds.data(), reinterpret_cast<uint8_t*>(decoded.data())));
+	EXPECT_EQ(std::memcmp(decoded.data(), rows.data(), rows.size() * sizeof(Row)), 0);
+	EXPECT_EQ(decodedTimes, times);
+	EXPECT_EQ(decodedIds, objectIds);
+
+	EXPECT_FALSE(TelemetryCodec::decode(*schema, rows.size(), encoded.data(), encoded.size() - 1, decodedTimes.data(), decodedIds.data(), reinterpret_cast<uint8_t*>(decoded.data())))
+		<< "A truncated chunk is rejected";
+}
+
+TEST(TelemetryRecorderTests, TestRecordAndRead)
+{
+	const std::string path{ tempPath("TestRecordAndRead.cstr") };
+	const size_t count{ TelemetryRecorder::CHUNK_ROWS * 2 + 100 };
+	{
+		auto recorder{ TelemetryRecorder::create(path.c_str(), 500) };
+		ASSERT_NE(recorder, nullptr);
+		ASSERT_TRUE(recorder->add(7, 3, rowSchema()));
+		EXPECT_FALSE(recorder->add(7, 3, rowSchema())) << "A request is recorded only once";
+
+		for (size_t i = 0; i < count; i++) {
+			Row row{ makeRow(int(i)) };
+			recorder->record(7, 1, int64_t(i) * 1000, &row, sizeof(row));
+			recorder->record(8, 1, int64_t(i) * 1000, &row, sizeof(row));
+		}
+		recorder->record(7, 1, 0, "short", 5);
+		recorder->close();
+
+		const auto stats{ recorder->statistics() };
+		EXPECT_EQ(stats.rows, count);
+		EXPECT_EQ(stats.dropped, 1) << "Only the short row is dropped, not the unrecorded request";
+		EXPECT_EQ(stats.bytes, std::filesystem::file_size(path));
+	}
+	auto reader{ TelemetryReader::open(path.c_str()) };
+	ASSERT_NE(reader, nullptr);
+	uint32_t requestIds[4]{};
+	ASSERT_EQ(reader->streams(requestIds, 4), 1);
+	EXPECT_EQ(requestIds[0], 7);
+	EXPECT_EQ(reader->chunks(7), 3);
+	ASSERT_NE(reader->schema(7), nullptr);
+	EXPECT_EQ(reader->schema(7)->size(), sizeof(Row));
+	EXPECT_LE(reader->epoch(), std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+	// A range crossing the first chunk boundary
+	const int64_t from{ int64_t(TelemetryRecorder::CHUNK_ROWS - 10) * 1000 };
+	std::vector<int64_t> times(50);
+	std::vector<uint32_t> objectIds(50);
+	std::vector<double> altitudes(50);
+	std::vector<SIMCONNECT_DATA_LATLONALT> positions(50);
+	std::vector<float> headings(50);
+	std::vector<int32_t> onGround(50);
+	std::vector<char> titles(50 * 8);
+	void* const columns[]{ altitudes.data(), positions.data(), headings.data(), onGround.data(), titles.data() };
+
+	ASSERT_EQ(reader->read(7, from, from + 20'000, 50, times.data(), objectIds.data(), columns), 20);
+	for (size_t i = 0; i < 20; i++) {
+		const Row expected{ makeRow(int(TelemetryRecorder::CHUNK_ROWS - 10 + i)) };
+		EXPECT_EQ(times[i], from + int64_t(i) * 1000);
+		EXPECT_EQ(objectIds[i], 1);
+		EXPECT_EQ(altitudes[i], expected.altitude);
+		EXPECT_EQ(positions[i].Latitude, expected.position.Latitude);
+		EXPECT_EQ(headings[i], expected.heading);
+		EXPECT_EQ(onGround[i], expected.onGround);
+		EXPECT_STREQ(&titles[i * 8], "PH-BLA");
+	}
+	EXPECT_EQ(reader->read(7, 0, INT64_MAX, 50, times.data(), nullptr, nullptr), 50) << "The row limit holds";
+	EXPECT_EQ(reader->read(7, int64_t(count) * 1000, INT64_MAX, 50, times.data(), nullptr, nullptr), 0);
+	EXPECT_EQ(reader->read(8, 0, INT64_MAX, 50, times.data(), nullptr, nullptr), 0);
+
+	reader.reset();
+	std::filesystem::remove(path);
+}
+
+TEST(TelemetryRecorderTests, TestReadWithoutIndex)
+{
+	const std::string path{ tempPath("TestReadWithoutIndex.cstr") };
+	{
+		auto recorder{ TelemetryRecorder::create(path.c_str(), 0) };
+		ASSERT_NE(recorder, nullptr);
+		ASSERT_TRUE(recorder->add(1, 1, rowSchema()));
+		for (int i = 0; i < 100; i++) {
+			Row row{ makeRow(i) };
+			recorder->record(1, 1, i, &row, sizeof(row));
+		}
+	}
+	// Cut off the index and trailer, and half of a record that might follow
+	const auto size{ std::filesystem::file_size(path) };
+	std::vector<char> data(size);
+	{
+		std::ifstream in(path, std::ios::binary);
+		in.read(data.data(), data.size());
+	}
+	uint64_t indexOffset{ 0 };
+	std::memcpy(&indexOffset, data.data() + size - 12, sizeof(indexOffset));
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), indexOffset + 6);
+	}
+	auto reader{ TelemetryReader::open(path.c_str()) };
+	ASSERT_NE(reader, nullptr);
+	EXPECT_EQ(reader->chunks(1), 1);
+	std::vector<int64_t> times(200);
+	EXPECT_EQ(reader->read(1, 0, INT64_MAX, 200, times.data(), nullptr, nullptr), 100);
+	EXPECT_EQ(times[99], 99);
+
+	reader.reset();
+	std::filesystem::remove(path);
+}
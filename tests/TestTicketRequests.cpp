@@ -0,0 +1,149 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+static void ignore(SIMCONNECT_RECV*, DWORD, void*)
+{
+}
+
+static std::atomic<int64_t> calledTicket{ 0 };
+static std::atomic<uint32_t> calledRequestId{ 0 };
+
+static void onReply(int64_t ticket, SIMCONNECT_RECV* pData, DWORD)
+{
+	calledTicket = ticket;
+	calledRequestId = (pData != nullptr) ? static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData)->dwRequestID : 0;
+}
+
+/*
+ * Dispatch on another thread until the ticket is no longer pending, as a client waiting for it would.
+ */
+static int64_t waitWhileDispatching(HANDLE handle, int64_t ticket)
+{
+	std::atomic<bool> done{ false };
+	std::thread dispatcher([handle, &done]() {
+		while (!done) {
+			if (!CsGetNextDispatch(handle, ignore)) {
+				std::this_thread::sleep_for(1ms);
+			}
+		}
+	});
+	const int64_t state{ CsWaitForTicket(handle, ticket, 2000) };
+	done = true;
+	dispatcher.join();
+	return state;
+}
+
+TEST(TicketRequestTests, TestCompleteFromDispatch)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("TicketRequestTests", handle));
+
+	const int64_t ticket{ CsRequestSystemStateAsync(handle, 5, "Sim", nullptr) };
+	ASSERT_GT(ticket, 1);
+	EXPECT_EQ(CsGetTicketState(handle, ticket), CS_TICKET_PENDING);
+	standin::pushSystemState(handle, 5, 1, 0.0f, nullptr);
+	EXPECT_TRUE(CsGetNextDispatch(handle, ignore));
+	EXPECT_EQ(CsGetTicketState(handle, ticket), CS_TICKET_COMPLETED);
+
+	SIMCONNECT_RECV_SYSTEM_STATE reply{};
+	ASSERT_EQ(CsGetTicketReply(handle, ticket, &reply, sizeof(reply)), sizeof(reply));
+	EXPECT_EQ(reply.dwRequestID, 5);
+	EXPECT_EQ(reply.dwInteger, 1);
+	EXPECT_TRUE(CsReleaseTicket(handle, ticket));
+	EXPECT_EQ(CsGetTicketState(handle, ticket), CS_TICKET_UNKNOWN);
+	EXPECT_FALSE(CsReleaseTicket(handle, ticket));
+
+	// With a callback the reply is passed on from dispatch, and the ticket released
+	EXPECT_GT(CsAddToDataDefinition(handle, 7, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED), 0);
+	calledTicket = 0;
+	const int64_t once{ CsRequestDataOnSimObjectOnce(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, 0, onReply) };
+	ASSERT_GT(once, 1);
+	const double altitude{ 1000.0 };
+	standin::pushSimObjectData(handle, 70, 7, SIMCONNECT_OBJECT_ID_USER, &altitude, sizeof(altitude));
+	EXPECT_TRUE(CsGetNextDispatch(handle, ignore));
+	EXPECT_EQ(calledTicket, once);
+	EXPECT_EQ(calledRequestId, 70);
+	EXPECT_EQ(CsGetTicketState(handle, once), CS_TICKET_UNKNOWN);
+
+	EXPECT_EQ(CsGetTicketState(nullptr, once), CS_TICKET_UNKNOWN);
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
+
+TEST(TicketRequestTests, TestFailFromException)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("TicketRequestTests", handle));
+
+	// SendIDs count up per call
+	const int64_t sendId{ CsRequestSystemState(handle, 4, "Sim") };
+	ASSERT_GT(sendId, 0);
+	const int64_t ticket{ CsRequestSystemStateAsync(handle, 5, "Sim", nullptr) };
+	ASSERT_GT(ticket, 1);
+	standin::pushException(handle, SIMCONNECT_EXCEPTION_NAME_UNRECOGNIZED, uint32_t(sendId + 1), 1);
+	EXPECT_TRUE(CsGetNextDispatch(handle, ignore));
+	EXPECT_EQ(CsGetTicketState(handle, ticket), CS_TICKET_FAILED);
+	SIMCONNECT_RECV_EXCEPTION exception{};
+	ASSERT_EQ(CsGetTicketReply(handle, ticket, &exception, sizeof(exception)), sizeof(exception));
+	EXPECT_EQ(exception.dwSendID, sendId + 1);
+	EXPECT_TRUE(CsReleaseTicket(handle, ticket));
+
+	// A queued request learns its SendID when the scheduler sends it
+	ASSERT_TRUE(CsSetScheduling(handle, true));
+	const int64_t queued{ CsRequestSystemStateAsync(handle, 6, "Sim", nullptr) };
+	ASSERT_GT(queued, 1);
+	CsSchedulerStatistics stats{};
+	auto deadline{ Clock::now() + 2s };
+	while ((stats.sent == 0) && (Clock::now() < deadline)) {
+		std::this_thread::sleep_for(1ms);
+		CsGetSchedulerStatistics(handle, CS_PRIORITY_NORMAL, &stats);
+	}
+	standin::pushException(handle, SIMCONNECT_EXCEPTION_NAME_UNRECOGNIZED, uint32_t(sendId + 2), 1);
+	const auto start{ Clock::now() };
+	EXPECT_EQ(waitWhileDispatching(handle, queued), CS_TICKET_FAILED);
+	EXPECT_LT(Clock::now() - start, 1s) << "The exception fails the ticket, rather than the timeout";
+	EXPECT_TRUE(CsReleaseTicket(handle, queued));
+
+	// A queued request that cannot be sent fails its ticket without a reply
+	standin::failNext(E_FAIL);
+	const int64_t failed{ CsRequestSystemStateAsync(handle, 7, "Sim", nullptr) };
+	ASSERT_GT(failed, 1);
+	EXPECT_EQ(CsWaitForTicket(handle, failed, 2000), CS_TICKET_FAILED);
+	EXPECT_EQ(CsGetTicketReply(handle, failed, nullptr, 0), 0);
+	EXPECT_TRUE(CsReleaseTicket(handle, failed));
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,105 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Tickets.h"
+
+using namespace nl::rakis::interop;
+using namespace std::chrono_literals;
+
+TEST(TicketTests, TestCompleteOutOfOrder)
+{
+	TicketTable tickets;
+	std::vector<uint64_t> issued;
+
+	for (uint32_t requestId = 0; requestId < 300; requestId++) {
+		issued.push_back(tickets.issue(requestId));
+		ASSERT_GT(issued.back(), 1);
+	}
+	for (uint32_t requestId = 300; requestId-- > 0; ) {
+		EXPECT_TRUE(tickets.complete(requestId, &requestId, sizeof(requestId)));
+	}
+	EXPECT_FALSE(tickets.hasPending());
+
+	for (uint32_t requestId = 0; requestId < 300; requestId++) {
+		uint32_t reply{ 0 };
+		EXPECT_EQ(tickets.state(issued[requestId]), TicketState::Completed);
+		EXPECT_EQ(tickets.reply(issued[requestId], &reply, sizeof(reply)), sizeof(reply));
+		EXPECT_EQ(reply, requestId);
+		EXPECT_TRUE(tickets.release(issued[requestId]));
+	}
+	EXPECT_EQ(tickets.state(issued[0]), TicketState::Unknown);
+	EXPECT_FALSE(tickets.complete(0, nullptr, 0)) << "Nothing is pending";
+}
+
+TEST(TicketTests, TestStaleTickets)
+{
+	TicketTable tickets;
+
+	uint64_t first{ tickets.issue(1) };
+	EXPECT_TRUE(tickets.release(first));
+	EXPECT_FALSE(tickets.release(first));
+
+	for (size_t i = 0; i < TicketTable::CAPACITY; i++) {
+		uint64_t ticket{ tickets.issue(2) };
+		ASSERT_NE(ticket, 0);
+		EXPECT_NE(ticket, first) << "Reused slots get a new generation";
+	}
+	EXPECT_EQ(tickets.issue(3), 0) << "All slots are in use";
+	EXPECT_EQ(tickets.state(first), TicketState::Unknown);
+}
+
+TEST(TicketTests, TestCallbackAndFailure)
+{
+	TicketTable tickets;
+	uint64_t called{ 0 };
+	TicketState calledState{ TicketState::Unknown };
+
+	uint64_t ticket{ tickets.issue(5, [&](uint64_t t, TicketState state, const void*, uint32_t) { called = t; calledState = state; }) };
+	tickets.sent(ticket, 42);
+	EXPECT_FALSE(tickets.fail(41, nullptr, 0));
+	EXPECT_TRUE(tickets.fail(42, nullptr, 0));
+	EXPECT_EQ(called, ticket);
+	EXPECT_EQ(calledState, TicketState::Failed);
+	EXPECT_EQ(tickets.state(ticket), TicketState::Unknown) << "Callback tickets are released after the call";
+
+	uint64_t older{ tickets.issue(6) };
+	uint64_t newer{ tickets.issue(6) };
+	EXPECT_TRUE(tickets.complete(6, nullptr, 0));
+	EXPECT_EQ(tickets.state(older), TicketState::Completed) << "The oldest ticket for a requestId completes first";
+	EXPECT_EQ(tickets.state(newer), TicketState::Pending);
+}
+
+TEST(TicketTests, TestWait)
+{
+	TicketTable tickets;
+
+	uint64_t ticket{ tickets.issue(7) };
+	EXPECT_EQ(tickets.wait(ticket, 10ms), TicketState::Pending);
+
+	std::thread dispatch([&tickets]() {
+		std::this_thread::sleep_for(20ms);
+		tickets.complete(7, nullptr, 0);
+	});
+	EXPECT_EQ(tickets.wait(ticket, 5s), TicketState::Completed);
+	dispatch.join();
+}
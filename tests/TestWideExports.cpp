@@ -0,0 +1,67 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+/*
+ * The name as SimConnect should get it: converted to the ANSI code page, as the ANSI variant of a call expects.
+ */
+static std::string ansi(const wchar_t* name)
+{
+	const int size{ WideCharToMultiByte(CP_ACP, 0, name, -1, nullptr, 0, nullptr, nullptr) };
+	std::string result(size_t(size), '\0');
+	WideCharToMultiByte(CP_ACP, 0, name, -1, result.data(), size, nullptr, nullptr);
+	result.resize(size_t(size) - 1);
+	return result;
+}
+
+TEST(WideExportTests, TestNamesReachSimConnect)
+{
+	standin::reset();
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnectW(L"WideExportTests", handle));
+	standin::enableCallLog(true);
+
+	const wchar_t* eventName{ L"Caf\u00e9.Toggle" };
+	const wchar_t* units{ L"\u00b0C" };
+	const wchar_t* title{ L"Cessna Sk\u00fdhawk" };
+	const wchar_t* tailNumber{ L"PH-\u00c5BC" };
+	const wchar_t* flightPlan{ L"Pl\u00e4ne\\Route" };
+
+	EXPECT_GT(CsMapClientEventToSimEventW(handle, 10, eventName), 1);
+	EXPECT_GT(CsAddToDataDefinitionW(handle, 7, L"AMBIENT TEMPERATURE", units, SIMCONNECT_DATATYPE_FLOAT64, 0.0f, 3), 1);
+	EXPECT_GT(CsAICreateParkedATCAircraftW(handle, title, tailNumber, L"EHAM", 5), 1);
+	EXPECT_GT(CsAICreateEnrouteATCAircraftW(handle, title, tailNumber, 123, flightPlan, 0.5, 0, 6), 1);
+
+	EXPECT_EQ(standin::takeCallLog(), (std::vector<std::string>{
+		"MapClientEventToSimEvent 10 " + ansi(eventName),
+		"AddToDataDefinition 7 4 3 AMBIENT TEMPERATURE " + ansi(units) + " 0",
+		"AICreateParkedATCAircraft 5 " + ansi(title) + " " + ansi(tailNumber) + " EHAM",
+		"AICreateEnrouteATCAircraft 6 123 0 " + ansi(title) + " " + ansi(tailNumber) + " " + ansi(flightPlan) + " 0.5" }));
+
+	EXPECT_EQ(CsMapClientEventToSimEventW(nullptr, 11, eventName), FALSE);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
@@ -0,0 +1,72 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "WriteFilter.h"
+
+using namespace nl::rakis::interop;
+
+TEST(WriteFilterTests, TestBytes)
+{
+	WriteFilter filter;
+	uint8_t data[]{ 1, 2, 3, 4 };
+
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 1, 2, nullptr, data, sizeof(data)));
+	EXPECT_FALSE(filter.offer(WriteTarget::ClientData, 1, 2, nullptr, data, sizeof(data)));
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 1, 3, nullptr, data, sizeof(data))) << "Other define";
+	EXPECT_TRUE(filter.offer(WriteTarget::SimObject, 1, 2, nullptr, data, sizeof(data))) << "Other kind of target";
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 1, 2, nullptr, data, 3)) << "Other size";
+
+	data[3] = 5;
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 1, 2, nullptr, data, sizeof(data)));
+	filter.forget(WriteTarget::ClientData, 1, 2);
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 1, 2, nullptr, data, sizeof(data))) << "Forgotten after a failed send";
+	EXPECT_EQ(filter.suppressed(), 1);
+
+	EXPECT_TRUE(filter.offer(WriteTarget::ClientData, 9, 9, nullptr, nullptr, 0)) << "The first write is never suppressed";
+	EXPECT_FALSE(filter.offer(WriteTarget::ClientData, 9, 9, nullptr, nullptr, 0));
+}
+
+TEST(WriteFilterTests, TestTolerance)
+{
+	DataSchema schema;
+	schema.add("PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 1.0f, SIMCONNECT_UNUSED);
+	schema.add("FLAPS HANDLE INDEX", "number", SIMCONNECT_DATATYPE_INT32, 0.0f, SIMCONNECT_UNUSED);
+	ASSERT_EQ(schema.size(), 12);
+
+	uint8_t row[12];
+	auto set = [&row](double altitude, int32_t flaps) {
+		std::memcpy(row, &altitude, sizeof(altitude));
+		std::memcpy(row + 8, &flaps, sizeof(flaps));
+	};
+
+	WriteFilter filter;
+	set(1000.0, 1);
+	EXPECT_TRUE(filter.offer(WriteTarget::SimObject, 1, 0, &schema, row, sizeof(row)));
+	set(1000.9, 1);
+	EXPECT_FALSE(filter.offer(WriteTarget::SimObject, 1, 0, &schema, row, sizeof(row))) << "Within epsilon";
+	set(1001.5, 1);
+	EXPECT_TRUE(filter.offer(WriteTarget::SimObject, 1, 0, &schema, row, sizeof(row))) << "Compared to the last value sent";
+	set(1001.5, 2);
+	EXPECT_TRUE(filter.offer(WriteTarget::SimObject, 1, 0, &schema, row, sizeof(row))) << "No epsilon means exact";
+
+	set(1001.6, 2);
+	EXPECT_TRUE(filter.offer(WriteTarget::SimObject, 1, 0, nullptr, row, sizeof(row))) << "Without a schema bytes must match";
+}
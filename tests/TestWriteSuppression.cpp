@@ -0,0 +1,74 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+
+#include "../src/CsSimConnectInterOp.h"
+#include "standin/StandInSimConnect.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+TEST(WriteSuppressionTests, TestSuppressUnchanged)
+{
+	constexpr uint32_t ROUNDS{ 10000 };
+
+	standin::reset();
+	standin::setCallLatency(5us);
+
+	HANDLE handle;
+	ASSERT_TRUE(CsConnect("WriteSuppressionTests", handle));
+	ASSERT_GT(CsAddToDataDefinition(handle, 1, "PLANE ALTITUDE", "feet", SIMCONNECT_DATATYPE_FLOAT64, 0.5f, SIMCONNECT_UNUSED), 0);
+
+	double altitude{ 1000.0 };
+	auto start{ Clock::now() };
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		CsSetDataOnSimObject(handle, 1, 0, 0, 0, sizeof(altitude), &altitude);
+	}
+	auto sent{ (Clock::now() - start) / ROUNDS };
+	size_t calls{ standin::callCount() };
+
+	ASSERT_TRUE(CsSetWriteSuppression(handle, true));
+	EXPECT_GT(CsSetDataOnSimObject(handle, 1, 0, 0, 0, sizeof(altitude), &altitude), 0) << "The first write always goes out";
+	start = Clock::now();
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		altitude = 1000.0 + (i % 2) * 0.25;
+		EXPECT_EQ(CsSetDataOnSimObject(handle, 1, 0, 0, 0, sizeof(altitude), &altitude), CS_RESULT_SUPPRESSED);
+	}
+	auto suppressed{ (Clock::now() - start) / ROUNDS };
+	EXPECT_EQ(standin::callCount(), calls + 1) << "Only the first write reached SimConnect";
+	EXPECT_EQ(CsGetSuppressedWriteCount(handle), ROUNDS);
+
+	altitude = 1001.0;
+	EXPECT_GT(CsSetDataOnSimObject(handle, 1, 0, 0, 0, sizeof(altitude), &altitude), 0);
+	EXPECT_GT(CsSetDataOnSimObject(handle, 1, 1, 0, 0, sizeof(altitude), &altitude), 0) << "Objects are tracked separately";
+
+	uint8_t block[16]{};
+	EXPECT_GT(CsSetClientData(handle, 1, 2, 0, sizeof(block), block), 0);
+	EXPECT_EQ(CsSetClientData(handle, 1, 2, 0, sizeof(block), block), CS_RESULT_SUPPRESSED);
+
+	std::cerr << std::format("sent: {} ns per call, suppressed: {} ns per call\n",
+		std::chrono::duration_cast<std::chrono::nanoseconds>(sent).count(), std::chrono::duration_cast<std::chrono::nanoseconds>(suppressed).count());
+	EXPECT_LT(suppressed, sent);
+
+	EXPECT_TRUE(CsDisconnect(handle));
+	standin::reset();
+}
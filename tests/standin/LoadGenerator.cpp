@@ -0,0 +1,100 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "LoadGenerator.h"
+#include "StandInSimConnect.h"
+
+using namespace standin;
+using Clock = std::chrono::steady_clock;
+
+
+LoadGenerator::LoadGenerator(HANDLE handle, const LoadProfile& profile)
+	: handle_(handle), profile_(profile)
+{
+	profile_.dataSize = std::max(profile_.dataSize, uint32_t(sizeof(int64_t)));
+	thread_ = std::thread([this]() { run(); });
+}
+
+LoadGenerator::~LoadGenerator()
+{
+	stop();
+}
+
+void LoadGenerator::stop()
+{
+	running_ = false;
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+/*static*/ int64_t LoadGenerator::pushedAt(const SIMCONNECT_RECV* msg, DWORD size)
+{
+	const size_t header{ sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD) };	// dwData is where the data starts
+
+	if (((msg->dwID != SIMCONNECT_RECV_ID_SIMOBJECT_DATA) && (msg->dwID != SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE)) || (size < header + sizeof(int64_t))) {
+		return -1;
+	}
+	int64_t nanos;
+	std::memcpy(&nanos, reinterpret_cast<const uint8_t*>(msg) + header, sizeof(nanos));
+	return nanos;
+}
+
+void LoadGenerator::run()
+{
+	const LoadMix& mix{ profile_.mix };
+	const uint32_t total{ std::max(mix.simObjectData + mix.simObjectDataByType + mix.events + mix.exceptions, 1u) };
+	std::minstd_rand random{ 42 };
+	std::vector<uint8_t> data(profile_.dataSize, 0);
+
+	const auto start{ Clock::now() };
+	uint64_t count{ 0 };
+	while (running_) {
+		// Catch up with the schedule in a burst, then sleep until the next message is due.
+		const auto elapsed{ std::chrono::duration<double>(Clock::now() - start).count() };
+		const uint64_t due{ uint64_t(elapsed * profile_.messagesPerSecond) };
+		if (count >= due) {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			continue;
+		}
+		for (; count < due; count++) {
+			uint32_t pick{ uint32_t(random() % total) };
+			const int64_t now{ std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count() };
+			std::memcpy(data.data(), &now, sizeof(now));
+
+			if (pick < mix.simObjectData) {
+				pushSimObjectData(handle_, profile_.requestId, profile_.defineId, 0, data.data(), data.size());
+			}
+			else if ((pick -= mix.simObjectData) < mix.simObjectDataByType) {
+				pushSimObjectData(handle_, profile_.requestId, profile_.defineId, uint32_t(count % 64) + 1, data.data(), data.size(), true);
+			}
+			else if ((pick -= mix.simObjectDataByType) < mix.events) {
+				pushEvent(handle_, 1, 2, uint32_t(count));
+			}
+			else {
+				pushException(handle_, SIMCONNECT_EXCEPTION_ERROR, uint32_t(count), 0);
+			}
+			generated_.fetch_add(1, std::memory_order_release);
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "framework.h"
+#include <SimConnect.h>
+
+namespace standin {
+
+	/*
+	 * Relative weights of the message kinds in a load.
+	 */
+	struct LoadMix {
+		uint32_t simObjectData{ 60 };
+		uint32_t simObjectDataByType{ 20 };
+		uint32_t events{ 15 };
+		uint32_t exceptions{ 5 };
+	};
+
+	struct LoadProfile {
+		LoadMix mix;
+		uint32_t messagesPerSecond{ 10000 };
+		uint32_t dataSize{ 64 };		// Payload of data messages, at least 8 bytes
+		uint32_t requestId{ 1 };
+		uint32_t defineId{ 1 };
+	};
+
+	/*
+	 * Pushes a mix of inbound messages for a handle at a steady rate, on a thread of its own. Data messages carry
+	 * the time they were pushed in their first 8 bytes, so the receiver can measure how long they were queued.
+	 */
+	class LoadGenerator {
+		HANDLE handle_;
+		LoadProfile profile_;
+		std::atomic<bool> running_{ true };
+		std::atomic<uint64_t> generated_{ 0 };
+		std::thread thread_;
+
+		void run();
+
+	public:
+		LoadGenerator(HANDLE handle, const LoadProfile& profile);
+		LoadGenerator(const LoadGenerator&) = delete;
+		LoadGenerator(LoadGenerator&&) = delete;
+		~LoadGenerator();
+		LoadGenerator& operator=(const LoadGenerator&) = delete;
+		LoadGenerator& operator=(LoadGenerator&&) = delete;
+
+		void stop();
+		inline uint64_t generated() const { return generated_.load(std::memory_order_acquire); }
+
+		/*
+		 * The steady clock time in nanoseconds at which a data message was pushed, or -1 for other messages.
+		 */
+		static int64_t pushedAt(const SIMCONNECT_RECV* msg, DWORD size);
+	};
+
+}
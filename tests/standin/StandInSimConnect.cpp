@@ -0,0 +1,542 @@
+#include "pch.h"
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "DispatchEvent.h"
+#include "StandInSimConnect.h"
+
+namespace standin {
+
+	struct Connection {
+		std::string name;
+		HANDLE event{ nullptr };
+		bool open{ true };
+		std::mutex mutex;
+		std::deque<std::vector<uint8_t>> inbox;
+		std::vector<uint8_t> current;
+		DWORD lastSendId{ 0 };
+		uint64_t dropped{ 0 };
+	};
+
+	static std::mutex mutex;
+	static std::vector<std::unique_ptr<Connection>> connections;
+	static std::atomic<Connection*> last{ nullptr };
+	static std::atomic<int64_t> latencyMicros{ 0 };
+	static std::function<void(const Call&)> hook;
+	static bool logEnabled{ false };
+	static std::vector<std::string> callLog;
+	static std::vector<std::vector<uint8_t>> payloads;
+	static std::atomic<uint64_t> calls{ 0 };
+	static std::atomic<HRESULT> nextResult{ S_OK };
+	static std::atomic<size_t> inboxCapacity{ 0 };
+
+	static Connection* find(HANDLE handle)
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+
+		for (auto& conn : connections) {
+			if (conn.get() == handle) {
+				return conn.get();
+			}
+		}
+		return nullptr;
+	}
+
+	template <typename T>
+	static std::string text(const T& value)
+	{
+		if constexpr (std::is_convertible_v<T, const char*>) {
+			return (value != nullptr) ? std::string(value) : std::string("(null)");
+		}
+		else {
+			return std::format("{}", value);
+		}
+	}
+
+	/*
+	 * The common part of every outbound call: simulated cost, failure injection, bookkeeping.
+	 */
+	template <typename... Args>
+	static HRESULT record(const char* api, HANDLE handle, const Args&... args)
+	{
+		Connection* conn{ find(handle) };
+		if ((conn == nullptr) || !conn->open) {
+			return E_FAIL;
+		}
+		if (auto latency = latencyMicros.load(); latency > 0) {
+			auto until{ std::chrono::steady_clock::now() + std::chrono::microseconds(latency) };
+			while (std::chrono::steady_clock::now() < until) {
+			}
+		}
+		if (HRESULT hr = nextResult.exchange(S_OK); FAILED(hr)) {
+			return hr;
+		}
+		Call call{ api, handle, {}, std::chrono::steady_clock::now() };
+		[[maybe_unused]] size_t i{ 0 };
+		([&call, &i](const auto& arg) {
+			if constexpr (std::is_integral_v<std::decay_t<decltype(arg)>> || std::is_enum_v<std::decay_t<decltype(arg)>>) {
+				if (i < std::size(call.args)) {
+					call.args[i++] = uint32_t(arg);
+				}
+			}
+		}(args), ...);
+
+		std::function<void(const Call&)> callHook;
+		{
+			std::scoped_lock<std::mutex> lock(mutex);
+			if (logEnabled) {
+				std::string line{ api };
+				((line += " " + text(args)), ...);
+				callLog.push_back(std::move(line));
+			}
+			callHook = hook;
+		}
+		{
+			std::scoped_lock<std::mutex> lock(conn->mutex);
+			conn->lastSendId++;
+		}
+		calls++;
+		if (callHook) {
+			callHook(call);
+		}
+		return S_OK;
+	}
+
+	/*
+	 * Keep the payload of a successful call while the call log is enabled.
+	 */
+	static HRESULT keepPayload(HRESULT hr, const void* data, size_t size)
+	{
+		if (SUCCEEDED(hr) && (data != nullptr)) {
+			std::scoped_lock<std::mutex> lock(mutex);
+			if (logEnabled) {
+				auto bytes{ static_cast<const uint8_t*>(data) };
+				payloads.emplace_back(bytes, bytes + size);
+			}
+		}
+		return hr;
+	}
+
+	void reset()
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+
+		connections.clear();
+		last = nullptr;
+		latencyMicros = 0;
+		hook = nullptr;
+		logEnabled = false;
+		callLog.clear();
+		payloads.clear();
+		calls = 0;
+		nextResult = S_OK;
+		inboxCapacity = 0;
+	}
+
+	void setCallLatency(std::chrono::microseconds latency)
+	{
+		latencyMicros = latency.count();
+	}
+
+	void setCallHook(std::function<void(const Call&)> callHook)
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+		hook = std::move(callHook);
+	}
+
+	void enableCallLog(bool enabled)
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+		logEnabled = enabled;
+	}
+
+	std::vector<std::string> takeCallLog()
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+		return std::exchange(callLog, {});
+	}
+
+	std::vector<std::vector<uint8_t>> takePayloads()
+	{
+		std::scoped_lock<std::mutex> lock(mutex);
+		return std::exchange(payloads, {});
+	}
+
+	uint64_t callCount()
+	{
+		return calls;
+	}
+
+	void failNext(HRESULT hr)
+	{
+		nextResult = hr;
+	}
+
+	HANDLE lastHandle()
+	{
+		return last.load();
+	}
+
+	size_t pending(HANDLE handle)
+	{
+		Connection* conn{ find(handle) };
+		if (conn == nullptr) {
+			return 0;
+		}
+		std::scoped_lock<std::mutex> lock(conn->mutex);
+		return conn->inbox.size();
+	}
+
+	void setInboxCapacity(size_t capacity)
+	{
+		inboxCapacity = capacity;
+	}
+
+	uint64_t dropped(HANDLE handle)
+	{
+		Connection* conn{ find(handle) };
+		if (conn == nullptr) {
+			return 0;
+		}
+		std::scoped_lock<std::mutex> lock(conn->mutex);
+		return conn->dropped;
+	}
+
+	void push(HANDLE handle, const void* msg, size_t size)
+	{
+		Connection* conn{ find(handle) };
+		if (conn == nullptr) {
+			return;
+		}
+		{
+			std::scoped_lock<std::mutex> lock(conn->mutex);
+			if (const size_t capacity{ inboxCapacity }; (capacity > 0) && (conn->inbox.size() >= capacity)) {
+				conn->dropped++;
+				return;
+			}
+			auto bytes{ static_cast<const uint8_t*>(msg) };
+			conn->inbox.emplace_back(bytes, bytes + size);
+		}
+		if (conn->event != nullptr) {
+			nl::rakis::interop::DispatchEvent::signal(conn->event);
+		}
+	}
+
+	template <typename T>
+	static std::vector<uint8_t> message(SIMCONNECT_RECV_ID id, size_t size = sizeof(T))
+	{
+		std::vector<uint8_t> buf(std::max(size, sizeof(T)), 0);
+		auto msg{ reinterpret_cast<T*>(buf.data()) };
+		msg->dwSize = DWORD(buf.size());
+		msg->dwVersion = 1;
+		msg->dwID = id;
+		return buf;
+	}
+
+	void pushEvent(HANDLE handle, uint32_t groupId, uint32_t eventId, uint32_t data)
+	{
+		auto buf{ message<SIMCONNECT_RECV_EVENT>(SIMCONNECT_RECV_ID_EVENT) };
+		auto msg{ reinterpret_cast<SIMCONNECT_RECV_EVENT*>(buf.data()) };
+		msg->uGroupID = groupId;
+		msg->uEventID = eventId;
+		msg->dwData = data;
+		push(handle, buf.data(), buf.size());
+	}
+
+	void pushFrame(HANDLE handle, uint32_t eventId, float frameRate)
+	{
+		auto buf{ message<SIMCONNECT_RECV_EVENT_FRAME>(SIMCONNECT_RECV_ID_EVENT_FRAME) };
+		auto msg{ reinterpret_cast<SIMCONNECT_RECV_EVENT_FRAME*>(buf.data()) };
+		msg->uGroupID = DWORD(-1);
+		msg->uEventID = eventId;
+		msg->fFrameRate = frameRate;
+		msg->fSimSpeed = 1.0f;
+		push(handle, buf.data(), buf.size());
+	}
+
+	static void pushData(HANDLE handle, SIMCONNECT_RECV_ID id, uint32_t requestId, uint32_t defineId, uint32_t objectId, const void* data, size_t size)
+	{
+		const size_t header{ sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD) };	// dwData is where the data starts
+		auto buf{ message<SIMCONNECT_RECV_SIMOBJECT_DATA>(id, header + size) };
+		auto msg{ reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(buf.data()) };
+		msg->dwRequestID = requestId;
+		msg->dwObjectID = objectId;
+		msg->dwDefineID = defineId;
+		msg->dwentrynumber = 1;
+		msg->dwoutof = 1;
+		msg->dwDefineCount = 1;
+		std::memcpy(buf.data() + header, data, size);
+		push(handle, buf.data(), buf.size());
+	}
+
+	void pushSimObjectData(HANDLE handle, uint32_t requestId, uint32_t defineId, uint32_t objectId, const void* data, size_t size, bool byType)
+	{
+		pushData(handle, byType ? SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE : SIMCONNECT_RECV_ID_SIMOBJECT_DATA, requestId, defineId, objectId, data, size);
+	}
+
+	void pushClientData(HANDLE handle, uint32_t requestId, uint32_t defineId, const void* data, size_t size)
+	{
+		pushData(handle, SIMCONNECT_RECV_ID_CLIENT_DATA, requestId, defineId, 0, data, size);
+	}
+
+	void pushSystemState(HANDLE handle, uint32_t requestId, uint32_t value, float fValue, const char* text)
+	{
+		auto buf{ message<SIMCONNECT_RECV_SYSTEM_STATE>(SIMCONNECT_RECV_ID_SYSTEM_STATE) };
+		auto msg{ reinterpret_cast<SIMCONNECT_RECV_SYSTEM_STATE*>(buf.data()) };
+		msg->dwRequestID = requestId;
+		msg->dwInteger = value;
+		msg->fFloat = fValue;
+		if (text != nullptr) {
+			std::strncpy(msg->szString, text, sizeof(msg->szString) - 1);
+		}
+		push(handle, buf.data(), buf.size());
+	}
+
+	void pushException(HANDLE handle, uint32_t exception, uint32_t sendId, uint32_t index)
+	{
+		auto buf{ message<SIMCONNECT_RECV_EXCEPTION>(SIMCONNECT_RECV_ID_EXCEPTION) };
+		auto msg{ reinterpret_cast<SIMCONNECT_RECV_EXCEPTION*>(buf.data()) };
+		msg->dwException = exception;
+		msg->dwSendID = sendId;
+		msg->dwIndex = index;
+		push(handle, buf.data(), buf.size());
+	}
+
+}
+
+using standin::keepPayload;
+using standin::record;
+
+/*
+ * The SimConnect API, as far as the interop layer uses it.
+ */
+
+HRESULT SimConnect_Open(HANDLE* phSimConnect, LPCSTR szName, HWND hWnd, DWORD UserEventWin32, HANDLE hEventHandle, DWORD ConfigIndex)
+{
+	if (HRESULT hr = standin::nextResult.exchange(S_OK); FAILED(hr)) {
+		return hr;
+	}
+	auto conn{ std::make_unique<standin::Connection>() };
+	conn->name = (szName != nullptr) ? szName : "";
+	conn->event = hEventHandle;
+	{
+		std::scoped_lock<std::mutex> lock(standin::mutex);
+		standin::last = conn.get();
+		*phSimConnect = conn.get();
+		standin::connections.push_back(std::move(conn));
+	}
+	return record("Open", *phSimConnect, szName);
+}
+
+HRESULT SimConnect_Close(HANDLE hSimConnect)
+{
+	HRESULT hr = record("Close", hSimConnect);
+	if (auto conn = standin::find(hSimConnect); SUCCEEDED(hr) && (conn != nullptr)) {
+		conn->open = false;
+	}
+	return hr;
+}
+
+HRESULT SimConnect_GetNextDispatch(HANDLE hSimConnect, SIMCONNECT_RECV** ppData, DWORD* pcbData)
+{
+	auto conn{ standin::find(hSimConnect) };
+	if (conn == nullptr) {
+		return E_FAIL;
+	}
+	std::scoped_lock<std::mutex> lock(conn->mutex);
+	if (conn->inbox.empty()) {
+		return E_FAIL;
+	}
+	conn->current = std::move(conn->inbox.front());
+	conn->inbox.pop_front();
+	*ppData = reinterpret_cast<SIMCONNECT_RECV*>(conn->current.data());
+	*pcbData = DWORD(conn->current.size());
+	return S_OK;
+}
+
+HRESULT SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext)
+{
+	SIMCONNECT_RECV* pData;
+	DWORD cbData;
+	while (SUCCEEDED(SimConnect_GetNextDispatch(hSimConnect, &pData, &cbData))) {
+		pfcnDispatch(pData, cbData, pContext);
+	}
+	return S_OK;
+}
+
+HRESULT SimConnect_GetLastSentPacketID(HANDLE hSimConnect, DWORD* pdwError)
+{
+	auto conn{ standin::find(hSimConnect) };
+	if (conn == nullptr) {
+		return E_FAIL;
+	}
+	std::scoped_lock<std::mutex> lock(conn->mutex);
+	*pdwError = conn->lastSendId;
+	return S_OK;
+}
+
+HRESULT SimConnect_AddClientEventToNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_CLIENT_EVENT_ID EventID, BOOL bMaskable)
+{
+	return record("AddClientEventToNotificationGroup", hSimConnect, GroupID, EventID, bMaskable);
+}
+
+HRESULT SimConnect_MapClientEventToSimEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* EventName)
+{
+	return record("MapClientEventToSimEvent", hSimConnect, EventID, EventName);
+}
+
+HRESULT SimConnect_MapInputEventToClientEvent(HANDLE hSimConnect, SIMCONNECT_INPUT_GROUP_ID GroupID, const char* szInputDefinition, SIMCONNECT_CLIENT_EVENT_ID DownEventID, DWORD DownValue, SIMCONNECT_CLIENT_EVENT_ID UpEventID, DWORD UpValue, BOOL bMaskable)
+{
+	return record("MapInputEventToClientEvent", hSimConnect, GroupID, szInputDefinition, DownEventID, DownValue, UpEventID, UpValue, bMaskable);
+}
+
+HRESULT SimConnect_RemoveClientEvent(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_CLIENT_EVENT_ID EventID)
+{
+	return record("RemoveClientEvent", hSimConnect, GroupID, EventID);
+}
+
+HRESULT SimConnect_TransmitClientEvent(HANDLE hSimConnect, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_CLIENT_EVENT_ID EventID, DWORD dwData, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_EVENT_FLAG Flags)
+{
+	return record("TransmitClientEvent", hSimConnect, ObjectID, EventID, dwData, GroupID, Flags);
+}
+
+#if IS_PREPAR3D
+HRESULT SimConnect_TransmitClientEvent64(HANDLE hSimConnect, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_CLIENT_EVENT_ID EventID, QWORD qwData, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_EVENT_FLAG Flags)
+{
+	return record("TransmitClientEvent64", hSimConnect, ObjectID, EventID, qwData, GroupID, Flags);
+}
+#endif
+
+HRESULT SimConnect_AddToClientDataDefinition(HANDLE hSimConnect, SIMCONNECT_CLIENT_DATA_DEFINITION_ID DefineID, DWORD dwOffset, DWORD dwSizeOrType, float fEpsilon, DWORD DatumID)
+{
+	return record("AddToClientDataDefinition", hSimConnect, DefineID, dwOffset, int32_t(dwSizeOrType), fEpsilon, DatumID);
+}
+
+HRESULT SimConnect_CreateClientData(HANDLE hSimConnect, SIMCONNECT_CLIENT_DATA_ID ClientDataID, DWORD dwSize, SIMCONNECT_CREATE_CLIENT_DATA_FLAG Flags)
+{
+	return record("CreateClientData", hSimConnect, ClientDataID, dwSize, Flags);
+}
+
+HRESULT SimConnect_MapClientDataNameToID(HANDLE hSimConnect, const char* szClientDataName, SIMCONNECT_CLIENT_DATA_ID ClientDataID)
+{
+	return record("MapClientDataNameToID", hSimConnect, ClientDataID, szClientDataName);
+}
+
+HRESULT SimConnect_RequestClientData(HANDLE hSimConnect, SIMCONNECT_CLIENT_DATA_ID ClientDataID, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_CLIENT_DATA_DEFINITION_ID DefineID, SIMCONNECT_CLIENT_DATA_PERIOD Period, SIMCONNECT_CLIENT_DATA_REQUEST_FLAG Flags, DWORD origin, DWORD interval, DWORD limit)
+{
+	return record("RequestClientData", hSimConnect, ClientDataID, RequestID, DefineID, int(Period), Flags, origin, interval, limit);
+}
+
+HRESULT SimConnect_SetClientData(HANDLE hSimConnect, SIMCONNECT_CLIENT_DATA_ID ClientDataID, SIMCONNECT_CLIENT_DATA_DEFINITION_ID DefineID, SIMCONNECT_CLIENT_DATA_SET_FLAG Flags, DWORD dwReserved, DWORD cbUnitSize, void* pDataSet)
+{
+	return keepPayload(record("SetClientData", hSimConnect, ClientDataID, DefineID, Flags, cbUnitSize), pDataSet, cbUnitSize);
+}
+
+HRESULT SimConnect_ClearClientDataDefinition(HANDLE hSimConnect, SIMCONNECT_CLIENT_DATA_DEFINITION_ID DefineID)
+{
+	return record("ClearClientDataDefinition", hSimConnect, DefineID);
+}
+
+HRESULT SimConnect_ClearNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID)
+{
+	return record("ClearNotificationGroup", hSimConnect, GroupID);
+}
+
+HRESULT SimConnect_RequestNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, DWORD dwReserved, DWORD Flags)
+{
+	return record("RequestNotificationGroup", hSimConnect, GroupID);
+}
+
+HRESULT SimConnect_SetNotificationGroupPriority(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, DWORD uPriority)
+{
+	return record("SetNotificationGroupPriority", hSimConnect, GroupID, uPriority);
+}
+
+HRESULT SimConnect_SubscribeToSystemEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* SystemEventName)
+{
+	return record("SubscribeToSystemEvent", hSimConnect, EventID, SystemEventName);
+}
+
+HRESULT SimConnect_RequestSystemState(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, const char* szState)
+{
+	return record("RequestSystemState", hSimConnect, RequestID, szState);
+}
+
+HRESULT SimConnect_RequestDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_PERIOD Period, SIMCONNECT_DATA_REQUEST_FLAG Flags, DWORD origin, DWORD interval, DWORD limit)
+{
+	return record("RequestDataOnSimObject", hSimConnect, RequestID, DefineID, ObjectID, int(Period), Flags, origin, interval, limit);
+}
+
+HRESULT SimConnect_RequestDataOnSimObjectType(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_DATA_DEFINITION_ID DefineID, DWORD dwRadiusMeters, SIMCONNECT_SIMOBJECT_TYPE type)
+{
+	return record("RequestDataOnSimObjectType", hSimConnect, RequestID, DefineID, dwRadiusMeters, int(type));
+}
+
+HRESULT SimConnect_SetDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_SET_FLAG Flags, DWORD ArrayCount, DWORD cbUnitSize, void* pDataSet)
+{
+	return keepPayload(record("SetDataOnSimObject", hSimConnect, DefineID, ObjectID, Flags, ArrayCount, cbUnitSize), pDataSet, size_t(ArrayCount) * cbUnitSize);
+}
+
+HRESULT SimConnect_AddToDataDefinition(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, const char* DatumName, const char* UnitsName, SIMCONNECT_DATATYPE DatumType, float fEpsilon, DWORD DatumID)
+{
+	return record("AddToDataDefinition", hSimConnect, DefineID, int(DatumType), DatumID, DatumName, UnitsName, fEpsilon);
+}
+
+HRESULT SimConnect_ClearDataDefinition(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID)
+{
+	return record("ClearDataDefinition", hSimConnect, DefineID);
+}
+
+HRESULT SimConnect_AICreateEnrouteATCAircraft(HANDLE hSimConnect, const char* szContainerTitle, const char* szTailNumber, int iFlightNumber, const char* szFlightPlanPath, double dFlightPlanPosition, BOOL bTouchAndGo, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AICreateEnrouteATCAircraft", hSimConnect, RequestID, iFlightNumber, bTouchAndGo, szContainerTitle, szTailNumber, szFlightPlanPath, dFlightPlanPosition);
+}
+
+#if IS_PREPAR3D
+HRESULT SimConnect_AICreateEnrouteATCAircraftW(HANDLE hSimConnect, const wchar_t* szContainerTitle, const wchar_t* szTailNumber, int iFlightNumber, const wchar_t* szFlightPlanPath, double dFlightPlanPosition, BOOL bTouchAndGo, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AICreateEnrouteATCAircraftW", hSimConnect, RequestID, iFlightNumber, bTouchAndGo, dFlightPlanPosition);
+}
+#endif
+
+HRESULT SimConnect_AICreateNonATCAircraft(HANDLE hSimConnect, const char* szContainerTitle, const char* szTailNumber, SIMCONNECT_DATA_INITPOSITION InitPos, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AICreateNonATCAircraft", hSimConnect, RequestID, szContainerTitle, szTailNumber, InitPos.Latitude, InitPos.Longitude, InitPos.Altitude);
+}
+
+HRESULT SimConnect_AICreateParkedATCAircraft(HANDLE hSimConnect, const char* szContainerTitle, const char* szTailNumber, const char* szAirportID, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AICreateParkedATCAircraft", hSimConnect, RequestID, szContainerTitle, szTailNumber, szAirportID);
+}
+
+HRESULT SimConnect_AICreateSimulatedObject(HANDLE hSimConnect, const char* szContainerTitle, SIMCONNECT_DATA_INITPOSITION InitPos, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AICreateSimulatedObject", hSimConnect, RequestID, szContainerTitle, InitPos.Latitude, InitPos.Longitude, InitPos.Altitude);
+}
+
+HRESULT SimConnect_AIRemoveObject(HANDLE hSimConnect, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+	return record("AIRemoveObject", hSimConnect, ObjectID, RequestID);
+}
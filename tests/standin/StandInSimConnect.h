@@ -0,0 +1,88 @@
+#pragma once
+/*
+ * Copyright (c) 2026. Bert Laverman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "framework.h"
+#include <SimConnect.h>
+
+/*
+ * A stand-in for the SimConnect library, linked instead of the SDK's static library so the interop layer can be
+ * exercised without a simulator. Outbound calls are counted, optionally logged and delayed, and inbound messages
+ * are queued per handle by the test.
+ */
+namespace standin {
+
+	struct Call {
+		const char* api;
+		HANDLE handle;
+		uint32_t args[4];
+		std::chrono::steady_clock::time_point time;
+	};
+
+	void reset();
+
+	/*
+	 * Busy-wait this long in every outbound call, to simulate the cost of writing to the pipe.
+	 */
+	void setCallLatency(std::chrono::microseconds latency);
+
+	/*
+	 * Called (on the calling thread) for every outbound call, after the simulated latency.
+	 */
+	void setCallHook(std::function<void(const Call&)> hook);
+
+	void enableCallLog(bool enabled);
+	std::vector<std::string> takeCallLog();
+
+	/*
+	 * The payloads of the SetDataOnSimObject and SetClientData calls made while the call log was enabled, in order.
+	 */
+	std::vector<std::vector<uint8_t>> takePayloads();
+	uint64_t callCount();
+
+	/*
+	 * Make the next outbound call fail with the given result.
+	 */
+	void failNext(HRESULT hr);
+
+	HANDLE lastHandle();
+	size_t pending(HANDLE handle);
+
+	/*
+	 * Limit the number of queued messages per handle, as the simulator does when a client falls behind. Messages
+	 * pushed while the queue is full are dropped and counted. Zero means no limit.
+	 */
+	void setInboxCapacity(size_t capacity);
+	uint64_t dropped(HANDLE handle);
+
+	/*
+	 * Queue a message for the given handle, signalling the event passed to SimConnect_Open if there was one.
+	 */
+	void push(HANDLE handle, const void* msg, size_t size);
+
+	void pushEvent(HANDLE handle, uint32_t groupId, uint32_t eventId, uint32_t data);
+	void pushFrame(HANDLE handle, uint32_t eventId, float frameRate = 60.0f);
+	void pushSimObjectData(HANDLE handle, uint32_t requestId, uint32_t defineId, uint32_t objectId, const void* data, size_t size, bool byType = false);
+	void pushClientData(HANDLE handle, uint32_t requestId, uint32_t defineId, const void* data, size_t size);
+	void pushSystemState(HANDLE handle, uint32_t requestId, uint32_t value, float fValue, const char* text);
+	void pushException(HANDLE handle, uint32_t exception, uint32_t sendId, uint32_t index);
+
+}